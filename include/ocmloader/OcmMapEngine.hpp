@@ -26,6 +26,22 @@ struct Settings {
     std::string catalog_hrn;
     uint64_t catalog_version = 0;
     std::string cache_folder = "";
+
+    // 投机预取：返回瓦片后，在后台低优先级预热相邻瓦片
+    bool prefetch_neighbors = false;
+    // 预取结果在内存中保留的最大瓦片数
+    size_t prefetch_cache_size = 32;
+};
+
+/**
+ * @brief 预取提示：给出行进方向和速度时，预取前方瓦片而不是周围 8 个瓦片
+ */
+struct PrefetchHint {
+    // false 时本次请求不预取（调用方自己会加载全部瓦片，如 bbox 导出）
+    bool enabled = true;
+    bool has_heading = false;
+    double heading_deg = 0.0;   // 0 = 正北，顺时针
+    double speed_mps = 0.0;     // 米/秒
 };
 
 class OcmMapEngine {
@@ -47,6 +63,23 @@ public:
         const olp::geo::TileKey& tileKey,
         const datastore::TileRequest::Layers& layers);
 
+    /**
+     * @brief 同上，并在 prefetch_neighbors 打开时按 hint 调度后台预取
+     * @param hint 行进方向/速度提示，has_heading=false 时预取周围 8 个瓦片
+     */
+    datastore::Response<datastore::TileLoadResult> FetchTileAsync(
+        const olp::geo::TileKey& tileKey,
+        const datastore::TileRequest::Layers& layers,
+        const PrefetchHint& hint);
+
+    /**
+     * @brief 在后台线程预热 tileKey 周围（或前方）的瓦片，不阻塞调用方
+     */
+    void PrefetchAround(
+        const olp::geo::TileKey& tileKey,
+        const datastore::TileRequest::Layers& layers,
+        const PrefetchHint& hint = PrefetchHint());
+
 private:
     class OcmMapEngineImpl;
     std::shared_ptr<OcmMapEngineImpl> m_impl;
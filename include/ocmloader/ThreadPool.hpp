@@ -1,6 +1,8 @@
 #ifndef THREAD_POOL_HPP
 #define THREAD_POOL_HPP
 
+#include <algorithm>
+#include <exception>
 #include <memory>
 #include <vector>
 #include <thread>
@@ -61,6 +63,42 @@ private:
     bool stop;
 };
 
+/**
+ * @brief 把 [0, count) 按 chunk_size 切块交给线程池执行 fn(begin, end)，结果按块的顺序返回。
+ *        所有块结束后才返回；有块抛出异常时，等其余块结束后重新抛出第一个异常。
+ *        调用方不能是 pool 自己的工作线程（否则可能互相等待）
+ */
+template <typename Fn>
+auto RunChunked(ThreadPool& pool, size_t count, size_t chunk_size, Fn fn)
+    -> std::vector<typename std::result_of<Fn(size_t, size_t)>::type>
+{
+    using result_type = typename std::result_of<Fn(size_t, size_t)>::type;
+    if (chunk_size == 0) chunk_size = 1;
+
+    std::vector<std::future<result_type>> futures;
+    std::exception_ptr error;
+    try {
+        for (size_t begin = 0; begin < count; begin += chunk_size) {
+            const size_t end = std::min(count, begin + chunk_size);
+            futures.push_back(pool.enqueue([&fn, begin, end]() { return fn(begin, end); }));
+        }
+    } catch (...) {
+        error = std::current_exception();   // 已提交的块引用了 fn，仍要等它们结束
+    }
+
+    std::vector<result_type> results;
+    results.reserve(futures.size());
+    for (auto& f : futures) {
+        try {
+            results.push_back(f.get());
+        } catch (...) {
+            if (!error) error = std::current_exception();
+        }
+    }
+    if (error) std::rethrow_exception(error);
+    return results;
+}
+
 } // namespace ocm
 } // namespace maps
 } // namespace ning
@@ -2,17 +2,31 @@
 #define TILE_ID_CONVERTER_HPP
 
 #include <string>
+#include <cstddef>
 #include <cstdint>
 #include <stdexcept>
 
 /**
  * @brief 工具类：提供 Tile ID 与 Morton quadkey 的相互转换功能
+ *
+ * HERE Tile ID = 1 << (2 * level) | Morton(x, y)，Morton 码中 x 占偶数位、y 占奇数位，
+ * 与 quadkey 的每一位 (y_bit << 1 | x_bit) 相同。全部用整数位运算实现，
+ * 单个转换为 constexpr；批量接口在编译目标支持 BMI2 时用 pdep/pext（见 OCMLOADER_ENABLE_BMI2）。
  */
 class TileIDConverter {
 public:
+    // uint64 的 Tile ID 能表示的最大 level（1 + 2 * 31 = 63 位）
+    static constexpr uint32_t kMaxLevel = 31;
+
+    struct TileXY {
+        uint32_t x;
+        uint32_t y;
+        uint32_t level;
+    };
+
     /**
      * @brief 将 Tile(X, Y) 坐标转换为 Morton quadkey 字符串
-     * 
+     *
      * @param x Tile X 坐标（uint32_t，范围 [0, 2^level - 1]）
      * @param y Tile Y 坐标（uint32_t，范围 [0, 2^level - 1]）
      * @param level Tile 级别（uint32_t，≥1）
@@ -23,7 +37,7 @@ public:
 
     /**
      * @brief 将 Morton quadkey 字符串转换为 HERE Tile ID（十进制）
-     * 
+     *
      * @param quadkey Morton quadkey 字符串（仅包含 0-3 字符，以 "1" 开头）
      * @return uint64_t 转换后的 HERE Tile ID（十进制）
      * @throws std::invalid_argument 输入 quadkey 非法（格式错误或字符越界）
@@ -31,7 +45,86 @@ public:
      */
     static uint64_t QuadkeyToHereTileId(const std::string& quadkey);
 
-    static uint64_t XYtoTileId(uint32_t x, uint32_t y, uint32_t level);
+    /**
+     * @brief Tile(X, Y, level) -> HERE Tile ID，超出 level 范围的坐标高位被忽略
+     * @throws std::overflow_error level 大于 kMaxLevel
+     */
+    static constexpr uint64_t XYtoTileId(uint32_t x, uint32_t y, uint32_t level) {
+        return level > kMaxLevel
+            ? throw std::overflow_error("Tile level exceeds 31, tile id does not fit uint64_t")
+            : (uint64_t{1} << (2 * level)) | Interleave(x & LevelMask(level), y & LevelMask(level));
+    }
+
+    /**
+     * @brief HERE Tile ID -> Tile(X, Y, level)
+     * @throws std::invalid_argument tile_id 为 0 或最高位不在偶数位（不是合法的 Tile ID）
+     */
+    static constexpr TileXY TileIdToXY(uint64_t tile_id) {
+        return (tile_id >> (2 * TileIdLevel(tile_id))) != 1
+            ? throw std::invalid_argument("Invalid HERE tile id")
+            : TileXY{Compact(StripLevel(tile_id)), Compact(StripLevel(tile_id) >> 1), TileIdLevel(tile_id)};
+    }
+
+    /**
+     * @brief HERE Tile ID -> Morton quadkey 字符串（TileToQuadkey 的结果）
+     * @throws std::invalid_argument 不是合法的 Tile ID
+     */
+    static std::string TileIdToQuadkey(uint64_t tile_id);
+
+    /**
+     * @brief 批量转换，tile_ids 写入 count 个值
+     * @throws std::overflow_error 某个 level 大于 kMaxLevel
+     */
+    static void XYtoTileIds(const TileXY* tiles, size_t count, uint64_t* tile_ids);
+
+    /**
+     * @brief 批量逆转换，tiles 写入 count 个值
+     * @throws std::invalid_argument 某个 tile_id 不合法
+     */
+    static void TileIdsToXY(const uint64_t* tile_ids, size_t count, TileXY* tiles);
+
+    // x 的各位移到偶数位、y 的各位移到奇数位
+    static constexpr uint64_t Interleave(uint32_t x, uint32_t y) {
+        return Spread(x) | (Spread(y) << 1);
+    }
+
+    // 取偶数位合并为 32 位整数，Interleave 的逆运算（奇数位先右移一位）
+    static constexpr uint32_t Compact(uint64_t bits) {
+        bits &= 0x5555555555555555ull;
+        bits = (bits | (bits >> 1)) & 0x3333333333333333ull;
+        bits = (bits | (bits >> 2)) & 0x0F0F0F0F0F0F0F0Full;
+        bits = (bits | (bits >> 4)) & 0x00FF00FF00FF00FFull;
+        bits = (bits | (bits >> 8)) & 0x0000FFFF0000FFFFull;
+        bits = (bits | (bits >> 16)) & 0x00000000FFFFFFFFull;
+        return static_cast<uint32_t>(bits);
+    }
+
+private:
+    static constexpr uint64_t Spread(uint32_t v) {
+        uint64_t bits = v;
+        bits = (bits | (bits << 16)) & 0x0000FFFF0000FFFFull;
+        bits = (bits | (bits << 8)) & 0x00FF00FF00FF00FFull;
+        bits = (bits | (bits << 4)) & 0x0F0F0F0F0F0F0F0Full;
+        bits = (bits | (bits << 2)) & 0x3333333333333333ull;
+        bits = (bits | (bits << 1)) & 0x5555555555555555ull;
+        return bits;
+    }
+
+    static constexpr uint32_t LevelMask(uint32_t level) {
+        return level >= 32 ? 0xFFFFFFFFu : (1u << level) - 1;
+    }
+
+    // 去掉表示 level 的最高位，剩下 Morton 码
+    static constexpr uint64_t StripLevel(uint64_t tile_id) {
+        return tile_id & ~(uint64_t{1} << (2 * TileIdLevel(tile_id)));
+    }
+
+    // 最高位所在的两位组序号
+    static constexpr uint32_t TileIdLevel(uint64_t tile_id) {
+        uint32_t level = 0;
+        while (level < kMaxLevel && (tile_id >> (2 * level + 2)) != 0) ++level;
+        return level;
+    }
 };
 
-#endif // TILE_ID_CONVERTER_HPP
\ No newline at end of file
+#endif // TILE_ID_CONVERTER_HPP
@@ -0,0 +1,42 @@
+// TileScheduler.hpp
+#pragma once
+
+#include <string>
+#include <olp/clientmap/datastore/DataStoreClient.h>
+#include <olp/core/geo/coordinates/GeoCoordinates.h>
+
+namespace ning {
+namespace maps {
+namespace ocm {
+
+namespace datastore = olp::clientmap::datastore;
+
+/**
+ * @brief 瓦片调度顺序（对应命令行参数 order:）
+ */
+enum class TileOrder {
+    kDefault,    // 保持 GeoRectangleToTileKeys 返回的顺序
+    kMorton,     // 沿 Z-order(Morton) 曲线排序，提高磁盘缓存与输出的局部性
+    kCenterOut   // 离请求中心最近的瓦片优先，便于 Viewer 尽早拿到最相关的数据
+};
+
+/**
+ * @brief 解析 order: 参数值（"default" / "morton" / "center"）
+ * @throws std::invalid_argument 未知的调度顺序
+ */
+TileOrder ParseTileOrder(const std::string& name);
+
+/**
+ * @brief 按调度策略对待加载瓦片重新排序（原地排序，结果确定）
+ *
+ * @param tile_keys 待加载瓦片（同一 level）
+ * @param order 调度策略
+ * @param center 请求中心点（point 坐标或 bbox 中心），仅 kCenterOut 使用
+ */
+void ScheduleTileKeys(datastore::TileKeys& tile_keys,
+                      TileOrder order,
+                      const olp::geo::GeoCoordinates& center);
+
+} // namespace ocm
+} // namespace maps
+} // namespace ning
@@ -0,0 +1,184 @@
+#ifndef ATTRIBUTE_CACHE_HPP
+#define ATTRIBUTE_CACHE_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "GeoJsonWriter.hpp"
+#include "TileArena.hpp"
+
+namespace converter {
+
+/**
+ * @brief attributes 的输出方式（对应命令行参数 attributes:）
+ */
+enum class AttributeOutput {
+    kInline,      // 每个要素的 properties.attributes 中写出完整的对象（原有输出）
+    kDictionary   // 不同的对象只在文件级 attribute_dictionary 中写一次，要素中 attribute_refs 为其下标
+};
+
+/**
+ * @brief 解析 attributes: 参数值（"inline" / "dict"）
+ * @throws std::invalid_argument 未知的输出方式
+ */
+AttributeOutput ParseAttributeOutput(const std::string& name);
+
+/**
+ * 按 protobuf 序列化字节缓存 Attributes 的转换结果：同一瓦片中大量 segment 的 attributes 逐字节相同，
+ * 每种只转换一次，之后直接追加已序列化的 JSON（流式路径）或复制 DOM（convert() 路径）。
+ *
+ * 转换结果只取决于消息内容和本次运行的选项（fields: / enums: / valid_at:），所以可以用字节做键。
+ * 不加锁：每个转换线程（SegmentScratch）一份，随瓦片或分块一起释放。
+ *
+ * 流式路径的条目（哈希表节点、键和 JSON 片段）从构造时的 TileArena::Active() 分配，
+ * 不在 TileArena::Scope 内构造时使用自己的 arena。
+ */
+class AttributeCache {
+public:
+    AttributeCache()
+        : owned_(ning::maps::ocm::TileArena::Active() ? nullptr : new ning::maps::ocm::TileArena(16 * 1024)),
+          arena_(owned_ ? owned_.get() : ning::maps::ocm::TileArena::Active()),
+          entries_(0, BytesHash(), BytesEqual(), EntryAllocator(arena_)) {}
+
+    AttributeCache(const AttributeCache&) = delete;
+    AttributeCache& operator=(const AttributeCache&) = delete;
+
+    /**
+     * @brief 把 attr 作为数组元素写入 w
+     * @param write void(JsonWriter&, const Message&)，第一次遇到时直接写出 attr
+     */
+    template <typename Message, typename WriteFn>
+    void Write(JsonWriter& w, const Message& attr, WriteFn write) {
+        // 已序列化的片段带有缩进，写入位置的层级变化时（如 stitch: 的 properties）重新生成
+        if (w.depth() != depth_) {
+            entries_.clear();
+            depth_ = w.depth();
+        }
+        attr.SerializeToString(&key_);
+        auto it = entries_.find(Bytes{key_.data(), key_.size()});
+        if (it == entries_.end()) {
+            fragment_.Reset(w.indent(), depth_);
+            write(fragment_, attr);
+            it = entries_.emplace(Copy(key_), Copy(fragment_.buffer())).first;
+        }
+        w.RawValue(it->second.data, it->second.size);
+    }
+
+    /**
+     * @brief DOM 版本：返回 attr 转换后的 JSON（引用在缓存存在期间有效）
+     * @param convert nlohmann::json(const Message&)
+     */
+    template <typename Message, typename ConvertFn>
+    const nlohmann::json& Get(const Message& attr, ConvertFn convert) {
+        attr.SerializeToString(&key_);
+        auto it = values_.find(key_);
+        if (it == values_.end()) {
+            it = values_.emplace(key_, convert(attr)).first;
+        }
+        return it->second;
+    }
+
+    // 缓存中不同 attributes 的个数
+    size_t size() const { return entries_.size() + values_.size(); }
+
+private:
+    // arena 中的一段字节
+    struct Bytes {
+        const char* data;
+        size_t size;
+    };
+
+    struct BytesHash {
+        size_t operator()(const Bytes& b) const {
+            // FNV-1a
+            uint64_t h = 14695981039346656037ull;
+            for (size_t i = 0; i < b.size; ++i) {
+                h = (h ^ static_cast<unsigned char>(b.data[i])) * 1099511628211ull;
+            }
+            return static_cast<size_t>(h);
+        }
+    };
+
+    struct BytesEqual {
+        bool operator()(const Bytes& a, const Bytes& b) const {
+            return a.size == b.size && std::memcmp(a.data, b.data, a.size) == 0;
+        }
+    };
+
+    using EntryAllocator = ning::maps::ocm::ArenaAllocator<std::pair<const Bytes, Bytes>>;
+
+    Bytes Copy(const std::string& s) {
+        char* data = static_cast<char*>(arena_->Allocate(s.size(), 1));
+        if (!s.empty()) std::memcpy(data, s.data(), s.size());
+        return Bytes{data, s.size()};
+    }
+
+    std::unique_ptr<ning::maps::ocm::TileArena> owned_;
+    ning::maps::ocm::TileArena* arena_;
+    int depth_ = -1;
+    std::string key_;
+    JsonWriter fragment_;
+    std::unordered_map<Bytes, Bytes, BytesHash, BytesEqual, EntryAllocator> entries_;
+    std::unordered_map<std::string, nlohmann::json> values_;
+};
+
+/**
+ * attributes:dict 的文件级字典：整个输出文件中不同的 attributes 各占一项，按第一次出现的顺序编号。
+ * Close() 前用 Serialize() 的结果作为 FeatureCollection 的 attribute_dictionary 成员写出。
+ *
+ * 编号的分配顺序就是输出中的顺序，使用字典时瓦片内不分块并行转换（见 ConvertOptions::pool），
+ * 加锁只是为了在多个转换器之间共享时保持安全。
+ */
+class AttributeDictionary {
+public:
+    /**
+     * @param indent 与输出的 FeatureCollectionWriter 相同
+     */
+    explicit AttributeDictionary(int indent = 4) : indent_(indent) {}
+
+    AttributeDictionary(const AttributeDictionary&) = delete;
+    AttributeDictionary& operator=(const AttributeDictionary&) = delete;
+
+    /**
+     * @brief attr 在字典中的下标，第一次遇到时由 write（void(JsonWriter&, const Message&)）转换后加入
+     */
+    template <typename Message, typename WriteFn>
+    size_t Index(const Message& attr, WriteFn write) {
+        std::string key;
+        attr.SerializeToString(&key);
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = index_.find(key);
+        if (it != index_.end()) return it->second;
+
+        // attribute_dictionary 数组的元素在 FeatureCollection 中的层级为 2
+        JsonWriter entry(indent_, 2);
+        write(entry, attr);
+        entries_.push_back(std::move(entry.buffer()));
+        index_.emplace(std::move(key), entries_.size() - 1);
+        return entries_.size() - 1;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+    // 整个字典序列化为 JSON 数组，用于 FeatureCollectionWriter::AddMember
+    std::string Serialize() const;
+
+private:
+    int indent_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, size_t> index_;
+    std::vector<std::string> entries_;
+};
+
+} // namespace converter
+
+#endif // ATTRIBUTE_CACHE_HPP
@@ -0,0 +1,89 @@
+#ifndef ATTRIBUTE_TABLES_HPP
+#define ATTRIBUTE_TABLES_HPP
+
+#include "GeoJsonWriter.hpp"
+#include "NameTables.hpp"
+
+namespace converter {
+
+/**
+ * ISA / Road / Routing 转换器共用的 bitmask 和枚举名称表，第一次使用时构造，之后只读（可多线程共享）。
+ */
+const FlagNameTable& AccessFlagNames();
+const FlagNameTable& LocalRoadFlagNames();
+const FlagNameTable& RoadUsageFlagNames();
+const FlagNameTable& PhysicalFlagNames();
+const FlagNameTable& SpeedLimitRainingFlagNames();
+const FlagNameTable& ParkingSideFlagNames();
+
+const EnumNameTable& FunctionalClassNames();
+const EnumNameTable& RelativeDirectionNames();
+const EnumNameTable& SpeedCategoryNames();
+const EnumNameTable& IntersectionCategoryNames();
+const EnumNameTable& RoadDividerNames();
+const EnumNameTable& SpecialTrafficAreaCategoryNames();
+const EnumNameTable& SpecialSpeedTypeNames();
+const EnumNameTable& TollFeatureTypeNames();
+
+// attributes 及其子对象中的键，流式输出时各转换器共用
+namespace attribute_keys {
+
+extern const JsonKey kAccess;
+extern const JsonKey kAccessRestrictions;
+extern const JsonKey kAdministrativeRoadContextId;
+extern const JsonKey kAdministrativeRoutingContextId;
+extern const JsonKey kAppliesDuring;
+extern const JsonKey kAppliesDuringReadable;
+extern const JsonKey kAppliesTo;
+extern const JsonKey kBackwardAccessPermissions;
+extern const JsonKey kBackwardFreeFlowSpeed;
+extern const JsonKey kBackwardSpeedLimit;
+extern const JsonKey kBackwardSpeedLimitSource;
+extern const JsonKey kBackwardSpeedLimitUnlimited;
+extern const JsonKey kBackwardThroughLaneCount;
+extern const JsonKey kBackwardVariableSpeedLimit;
+extern const JsonKey kBuiltUpArea;
+extern const JsonKey kConstructionStatuses;
+extern const JsonKey kEnvironmentalZoneConditions;
+extern const JsonKey kEnvironmentalZoneId;
+extern const JsonKey kForwardAccessPermissions;
+extern const JsonKey kForwardFreeFlowSpeed;
+extern const JsonKey kForwardSpeedLimit;
+extern const JsonKey kForwardSpeedLimitSource;
+extern const JsonKey kForwardSpeedLimitUnlimited;
+extern const JsonKey kForwardThroughLaneCount;
+extern const JsonKey kForwardVariableSpeedLimit;
+extern const JsonKey kFunctionalClass;
+extern const JsonKey kHasPolygonalGeometry;
+extern const JsonKey kIntersectionCategory;
+extern const JsonKey kLocalRoad;
+extern const JsonKey kMinZoomLevel;
+extern const JsonKey kPhysical;
+extern const JsonKey kRelativeDirection;
+extern const JsonKey kRestArea;
+extern const JsonKey kRoadDivider;
+extern const JsonKey kRoadUsage;
+extern const JsonKey kSeasonalAppliesDuring;
+extern const JsonKey kShapePointIndex;
+extern const JsonKey kShapePointRatio;
+extern const JsonKey kSpecialSpeedLimit;
+extern const JsonKey kSpecialSpeedSituations;
+extern const JsonKey kSpecialSpeedType;
+extern const JsonKey kSpecialTrafficAreaCategory;
+extern const JsonKey kSpeedCategory;
+extern const JsonKey kStartOffset;
+extern const JsonKey kStateCode;
+extern const JsonKey kTollFeatureType;
+extern const JsonKey kTollSystemId;
+extern const JsonKey kTravelDirection;
+extern const JsonKey kTruckToll;
+extern const JsonKey kUnderConstruction;
+extern const JsonKey kUrban;
+extern const JsonKey kUsageFeeRequired;
+extern const JsonKey kZLevel;
+
+} // namespace attribute_keys
+
+} // namespace converter
+
+#endif // ATTRIBUTE_TABLES_HPP
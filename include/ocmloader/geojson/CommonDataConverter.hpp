@@ -6,13 +6,25 @@
 #include <google/protobuf/message.h>
 #include <string>
 #include <olp/clientmap/datastore/DataStoreClient.h>
+#include "ThreadPool.hpp"
  namespace datastore = olp::clientmap::datastore;
 namespace common_converter {
 
 class CommonDataConverter {
 public:
-    // 核心转换接口
+    /**
+     * 核心转换接口
+     * @param pool 非空时各图层在其中并行序列化（传入调用方已有的线程池，如 ConvertOptions::pool），
+     *             为空时在调用线程中依次序列化；不能在 pool 的工作线程中调用
+     */
     void convert(
+        const datastore::Response<olp::clientmap::datastore::TileLoadResult>& response,
+        const olp::geo::TileKey& tile_key,
+        const std::string& outPath,
+        ning::maps::ocm::ThreadPool* pool = nullptr);
+
+    // raw:pb：各图层的 protobuf 消息按原样序列化，加长度前缀写入一个文件（格式见 RawLayerPbWriter）
+    void convertToProtobuf(
         const datastore::Response<olp::clientmap::datastore::TileLoadResult>& response,
         const olp::geo::TileKey& tile_key,
         const std::string& outPath);
@@ -23,12 +35,6 @@ private:
 
     // 从LayerResponseType中提取protobuf消息
     const google::protobuf::Message* ExtractProtobufFromLayer(const datastore::TileLoadResult::LayerResponseType& layer_response);
-
-    // 将protobuf消息转换为JSON
-    nlohmann::json ProtobufToJson(const google::protobuf::Message& msg);
-
-    // 将合并后的JSON写入文件
-    bool WriteJsonToFile(const nlohmann::json& merged_json, const std::string& out_path);
 };
 
 } // namespace common_converter
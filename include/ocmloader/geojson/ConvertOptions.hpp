@@ -0,0 +1,61 @@
+#ifndef CONVERT_OPTIONS_HPP
+#define CONVERT_OPTIONS_HPP
+
+#include "AttributeCache.hpp"
+#include "FeatureFilter.hpp"
+#include "FieldMask.hpp"
+#include "GeometryEncoding.hpp"
+#include "LineSimplifier.hpp"
+#include "SegmentDedup.hpp"
+#include "SegmentStitcher.hpp"
+#include "SpatialClip.hpp"
+#include "TimeDomainParser.hpp"
+#include "ThreadPool.hpp"
+
+namespace converter {
+
+/**
+ * 各 GeoJSON 转换器共用的输出选项（由命令行参数构造，默认值保持原有输出）
+ */
+struct ConvertOptions {
+    // 下推到转换器的过滤条件：在构造 JSON 之前直接对 protobuf 字段求值，为空表示不过滤
+    const feature_filter::CompiledFilter* filter = nullptr;
+
+    // 字段投影，为空表示输出全部字段；未请求的字段既不计算也不序列化
+    const FieldMask* fields = nullptr;
+
+    // enums:raw 时枚举和 bitmask 输出为整数，而不是名称/名称数组
+    bool raw_enums = false;
+
+    // clip: 裁剪到请求区域（bbox 或 polygon），clip_area 为空时不裁剪
+    const utils::ClipArea* clip_area = nullptr;
+    utils::ClipMode clip_mode = utils::ClipMode::kNone;
+
+    // precision: 坐标保留的小数位数，-1 表示按 double 最短往返表示输出
+    int coordinate_precision = -1;
+
+    // geometry: 几何输出为 coordinates 数组，或 flexpolyline / delta64 编码字符串
+    utils::GeometryEncoding geometry_encoding = utils::GeometryEncoding::kGeoJson;
+
+    // simplify: 输出前按容差（米或目标显示级别）做 Douglas–Peucker 简化，默认不简化
+    utils::SimplifyTolerance simplify;
+
+    // valid_at: 只输出在该时刻生效的 TimedAccess / SpecialSpeedSituation / UsageFeeRequired 条目，为空表示不过滤
+    const TimeDomainParser::ValidityFilter* valid_at = nullptr;
+
+    // bbox 导出时跨瓦片的 foreign segment 去重，为空表示每个瓦片的 foreign segment 都输出；stitcher 非空时流式路径不使用
+    SegmentDedup* dedup = nullptr;
+
+    // stitch:on 时 segment 的各瓦片片段交给拼接器合并后再输出（只用于流式路径），为空表示逐瓦片输出
+    SegmentStitcher* stitcher = nullptr;
+
+    // attributes:dict 时流式输出的 attributes 写入文件级字典，要素中只输出下标；为空表示逐个要素输出完整对象
+    AttributeDictionary* attribute_dictionary = nullptr;
+
+    // 单个瓦片内按 segment 分块并行转换的线程池，为空时在调用线程中顺序转换；不能是调用线程所在的线程池；使用 attribute_dictionary 时不分块
+    ning::maps::ocm::ThreadPool* pool = nullptr;
+};
+
+} // namespace converter
+
+#endif // CONVERT_OPTIONS_HPP
@@ -0,0 +1,111 @@
+// CoordinateDecoder.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <olp/core/geo/tiling/TileKey.h>
+
+namespace utils {
+
+// precision: 支持的最大小数位数（1e-9 度约 0.1 mm，定点运算不会溢出 64 位）
+constexpr int kMaxCoordinatePrecision = 9;
+
+/**
+ * @brief 解析 precision: 参数值，空字符串返回 -1（按最短往返表示输出）
+ * @throws std::invalid_argument 不是 0..kMaxCoordinatePrecision 的整数
+ */
+int ParseCoordinatePrecision(const std::string& value);
+
+// 10^precision，precision 取 0..kMaxCoordinatePrecision
+uint64_t Pow10(int precision);
+
+/**
+ * @brief 世界坐标 -> 定点度数：round(world * 360 / 2^world_bits * 10^precision)，四舍五入，
+ *        全程整数运算（不含 -180 / -90 偏移）
+ */
+int64_t WorldToFixed(uint64_t world, uint32_t world_bits, int precision);
+
+// 定点度数 -> double（最接近该十进制数的 double），供 JSON DOM 路径使用；
+// nlohmann 的 Grisu2 偶尔会多输出几位，但解析回来与 JsonWriter::Fixed 的输出是同一个值
+inline double FixedToDouble(int64_t fixed, int precision) {
+    return static_cast<double>(fixed) / static_cast<double>(Pow10(precision));
+}
+
+/**
+ * @brief 瓦片内坐标（LineString.xy_coords）批量转换为经纬度
+ *
+ *   LNG = (Column << (world_bits - level) + x) * 360 / 2^world_bits - 180
+ *   LAT = (Row    << (world_bits - level) + y) * 360 / 2^world_bits - 90
+ *
+ * 瓦片原点和比例只在构造时计算一次；2^world_bits 用 ldexp 计算，world_bits 为 32 时也有定义。
+ * 结果与逐点计算逐位一致（乘以 2 的幂和不超过 2^53 的整数运算都是精确的）。
+ *
+ * 按编译目标选择实现：AVX2（需 -mavx2 或 /arch:AVX2，见 OCMLOADER_ENABLE_AVX2）、
+ * SSE2（x86_64 默认）、NEON（arm64），其他平台为标量实现。
+ */
+class CoordinateDecoder {
+public:
+    // level 取 tile_key.Level()
+    CoordinateDecoder(const olp::geo::TileKey& tile_key, uint32_t world_bits);
+
+    // 按指定 level 计算瓦片原点（rendering 图层固定按 14 级计算）
+    CoordinateDecoder(const olp::geo::TileKey& tile_key, uint32_t world_bits, uint32_t level);
+
+    /**
+     * @param xy 交替的 x, y，共 2 * count 个
+     * @param lng, lat 各写入 count 个值
+     */
+    void Decode(const uint32_t* xy, size_t count, double* lng, double* lat) const;
+
+    /**
+     * @brief 解码整条 LineString，lng/lat 的大小调整为点数（末尾多余的单个坐标忽略）
+     */
+    template <typename LineString>
+    void Decode(const LineString& line_string, std::vector<double>& lng, std::vector<double>& lat) const {
+        const size_t count = static_cast<size_t>(line_string.xy_coords_size()) / 2;
+        lng.resize(count);
+        lat.resize(count);
+        if (count > 0) {
+            Decode(line_string.xy_coords().data(), count, lng.data(), lat.data());
+        }
+    }
+
+    /**
+     * @brief 定点输出：lng/lat 为 round(度数 * 10^precision)，直接由整数世界坐标计算，
+     *        不经过 double，供 JsonWriter::Fixed 使用
+     */
+    void DecodeFixed(const uint32_t* xy, size_t count, int precision, int64_t* lng, int64_t* lat) const;
+
+    template <typename LineString>
+    void DecodeFixed(const LineString& line_string, int precision, std::vector<int64_t>& lng, std::vector<int64_t>& lat) const {
+        const size_t count = static_cast<size_t>(line_string.xy_coords_size()) / 2;
+        lng.resize(count);
+        lat.resize(count);
+        if (count > 0) {
+            DecodeFixed(line_string.xy_coords().data(), count, precision, lng.data(), lat.data());
+        }
+    }
+
+    // 单点，与 Decode 的结果一致
+    double Longitude(uint32_t x) const { return (origin_x_ + x) * scale_ - 180.0; }
+    double Latitude(uint32_t y) const { return (origin_y_ + y) * scale_ - 90.0; }
+
+    // 瓦片原点的整数世界坐标，编码几何（GeometryEncoding）时使用
+    uint64_t world_origin_x() const { return world_origin_x_; }
+    uint64_t world_origin_y() const { return world_origin_y_; }
+    uint32_t world_bits() const { return world_bits_; }
+
+    // 当前编译使用的实现："avx2" / "sse2" / "neon" / "scalar"
+    static const char* Backend();
+
+private:
+    uint64_t world_origin_x_ = 0;
+    uint64_t world_origin_y_ = 0;
+    uint32_t world_bits_ = 0;
+    double origin_x_ = 0.0;
+    double origin_y_ = 0.0;
+    double scale_ = 0.0;   // 360 / 2^world_bits
+};
+
+} // namespace utils
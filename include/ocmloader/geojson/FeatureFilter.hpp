@@ -0,0 +1,277 @@
+#ifndef FEATURE_FILTER_HPP
+#define FEATURE_FILTER_HPP
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace feature_filter {
+
+/**
+ * filter: 表达式只解析、编译一次，逐要素求值时不再读 JSON 形式的条件、
+ * 不做字符串拷贝和 std::stod，也不分配内存。
+ *
+ * 语法：
+ *   filter:AND(forward_speed_limit=30,functional_class=FUNCTIONAL_CLASS_1);OR(length>100,urban=true)
+ *   顶层用 ';' 分隔的各组之间为 AND 关系，AND(...) / OR(...) 可以任意嵌套。
+ */
+
+enum class CompareOp : uint8_t { kEq, kGt, kLt, kGe, kLe };
+
+struct Predicate {
+    std::string key;
+    CompareOp op = CompareOp::kEq;
+
+    // 常量预解析结果
+    bool is_number = false;
+    double number = 0.0;
+    std::string lowered;    // 小写后的字符串常量
+    int8_t boolean = -1;    // -1: 不是 true/false, 0: false, 1: true
+};
+
+// 单个值与谓词比较（供 JSON 和 protobuf 两种取值方式共用）
+bool MatchNumber(double value, const Predicate& p);
+bool MatchString(const char* value, size_t length, const Predicate& p);
+bool MatchBool(bool value, const Predicate& p);
+bool MatchJsonValue(const nlohmann::json& value, const Predicate& p);
+
+/**
+ * 过滤下推用的字段取值：转换器直接从 protobuf 读取，不构造 JSON。
+ * 取值类型与 nlohmann::json 的映射保持一致（bool 为布尔，其他算术类型和枚举为数字）。
+ */
+struct FieldValue {
+    enum class Kind : uint8_t { kNone, kNumber, kString, kBool };
+
+    Kind kind = Kind::kNone;
+    double number = 0.0;
+    bool boolean = false;
+    const std::string* str = nullptr;
+    std::string owned;   // 少数需要拼接的字符串字段才使用
+
+    static FieldValue None() { return FieldValue(); }
+
+    static FieldValue String(const std::string& s) {
+        FieldValue v;
+        v.kind = Kind::kString;
+        v.str = &s;
+        return v;
+    }
+
+    static FieldValue OwnedString(std::string s) {
+        FieldValue v;
+        v.kind = Kind::kString;
+        v.owned = std::move(s);
+        return v;
+    }
+
+    template <typename T>
+    static FieldValue Scalar(T value) {
+        static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "scalar field expected");
+        FieldValue v;
+        if (std::is_same<T, bool>::value) {
+            v.kind = Kind::kBool;
+            v.boolean = static_cast<bool>(value);
+        } else {
+            v.kind = Kind::kNumber;
+            v.number = static_cast<double>(value);
+        }
+        return v;
+    }
+};
+
+bool MatchFieldValue(const FieldValue& value, const Predicate& p);
+
+// protobuf 字段 -> FieldValue：字符串引用原字段，临时字符串转为 owned
+inline FieldValue ToFieldValue(const std::string& s) { return FieldValue::String(s); }
+inline FieldValue ToFieldValue(std::string&& s) { return FieldValue::OwnedString(std::move(s)); }
+
+template <typename T>
+typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value, FieldValue>::type
+ToFieldValue(T value) {
+    return FieldValue::Scalar(value);
+}
+
+// 字段名 -> 取值函数，Record 为转换器提供的记录类型（如 protobuf Attributes）
+// get_raw 用于 enums:raw 输出：枚举/bitmask 字段输出为整数时按整数求值，为空则与 get 相同
+template <typename Record>
+struct FieldGetter {
+    const char* name;
+    FieldValue (*get)(const Record&);
+    FieldValue (*get_raw)(const Record&) = nullptr;
+};
+
+template <typename Record>
+using BoundGetters = std::vector<FieldValue (*)(const Record&)>;
+
+/**
+ * @brief 把每个谓词的 key 绑定到 table 中的取值函数，找不到的为 nullptr
+ * @param raw 是否按 enums:raw 的整数输出取值
+ */
+template <typename Record, size_t N>
+BoundGetters<Record> BindFields(const std::vector<Predicate>& predicates,
+                                const FieldGetter<Record> (&table)[N],
+                                bool raw = false) {
+    BoundGetters<Record> getters(predicates.size(), nullptr);
+    for (size_t i = 0; i < predicates.size(); ++i) {
+        for (size_t j = 0; j < N; ++j) {
+            if (predicates[i].key == table[j].name) {
+                getters[i] = (raw && table[j].get_raw) ? table[j].get_raw : table[j].get;
+                break;
+            }
+        }
+    }
+    return getters;
+}
+
+class CompiledFilter {
+public:
+    CompiledFilter() = default;
+
+    /**
+     * @brief 解析并编译 filter 字符串，空字符串得到匹配所有要素的过滤器
+     * @throws std::runtime_error 表达式非法
+     */
+    static CompiledFilter Compile(const std::string& filter_str);
+
+    bool empty() const { return nodes_.empty(); }
+
+    const std::vector<Predicate>& predicates() const { return predicates_; }
+
+    /**
+     * @brief 对 GeoJSON feature 求值：条件 key 在 properties 或任一 attributes 元素中满足即为真
+     */
+    bool Match(const nlohmann::json& feature) const;
+
+    /**
+     * @brief 通用求值：matches(predicate, predicate_index) 判断单个条件是否满足
+     */
+    template <typename PredicateFn>
+    bool Evaluate(PredicateFn&& matches) const {
+        return nodes_.empty() || EvaluateNode(root_, matches);
+    }
+
+private:
+    enum class NodeKind : uint8_t { kAnd, kOr, kPredicate };
+
+    struct Node {
+        NodeKind kind;
+        uint32_t first;   // kAnd/kOr: children_ 中的起始下标；kPredicate: predicates_ 下标
+        uint32_t count;   // 子节点数量
+    };
+
+    template <typename PredicateFn>
+    bool EvaluateNode(uint32_t index, PredicateFn& matches) const {
+        const Node& node = nodes_[index];
+        switch (node.kind) {
+        case NodeKind::kPredicate:
+            return matches(predicates_[node.first], node.first);
+        case NodeKind::kAnd:
+            for (uint32_t i = 0; i < node.count; ++i) {
+                if (!EvaluateNode(children_[node.first + i], matches)) return false;
+            }
+            return true;
+        case NodeKind::kOr:
+            for (uint32_t i = 0; i < node.count; ++i) {
+                if (EvaluateNode(children_[node.first + i], matches)) return true;
+            }
+            return false;
+        }
+        return false;
+    }
+
+    uint32_t CompileExpression(const std::string& expr);
+    uint32_t AddGroup(NodeKind kind, const std::vector<uint32_t>& children);
+
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> children_;
+    std::vector<Predicate> predicates_;
+    uint32_t root_ = 0;
+};
+
+/**
+ * 过滤下推：转换器在构造 JSON 之前，用 protobuf 记录直接对 filter 求值。
+ *
+ * 语义与 CompiledFilter::Match 对 GeoJSON 输出求值一致——条件在 segment 级 properties
+ * 或任一 attribute 中满足即为真；输出中为数组/对象的字段（opaque_keys）永远不满足。
+ * 若 filter 引用了转换器无法直接求值的字段，下推不生效（active() == false），
+ * 由输出端的 CompiledFilter::Match 兜底。
+ */
+template <typename SegmentRecord, typename AttributeRecord>
+class FilterPushdown {
+public:
+    template <size_t N, size_t M>
+    FilterPushdown(const CompiledFilter* filter,
+                   const FieldGetter<SegmentRecord> (&segment_fields)[N],
+                   const FieldGetter<AttributeRecord> (&attribute_fields)[M],
+                   std::initializer_list<const char*> opaque_keys,
+                   bool raw_values = false)
+    {
+        if (!filter || filter->empty()) return;
+
+        segment_getters_ = BindFields(filter->predicates(), segment_fields, raw_values);
+        attribute_getters_ = BindFields(filter->predicates(), attribute_fields, raw_values);
+        for (size_t i = 0; i < filter->predicates().size(); ++i) {
+            if (segment_getters_[i] || attribute_getters_[i]) continue;
+            bool opaque = false;
+            for (const char* key : opaque_keys) {
+                if (filter->predicates()[i].key == key) {
+                    opaque = true;
+                    break;
+                }
+            }
+            if (!opaque) {
+                unresolved_key_ = filter->predicates()[i].key;
+                return;
+            }
+        }
+        filter_ = filter;
+    }
+
+    bool active() const { return filter_ != nullptr; }
+
+    // 无法下推时的第一个字段名（用于日志）
+    const std::string& unresolved_key() const { return unresolved_key_; }
+
+    /**
+     * @param segment segment 级记录
+     * @param attributes AttributeRecord 的集合（如 RepeatedPtrField），没有时传 nullptr
+     */
+    template <typename AttributeRange>
+    bool Matches(const SegmentRecord& segment, const AttributeRange* attributes) const {
+        if (!filter_) return true;
+        return filter_->Evaluate([&](const Predicate& p, uint32_t i) {
+            if (segment_getters_[i] && MatchFieldValue(segment_getters_[i](segment), p)) {
+                return true;
+            }
+            if (attributes && attribute_getters_[i]) {
+                for (const auto& attr : *attributes) {
+                    if (MatchFieldValue(attribute_getters_[i](attr), p)) return true;
+                }
+            }
+            return false;
+        });
+    }
+
+    // 没有 attributes 的 segment（如 foreign segment）
+    bool Matches(const SegmentRecord& segment) const {
+        return Matches(segment, static_cast<const NoAttributes*>(nullptr));
+    }
+
+private:
+    struct NoAttributes {
+        const AttributeRecord* begin() const { return nullptr; }
+        const AttributeRecord* end() const { return nullptr; }
+    };
+
+    const CompiledFilter* filter_ = nullptr;
+    BoundGetters<SegmentRecord> segment_getters_;
+    BoundGetters<AttributeRecord> attribute_getters_;
+    std::string unresolved_key_;
+};
+
+} // namespace feature_filter
+
+#endif // FEATURE_FILTER_HPP
@@ -0,0 +1,70 @@
+#ifndef FIELD_MASK_HPP
+#define FIELD_MASK_HPP
+
+#include <bitset>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace feature_filter {
+class CompiledFilter;
+}
+
+namespace converter {
+
+/**
+ * fields: 字段投影（逗号分隔的属性名），如 fields:local_id,functional_class,forward_speed_limit
+ *
+ * - 空掩码表示输出全部字段（保持原有行为）
+ * - 名称同时匹配 segment 级 properties 和 attributes 中的字段；写 attributes 表示保留全部 attribute 字段
+ * - 几何和 Feature 结构始终输出
+ */
+class FieldMask {
+public:
+    FieldMask() = default;
+
+    /**
+     * @brief 解析逗号分隔的字段列表，忽略空白和空项
+     */
+    static FieldMask Parse(const std::string& list);
+
+    bool empty() const { return names_.empty(); }
+
+    bool Contains(const std::string& name) const;
+
+    void Add(const std::string& name);
+
+    /**
+     * @brief 把 filter 引用的字段并入掩码，保证输出端过滤仍能取到条件字段
+     */
+    void AddFilterKeys(const feature_filter::CompiledFilter& filter);
+
+    /**
+     * @brief 按转换器的字段名表解析为位集（下标即转换器内的字段枚举值），每个瓦片解析一次
+     * @param names 字段名表
+     * @param group 组名（如 "attributes"），掩码包含组名时 [group_begin, N) 全部保留；为空则不使用
+     */
+    template <size_t N>
+    std::bitset<N> Resolve(const char* const (&names)[N],
+                           const char* group = nullptr,
+                           size_t group_begin = N) const
+    {
+        std::bitset<N> bits;
+        if (empty()) {
+            bits.set();
+            return bits;
+        }
+        const bool whole_group = group && Contains(group);
+        for (size_t i = 0; i < N; ++i) {
+            bits[i] = (whole_group && i >= group_begin) || Contains(names[i]);
+        }
+        return bits;
+    }
+
+private:
+    std::vector<std::string> names_;   // 有序，便于二分查找
+};
+
+} // namespace converter
+
+#endif // FIELD_MASK_HPP
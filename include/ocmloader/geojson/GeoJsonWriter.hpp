@@ -0,0 +1,249 @@
+#ifndef GEOJSON_WRITER_HPP
+#define GEOJSON_WRITER_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace converter {
+
+/**
+ * 预先转义、加好引号和冒号的键名。多个转换器共用的属性键只构造一次（见 AttributeTables.hpp），
+ * 写入时直接追加，不再逐字节检查转义。
+ */
+class JsonKey {
+public:
+    explicit JsonKey(const char* name);
+
+    const std::string& name() const { return name_; }
+
+    // Key() 处追加的片段："name": ，紧凑格式（indent < 0）时冒号后没有空格
+    const std::string& token(bool compact) const { return compact ? compact_ : pretty_; }
+
+private:
+    std::string name_;
+    std::string pretty_;
+    std::string compact_;
+};
+
+/**
+ * 流式 JSON 输出：按调用顺序直接写入可复用的缓冲区，不构造 nlohmann::json DOM。
+ *
+ * 输出与 nlohmann::json::dump(indent) 逐字节一致（数字格式、字符串转义、缩进和空容器写法），
+ * 但键按调用顺序输出——nlohmann::json 的对象按键名排序，所以调用方需要按字典序写键。
+ * indent < 0 时为紧凑格式，对应 dump()。
+ */
+class JsonWriter {
+public:
+    /**
+     * @param indent 缩进空格数，与 dump(indent) 相同
+     * @param base_level 起始缩进层级（写入外层容器中的元素时使用）
+     */
+    explicit JsonWriter(int indent = 4, int base_level = 0);
+
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+
+    void Key(const char* key) { Key(key, std::strlen(key)); }
+    void Key(const std::string& key) { Key(key.data(), key.size()); }
+    void Key(const char* key, size_t length);
+    void Key(const JsonKey& key);
+
+    void String(const char* value, size_t length);
+    void String(const std::string& value) { String(value.data(), value.size()); }
+    void Bool(bool value);
+    void Int(int64_t value);
+    void Uint(uint64_t value);
+    void Double(double value);
+
+    /**
+     * @brief 定点小数：scaled / 10^precision，去掉末尾的 0（至少保留一位小数，如 13.0），
+     *        只用整数运算，不分配内存。用于 precision: 指定位数的坐标输出
+     */
+    void Fixed(int64_t scaled, int precision);
+    void Null();
+
+    // 按 nlohmann::json 的类型映射分派：bool 为布尔，有符号整数和枚举为 integer，无符号为 unsigned，浮点为 float
+    void Value(bool value) { Bool(value); }
+    void Value(const std::string& value) { String(value); }
+    void Value(const char* value) { String(value, std::strlen(value)); }
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+    Value(T value) { Int(value); }
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value && !std::is_same<T, bool>::value>::type
+    Value(T value) { Uint(value); }
+
+    template <typename T>
+    typename std::enable_if<std::is_floating_point<T>::value>::type
+    Value(T value) { Double(static_cast<double>(value)); }
+
+    template <typename T>
+    typename std::enable_if<std::is_enum<T>::value>::type
+    Value(T value) { Int(static_cast<int64_t>(value)); }
+
+    // DOM 值（兜底路径），按当前层级缩进输出
+    void Value(const nlohmann::json& value);
+
+    template <typename T>
+    void Field(const char* key, const T& value) {
+        Key(key);
+        Value(value);
+    }
+
+    template <typename T>
+    void Field(const JsonKey& key, const T& value) {
+        Key(key);
+        Value(value);
+    }
+
+    // 字符串数组，如 protobuf 的 repeated string
+    template <typename Range>
+    void StringArray(const Range& values) {
+        BeginArray();
+        for (const auto& v : values) String(v);
+        EndArray();
+    }
+
+    // 原样追加（不做分隔和缩进处理）
+    void Raw(const char* data, size_t length) { out_.append(data, length); }
+
+    // 已序列化的值（如 SegmentStitcher 暂存的 properties），须按所在层级的缩进写成
+    void RawValue(const std::string& json) { RawValue(json.data(), json.size()); }
+    void RawValue(const char* json, size_t length) {
+        BeforeValue();
+        out_.append(json, length);
+    }
+
+    std::string& buffer() { return out_; }
+    const std::string& buffer() const { return out_; }
+
+    // 清空后按新的缩进和起始层级重新开始，保留缓冲区的容量
+    void Reset(int indent, int base_level);
+
+    // 转义并加引号的字符串字面量，用于预先生成 RawValue() 的片段（如 NameTables.hpp 中的名称）
+    static std::string Quote(const char* value, size_t length);
+    static std::string Quote(const std::string& value) { return Quote(value.data(), value.size()); }
+
+    int indent() const { return indent_; }
+
+    // 当前位置的缩进层级：在此写入的值可由 JsonWriter(indent(), depth()) 单独序列化后用 RawValue() 追加
+    int depth() const { return base_level_ + static_cast<int>(stack_.size()); }
+
+private:
+    struct Level {
+        bool empty;
+    };
+
+    void BeforeValue();
+    void NewLine(size_t depth);
+
+    int indent_;
+    int base_level_;
+    bool after_key_ = false;
+    std::vector<Level> stack_;
+    std::string out_;
+};
+
+/**
+ * 一段按顺序写好的要素，格式与 FeatureCollectionWriter 中的要素相同。
+ * 工作线程各自写入一个 FeatureChunk，再由 FeatureCollectionWriter::AppendChunk 按顺序拼接。
+ */
+class FeatureChunk {
+public:
+    explicit FeatureChunk(int indent = 4);
+
+    JsonWriter& BeginFeature();
+    void EndFeature() {}
+
+    size_t feature_count() const { return count_; }
+    const std::string& buffer() const { return writer_.buffer(); }
+
+private:
+    int indent_;
+    JsonWriter writer_;
+    size_t count_ = 0;
+};
+
+/**
+ * GeoJSON FeatureCollection 流式写入，输出与
+ *   {"type": "FeatureCollection", "features": [...]}.dump(indent)
+ * 逐字节一致（AddMember() 的成员除外）。要素先写入内存缓冲区，CommitTile() 时才写入文件，
+ * 转换某个瓦片失败时可以 RollbackTile() 丢弃该瓦片已写的要素。
+ */
+class FeatureCollectionWriter {
+public:
+    /**
+     * @throws std::runtime_error 文件无法打开
+     */
+    explicit FeatureCollectionWriter(const std::string& path, int indent = 4);
+    explicit FeatureCollectionWriter(std::ostream& out, int indent = 4);
+    ~FeatureCollectionWriter();
+
+    FeatureCollectionWriter(const FeatureCollectionWriter&) = delete;
+    FeatureCollectionWriter& operator=(const FeatureCollectionWriter&) = delete;
+
+    /**
+     * @brief 开始一个要素，返回的 writer 中应写入一个完整的 Feature 对象
+     */
+    JsonWriter& BeginFeature();
+    void EndFeature() {}
+
+    // DOM 要素（输出端过滤等兜底路径）
+    void AppendFeature(const nlohmann::json& feature);
+
+    // 追加 FeatureChunk 中的全部要素，chunk 须以相同的 indent 构造
+    void AppendChunk(const FeatureChunk& chunk);
+
+    int indent() const { return indent_; }
+
+    // 把缓冲的要素写入文件
+    void CommitTile();
+
+    // 丢弃上次 CommitTile() 之后写入的要素
+    void RollbackTile();
+
+    /**
+     * @brief Close() 时在 features 之后、type 之前写入的顶层成员（如 attribute_dictionary）
+     * @param value 已序列化的值，层级为 1（如 JsonWriter(indent(), 1) 的输出）
+     */
+    void AddMember(const std::string& key, const std::string& value);
+
+    /**
+     * @brief 写入结尾并关闭，析构时会自动调用
+     * @throws std::runtime_error 写文件失败
+     */
+    void Close();
+
+    size_t feature_count() const { return count_; }
+
+    // 已写入文件的字节数（不含未提交的缓冲）
+    uint64_t bytes_written() const { return bytes_written_; }
+
+private:
+    void Write(const std::string& data);
+
+    std::ofstream file_;
+    std::ostream* out_;
+    int indent_;
+    JsonWriter writer_;
+    size_t count_ = 0;
+    size_t committed_count_ = 0;
+    uint64_t bytes_written_ = 0;
+    bool closed_ = false;
+    std::vector<std::pair<std::string, std::string>> members_;
+};
+
+} // namespace converter
+
+#endif // GEOJSON_WRITER_HPP
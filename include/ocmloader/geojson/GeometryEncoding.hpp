@@ -0,0 +1,114 @@
+// GeometryEncoding.hpp
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "CoordinateDecoder.hpp"
+#include "GeoJsonWriter.hpp"
+#include "SpatialClip.hpp"
+
+namespace utils {
+
+/**
+ * @brief 几何输出格式（对应命令行参数 geometry:）
+ */
+enum class GeometryEncoding {
+    kGeoJson,        // 标准 GeoJSON coordinates 数组
+    kFlexPolyline,   // HERE Flexible Polyline 字符串（lat/lng 定点差分）
+    kDelta64         // 世界坐标差分 + zigzag varint，再做 base64
+};
+
+/**
+ * @brief 解析 geometry: 参数值（"geojson" / "flexpolyline" / "delta64"）
+ * @throws std::invalid_argument 未知的格式
+ */
+GeometryEncoding ParseGeometryEncoding(const std::string& name);
+
+const char* GeometryEncodingName(GeometryEncoding encoding);
+
+// flexpolyline 未指定 precision: 时的小数位数（1e-7 度约 1 cm，与 31 位世界坐标的分辨率相当）
+constexpr int kDefaultPolylinePrecision = 7;
+
+/**
+ * 编码几何：直接由整数世界坐标（瓦片原点 + xy_coords）生成，不经过 double。
+ *
+ * 输出的 geometry 对象为
+ *   {"encoded": "...", "encoding": "flexpolyline", "type": "LineString"}
+ *   {"bits": 24, "encoded": "...", "encoding": "delta64", "type": "LineString"}
+ * clip:cut 得到多段时 type 为 MultiLineString，encoded 为字符串数组。
+ *
+ * flexpolyline：按 https://github.com/heremaps/flexible-polyline 的格式，
+ *   头部为版本 1 和 precision，之后每点依次为 lat、lng 定点值的差分（zigzag + 5 位一组的 varint），
+ *   定点值与 precision: 的整数舍入相同（WorldToFixed）。
+ * delta64：每点依次为世界坐标 x、y 的差分（首点相对 0），zigzag 后按 LEB128 写入，整体做标准 base64；
+ *   解码端按 LNG = x * 360 / 2^bits - 180、LAT = y * 360 / 2^bits - 90 还原，bits 随 geometry 输出。
+ *
+ * 一个编码器在转换一个瓦片的各要素之间复用（内部缓冲区不重复分配）。
+ */
+class PolylineEncoder {
+public:
+    /**
+     * @param precision flexpolyline 的小数位数，< 0 时取 kDefaultPolylinePrecision；delta64 不使用
+     */
+    PolylineEncoder(GeometryEncoding encoding, uint32_t world_bits, int precision);
+
+    // geometry:geojson 时不生效，调用方按原有方式输出坐标
+    bool active() const { return encoding_ != GeometryEncoding::kGeoJson; }
+
+    GeometryEncoding encoding() const { return encoding_; }
+
+    // 开始一条新的折线
+    void Clear();
+
+    void Add(uint64_t world_x, uint64_t world_y);
+
+    /**
+     * @brief 追加 LineString 的各点（xy_coords 加上 decoder 的瓦片原点）
+     */
+    template <typename LineString>
+    void AddLine(const LineString& line_string, const CoordinateDecoder& decoder) {
+        const int num_coords = line_string.xy_coords_size();
+        for (int j = 0; j + 1 < num_coords; j += 2) {
+            Add(decoder.world_origin_x() + line_string.xy_coords(j),
+                decoder.world_origin_y() + line_string.xy_coords(j + 1));
+        }
+    }
+
+    // 交替的瓦片内 x, y（如 LineSimplifier 的结果），共 2 * count 个
+    void AddLine(const uint32_t* xy, size_t count, const CoordinateDecoder& decoder) {
+        for (size_t k = 0; k < count; ++k) {
+            Add(decoder.world_origin_x() + xy[2 * k], decoder.world_origin_y() + xy[2 * k + 1]);
+        }
+    }
+
+    // Clear() 之后追加的点的编码结果（引用在下次 Clear() 前有效）
+    const std::string& Finish();
+
+    /**
+     * @brief 当前折线（Clear() 之后追加的点）输出为 LineString geometry
+     */
+    nlohmann::json ToGeometry();
+    void WriteGeometry(converter::JsonWriter& w);
+
+    /**
+     * @brief clip:cut 的裁剪结果：一段为 LineString，多段为 MultiLineString
+     */
+    nlohmann::json ToGeometry(const std::vector<std::vector<WorldPoint>>& pieces);
+    void WriteGeometry(converter::JsonWriter& w, const std::vector<std::vector<WorldPoint>>& pieces);
+
+private:
+    void AddPiece(const std::vector<WorldPoint>& piece);
+
+    GeometryEncoding encoding_;
+    uint32_t world_bits_;
+    int precision_;
+    int64_t lng0_;   // 180 * 10^precision
+    int64_t lat0_;   // 90 * 10^precision
+    int64_t prev_x_ = 0;
+    int64_t prev_y_ = 0;
+    std::string out_;     // flexpolyline 字符；delta64 时为 Finish() 的 base64 结果
+    std::string bytes_;   // delta64 的 varint 字节
+};
+
+} // namespace utils
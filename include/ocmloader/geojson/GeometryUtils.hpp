@@ -1,13 +1,54 @@
 // GeometryUtils.h
 #pragma once
+#include <cstdint>
+#include <vector>
 #include <nlohmann/json.hpp>
 #include <olp/clientmap/datastore/DataStoreClient.h>
+#include "CoordinateDecoder.hpp"
+#include "GeoJsonWriter.hpp"
 
 namespace utils {
 
+using LineString = com::here::platform::schema::clientmap::v1::layers::common::LineString;
+
+// rendering 图层的几何固定按 14 级瓦片计算原点
+constexpr uint32_t kRenderingGeometryLevel = 14;
+
+// 坐标解码缓冲区，转换一个瓦片时在各要素之间复用
+struct CoordinateBuffer {
+    std::vector<double> lng;
+    std::vector<double> lat;
+    std::vector<int64_t> lng_fixed;
+    std::vector<int64_t> lat_fixed;
+};
+
+/**
+ * @brief 把 line_string 的各点以 [lng, lat] 追加到 coordinates 数组
+ * @param precision 小数位数，< 0 时保持 double 原值（最短往返表示）
+ */
+void AppendCoordinates(nlohmann::json& coordinates, const CoordinateDecoder& decoder,
+                       const LineString& line_string, int precision, CoordinateBuffer& buffer);
+
+/**
+ * @brief 流式版本：把各点以 [lng, lat] 写入当前打开的数组；
+ *        precision >= 0 时用 JsonWriter::Fixed 直接由整数坐标输出
+ */
+void WriteCoordinates(converter::JsonWriter& w, const CoordinateDecoder& decoder,
+                      const LineString& line_string, int precision, CoordinateBuffer& buffer);
+
+// 同上，坐标为交替的瓦片内 x, y（如 LineSimplifier 的结果），共 2 * count 个
+void AppendCoordinates(nlohmann::json& coordinates, const CoordinateDecoder& decoder,
+                       const uint32_t* xy, size_t count, int precision, CoordinateBuffer& buffer);
+void WriteCoordinates(converter::JsonWriter& w, const CoordinateDecoder& decoder,
+                      const uint32_t* xy, size_t count, int precision, CoordinateBuffer& buffer);
+
+/**
+ * @brief LineString 转为 GeoJSON geometry（坐标由 CoordinateDecoder 批量解码）
+ */
 nlohmann::json ExtractGeometry(
-    const com::here::platform::schema::clientmap::v1::layers::common::LineString& line_string,
+    const LineString& line_string,
     const olp::geo::TileKey& kTileKey,
-    uint32_t world_coordinate_bits);
+    uint32_t world_coordinate_bits,
+    int precision = -1);
 
-}
\ No newline at end of file
+}
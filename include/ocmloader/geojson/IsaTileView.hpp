@@ -0,0 +1,196 @@
+#ifndef ISA_TILE_VIEW_HPP
+#define ISA_TILE_VIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <olp/clientmap/datastore/DataStoreClient.h>
+#include "CoordinateDecoder.hpp"
+#include "GeometryUtils.hpp"
+#include "NodeIndex.hpp"
+
+namespace isa_converter {
+
+namespace datastore = olp::clientmap::datastore;
+
+// TileLoadResult 中 ISA 转换用到的各图层，找不到的为 nullptr
+struct IsaLayers {
+    const clientmap::decoder::IsaSegmentLayer* segments = nullptr;
+    const clientmap::decoder::IsaSegmentAttributeLayer* attributes = nullptr;
+    const clientmap::decoder::IsaSegmentGeometryLayer* geometries = nullptr;
+    const clientmap::decoder::IsaForeignSegmentGeometryLayer* foreign_geometries = nullptr;
+    const clientmap::decoder::IsaForeignSegmentLayer* foreign_segments = nullptr;
+    const clientmap::decoder::IsaNodeLayer* nodes = nullptr;
+    uint32_t world_bits = 24;
+};
+
+IsaLayers FindIsaLayers(const datastore::Response< datastore::TileLoadResult >& response);
+
+class IsaTileView;
+
+/**
+ * @brief IsaTileView 中的一个 segment：只保存 view 和下标，各字段在访问时直接从 protobuf 读取
+ *
+ * 顺序与 convert() 输出的 features 相同：先 foreign segment，再本瓦片的 segment。
+ */
+class SegmentRef {
+public:
+    using Attributes = clientmap::decoder::IsaSegmentAttributeLayer::Attributes;
+    using AttributeRange = google::protobuf::RepeatedPtrField<Attributes>;
+
+    // convert() 中的 tile_id：所在瓦片（不是 host 瓦片）的 ID
+    uint64_t tile_id() const;
+    uint64_t local_id() const;
+    uint64_t host_tile_id() const;
+    double length() const;
+
+    // 是否来自 IsaForeignSegmentLayer
+    bool foreign() const;
+
+    // 在 view 中的下标
+    size_t index() const { return index_; }
+
+    // 几何的各部分，坐标为未解码的整数世界坐标；缺少几何图层时为 0 个
+    size_t part_count() const;
+    const utils::LineString& part(size_t k) const;
+
+    /**
+     * @brief 解码全部 part 的坐标（度），依次拼接到 lng/lat 中，与 convert() 输出的 coordinates 相同
+     */
+    void Coordinates(std::vector<double>& lng, std::vector<double>& lat) const;
+
+    /**
+     * @brief 按 start_offset 排列的属性区间，枚举和 bitmask 为原始整数（名称见 AttributeTables.hpp）
+     * @return foreign segment 或缺少属性图层时为 nullptr
+     */
+    const AttributeRange* attributes() const;
+
+    /**
+     * @brief 与 convert() 的 is_segment_start 相同（有多个 part 时以最后找到的为准）
+     * @return 1 起点，0 终点，-1 没有找到（不输出该字段）
+     */
+    int8_t is_segment_start() const;
+
+private:
+    friend class IsaTileView;
+
+    SegmentRef(const IsaTileView* view, size_t index) : view_(view), index_(index) {}
+
+    const IsaTileView* view_;
+    size_t index_;
+};
+
+/**
+ * @brief ISA 瓦片的只读视图，供直接链接本库的程序按需读取 segment，不构造 JSON、不复制 protobuf
+ *
+ * 构造时只查找图层，之后每个字段在访问时读取；坐标只在调用 SegmentRef::Coordinates() 时解码，
+ * is_segment_start 的索引在第一次用到时构造（可多线程调用）。
+ * response 必须比 view 活得长，SegmentRef 也不能在 view 析构后使用。
+ *
+ * @code
+ *   isa_converter::IsaTileView view(response, tile_key);
+ *   for (const auto seg : view.segments()) {
+ *       if (seg.length() < 10) continue;
+ *       seg.Coordinates(lng, lat);
+ *   }
+ * @endcode
+ */
+class IsaTileView {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = SegmentRef;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = SegmentRef;
+
+        Iterator() = default;
+        Iterator(const IsaTileView* view, size_t index) : view_(view), index_(index) {}
+
+        SegmentRef operator*() const { return SegmentRef(view_, index_); }
+        SegmentRef operator[](difference_type n) const { return SegmentRef(view_, index_ + n); }
+
+        Iterator& operator++() { ++index_; return *this; }
+        Iterator operator++(int) { Iterator it = *this; ++index_; return it; }
+        Iterator& operator--() { --index_; return *this; }
+        Iterator operator--(int) { Iterator it = *this; --index_; return it; }
+        Iterator& operator+=(difference_type n) { index_ += n; return *this; }
+        Iterator& operator-=(difference_type n) { index_ -= n; return *this; }
+        Iterator operator+(difference_type n) const { return Iterator(view_, index_ + n); }
+        Iterator operator-(difference_type n) const { return Iterator(view_, index_ - n); }
+        difference_type operator-(const Iterator& other) const {
+            return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+        }
+
+        bool operator==(const Iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const Iterator& other) const { return index_ != other.index_; }
+        bool operator<(const Iterator& other) const { return index_ < other.index_; }
+        bool operator>(const Iterator& other) const { return index_ > other.index_; }
+        bool operator<=(const Iterator& other) const { return index_ <= other.index_; }
+        bool operator>=(const Iterator& other) const { return index_ >= other.index_; }
+
+    private:
+        const IsaTileView* view_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    // [begin, end) 内的 segment
+    class Range {
+    public:
+        Range(Iterator begin, Iterator end) : begin_(begin), end_(end) {}
+
+        Iterator begin() const { return begin_; }
+        Iterator end() const { return end_; }
+        size_t size() const { return static_cast<size_t>(end_ - begin_); }
+        bool empty() const { return begin_ == end_; }
+
+    private:
+        Iterator begin_;
+        Iterator end_;
+    };
+
+    IsaTileView(const datastore::Response< datastore::TileLoadResult >& response, const olp::geo::TileKey& tile_key);
+    IsaTileView(const IsaLayers& layers, const olp::geo::TileKey& tile_key);
+    ~IsaTileView();
+
+    IsaTileView(const IsaTileView&) = delete;
+    IsaTileView& operator=(const IsaTileView&) = delete;
+
+    // 全部 segment：先 foreign，再本瓦片
+    Range segments() const { return Range(Iterator(this, 0), Iterator(this, size())); }
+    Range foreign_segments() const { return Range(Iterator(this, 0), Iterator(this, num_foreign_)); }
+    Range own_segments() const { return Range(Iterator(this, num_foreign_), Iterator(this, size())); }
+
+    size_t size() const { return num_foreign_ + num_own_; }
+    bool empty() const { return size() == 0; }
+    SegmentRef operator[](size_t index) const { return SegmentRef(this, index); }
+
+    const olp::geo::TileKey& tile_key() const { return tile_key_; }
+    uint64_t tile_id() const { return tile_id_; }
+    uint32_t world_bits() const { return layers_.world_bits; }
+    const IsaLayers& layers() const { return layers_; }
+    const utils::CoordinateDecoder& decoder() const { return decoder_; }
+
+private:
+    friend class SegmentRef;
+
+    const utils::SegmentStartIndex* NodeIndex() const;
+
+    IsaLayers layers_;
+    olp::geo::TileKey tile_key_;
+    uint64_t tile_id_;
+    utils::CoordinateDecoder decoder_;
+    size_t num_foreign_;
+    size_t num_own_;
+
+    mutable std::once_flag node_index_once_;
+    mutable std::unique_ptr<utils::SegmentStartIndex> node_index_;
+};
+
+} // namespace isa_converter
+
+#endif // ISA_TILE_VIEW_HPP
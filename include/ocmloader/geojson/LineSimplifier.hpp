@@ -0,0 +1,86 @@
+// LineSimplifier.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <olp/core/geo/tiling/TileKey.h>
+#include "SpatialClip.hpp"
+
+namespace utils {
+
+/**
+ * @brief 几何简化的容差（对应命令行参数 simplify:）
+ */
+struct SimplifyTolerance {
+    double meters = 0.0;   // simplify:5 / simplify:5m，容差为 5 米
+    int zoom = -1;         // simplify:z10，容差为 10 级地图上一个像素对应的地面距离（随纬度变化）
+
+    bool active() const { return meters > 0.0 || zoom >= 0; }
+};
+
+/**
+ * @brief 解析 simplify: 参数值：米数（可带 m 后缀）或 z<显示级别>；空字符串、"none" 和 0 表示不简化
+ * @throws std::invalid_argument 格式错误、负数或级别超出 0..kMaxSimplifyZoom
+ */
+SimplifyTolerance ParseSimplifyTolerance(const std::string& value);
+
+constexpr int kMaxSimplifyZoom = 30;
+
+/**
+ * Douglas–Peucker 折线简化：直接在整数坐标（瓦片内 xy_coords 或世界坐标）上计算，不先转换为经纬度。
+ *
+ * 距离按瓦片中心纬度换算为米（x 方向乘以 cos(纬度)），取点到线段（而不是直线）的距离，
+ * 首尾点总是保留，所以 segment 端点和相邻 segment 的连接关系不变。
+ * 递归用显式栈代替；一个简化器在转换一个瓦片的各要素之间复用（内部缓冲区不重复分配）。
+ */
+class LineSimplifier {
+public:
+    /**
+     * @param tile_key 用于确定换算比例的瓦片（取其中心纬度）
+     */
+    LineSimplifier(const SimplifyTolerance& tolerance, const olp::geo::TileKey& tile_key, uint32_t world_bits);
+
+    // simplify: 未指定时不生效，调用方按原有方式输出
+    bool active() const { return tolerance_sq_ > 0.0; }
+
+    // 实际使用的容差（米）
+    double tolerance_meters() const;
+
+    /**
+     * @param xy 交替的 x, y，共 2 * count 个
+     * @return 简化后的交替 x, y（引用在下次调用前有效）
+     */
+    const std::vector<uint32_t>& Simplify(const uint32_t* xy, size_t count);
+
+    /**
+     * @brief LineString 的瓦片内坐标：生效时为简化后的结果，否则直接指向 xy_coords（末尾多余的单个坐标忽略）
+     * @return 交替 x, y 的首地址和点数
+     */
+    template <typename LineString>
+    std::pair<const uint32_t*, size_t> Points(const LineString& line_string) {
+        const uint32_t* xy = line_string.xy_coords().data();
+        const size_t count = static_cast<size_t>(line_string.xy_coords_size()) / 2;
+        if (!active()) return {xy, count};
+        const std::vector<uint32_t>& simplified = Simplify(xy, count);
+        return {simplified.data(), simplified.size() / 2};
+    }
+
+    // 原地简化世界坐标折线（clip:cut 的裁剪前使用）
+    void Simplify(std::vector<WorldPoint>& line);
+
+private:
+    // 标记要保留的点，point(i) 返回第 i 个点的整数坐标
+    template <typename Point>
+    void Mark(size_t count, Point point);
+
+    double scale_x_ = 0.0;        // 米 / 坐标单位
+    double scale_y_ = 0.0;
+    double tolerance_sq_ = 0.0;   // 容差的平方（米²），0 表示不简化
+    std::vector<uint8_t> keep_;
+    std::vector<std::pair<size_t, size_t>> stack_;
+    std::vector<uint32_t> out_;
+};
+
+} // namespace utils
@@ -0,0 +1,100 @@
+#ifndef NAME_TABLES_HPP
+#define NAME_TABLES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <google/protobuf/descriptor.h>
+#include <nlohmann/json.hpp>
+#include "GeoJsonWriter.hpp"
+
+namespace converter {
+
+// bitmask 位 -> 名称
+struct BitFlag {
+    uint32_t bit;
+    const char* name;
+};
+
+/**
+ * bitmask 的名称表：构造时为每一种置位组合预先生成输出（加好引号的名称、DOM 数组、拼接的字符串），
+ * 转换时按 mask 查表，不再逐位测试、构造和转义字符串。
+ *
+ * 输出与按表顺序逐位测试 flags 的写法相同：只列出表中的位，其它位只体现在 raw 中。
+ * 表中最多 kMaxFlags 个位，bit 为 0 的项（如 *_EMPTY）不会被列出，构造时忽略。
+ */
+class FlagNameTable {
+public:
+    static constexpr size_t kMaxFlags = 12;
+
+    template <size_t N>
+    explicit FlagNameTable(const BitFlag (&flags)[N]) : FlagNameTable(flags, N) {}
+
+    /**
+     * @throws std::invalid_argument 位数超过 kMaxFlags
+     */
+    FlagNameTable(const BitFlag* flags, size_t count);
+
+    // ["NAME", ...]
+    void Write(JsonWriter& w, uint32_t mask) const;
+
+    // {"active": [...], "is_empty": ..., "raw": ...}
+    void WriteObject(JsonWriter& w, uint32_t mask) const;
+
+    // DOM 版本，与 Write() / WriteObject() 的内容相同
+    const nlohmann::json& Json(uint32_t mask) const { return arrays_[Index(mask)]; }
+    nlohmann::json ObjectJson(uint32_t mask) const;
+
+    // 以 ", " 分隔的名称，没有置位时为空字符串
+    const std::string& Joined(uint32_t mask) const { return joined_[Index(mask)]; }
+
+private:
+    // mask 中表内的位压缩为连续的下标：第 i 位对应 flags 中的第 i 项
+    size_t Index(uint32_t mask) const {
+        if (direct_) return mask & all_bits_;
+        size_t index = 0;
+        for (size_t i = 0; i < bits_.size(); ++i) {
+            if (mask & bits_[i]) index |= size_t{1} << i;
+        }
+        return index;
+    }
+
+    std::vector<uint32_t> bits_;
+    std::vector<std::string> quoted_;       // 每个位的名称，已加引号
+    uint32_t all_bits_ = 0;
+    bool direct_ = true;                    // 第 i 项恰好是 1 << i，mask 可直接作下标
+    std::vector<nlohmann::json> arrays_;    // 按下标
+    std::vector<std::string> joined_;       // 按下标
+};
+
+/**
+ * protobuf 枚举的名称表：从 EnumDescriptor 预先生成每个值的名称和加好引号的 JSON 字符串，
+ * 取代逐次调用的 X_Name()（每次按值查找描述符并返回新的 std::string）。
+ *
+ * 与 X_Name() 相同：同一个值有多个名称时取第一个，未知的值为空字符串。
+ */
+class EnumNameTable {
+public:
+    explicit EnumNameTable(const google::protobuf::EnumDescriptor* descriptor);
+
+    const std::string& Name(int value) const;
+
+    // 作为字符串值写入，等价于 w.Value(Name(value))
+    void Write(JsonWriter& w, int value) const { w.RawValue(quoted_[Slot(value)]); }
+
+private:
+    size_t Slot(int value) const;
+
+    // 值的范围不大时按 value - min_ 直接寻址，否则用 sparse_；最后一项为未知值
+    int min_ = 0;
+    size_t dense_ = 0;
+    std::unordered_map<int, size_t> sparse_;
+    std::vector<std::string> names_;
+    std::vector<std::string> quoted_;
+};
+
+} // namespace converter
+
+#endif // NAME_TABLES_HPP
@@ -0,0 +1,64 @@
+// NodeIndex.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <olp/clientmap/datastore/DataStoreClient.h>
+#include "TileArena.hpp"
+
+namespace utils {
+
+using NodeLayer = com::here::platform::schema::clientmap::v1::layers::NodeLayer;
+
+/**
+ * @brief 瓦片内 node 与 segment 端点的扁平索引，用于计算 is_segment_start
+ *
+ * 构造时遍历一次 NodeLayer：各 node 的 connected_segments 解析为 (local_id, host_tile_id, is_segment_start)
+ * 连续存放，node 坐标写入开放寻址（线性探测）的表，槽中只记录该 node 在数组中的区间。
+ * 查找时探测一次坐标，再扫描该 node 的几个端点，不分配内存，也不再经 segment_index 间接访问。
+ * 同一坐标有多个 node 时以最后一个为准，与原来 unordered_map 的覆盖写入一致。
+ * 在 TileArena::Scope 内构造时，两张表从当前线程的 arena 分配。
+ */
+class SegmentStartIndex {
+public:
+    explicit SegmentStartIndex(const NodeLayer& layer);
+
+    // 表从指定的 arena 分配；arena 为 nullptr 时用 new/delete，不受当前线程的 Scope 影响
+    SegmentStartIndex(const NodeLayer& layer, ning::maps::ocm::TileArena* arena);
+
+    /**
+     * @brief 位于 (x, y) 的 node 上，segment (local_id, host_tile_id) 的端点是否为起点
+     * @return 1 起点，0 终点，-1 没有找到
+     */
+    int8_t Find(uint32_t x, uint32_t y, uint64_t local_id, uint64_t host_tile_id) const;
+
+    size_t node_count() const { return nodes_; }
+
+private:
+    static constexpr uint32_t kEmpty = 0xFFFFFFFFu;
+
+    struct Slot {
+        uint64_t coord;   // (x << 32) | y
+        uint32_t begin;   // ends_ 中的区间，begin 为 kEmpty 表示空槽
+        uint32_t end;
+    };
+
+    struct SegmentEnd {
+        uint64_t local_id;
+        uint64_t host_tile_id;
+        int8_t is_start;
+    };
+
+    size_t Probe(uint64_t coord) const;
+
+    template <typename T>
+    using ArenaVector = std::vector<T, ning::maps::ocm::ArenaAllocator<T>>;
+
+    ArenaVector<Slot> slots_;        // 容量为 2 的幂，装载率不超过 1/2
+    ArenaVector<SegmentEnd> ends_;
+    size_t mask_ = 0;
+    int shift_ = 64;   // 64 - log2(容量)
+    size_t nodes_ = 0;
+};
+
+} // namespace utils
@@ -0,0 +1,180 @@
+#ifndef RAW_LAYER_WRITER_HPP
+#define RAW_LAYER_WRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <google/protobuf/message.h>
+
+namespace common_converter {
+
+/**
+ * @brief 原始图层导出格式（对应命令行参数 raw:）
+ */
+enum class RawDumpFormat {
+    kNone,       // 不导出（默认）
+    kJson,       // protobuf 的 JSON 格式，合并为一个 FeatureCollection（RawLayerWriter）
+    kProtobuf    // protobuf 二进制，按图层加长度前缀（RawLayerPbWriter），可由 RawLayerPbReader 读回
+};
+
+/**
+ * @brief 解析 raw: 参数值（"none" / "json" / "pb"）
+ * @throws std::invalid_argument 未知的格式
+ */
+RawDumpFormat ParseRawDumpFormat(const std::string& name);
+
+// 导出文件的扩展名（".json" / ".pb"），kNone 时为空
+const char* RawDumpExtension(RawDumpFormat format);
+
+/**
+ * 原始图层导出：每个图层的 protobuf 直接序列化为 JSON 写入输出流，不经过 nlohmann::json 的解析和重新格式化。
+ *
+ * 输出结构与原来的合并 JSON 相同：{"features": [图层, ...], "layer_count", "tile_key", "type"}，
+ * 每个图层对象开头插入 layer_meta；图层内部为 protobuf 的 JSON 格式（字段按 proto 定义顺序）。
+ * 内存中只保留当前图层的 JSON 字符串，缓冲区在图层间复用。
+ */
+class RawLayerWriter {
+public:
+    /**
+     * @brief 写入文件；文件在第一个非空图层写入时才创建，没有图层时不生成文件
+     */
+    RawLayerWriter(const std::string& path, const std::string& tile_key, size_t layer_count);
+    RawLayerWriter(std::ostream& out, const std::string& tile_key, size_t layer_count);
+    ~RawLayerWriter();
+
+    RawLayerWriter(const RawLayerWriter&) = delete;
+    RawLayerWriter& operator=(const RawLayerWriter&) = delete;
+
+    /**
+     * @brief 写入一个图层
+     * @return 序列化失败或消息为空时跳过该图层并返回 false
+     * @throws std::runtime_error 文件无法打开或写入失败
+     */
+    bool WriteLayer(const google::protobuf::Message& msg, const std::string& layer_name, size_t layer_index);
+
+    /**
+     * @brief 把消息序列化为图层 JSON（不含 layer_meta），可在工作线程中并行调用
+     * @return 序列化失败或消息为空时返回 false
+     */
+    static bool Serialize(const google::protobuf::Message& msg, std::string& json);
+
+    /**
+     * @brief 写入 Serialize 得到的图层 JSON，调用方按 layer_index 顺序写入以保证输出确定
+     * @throws std::runtime_error 文件无法打开或写入失败
+     */
+    void WriteSerialized(const std::string& json, const std::string& layer_name, size_t layer_index);
+
+    /**
+     * @brief 写入结尾，析构时会自动调用
+     * @throws std::runtime_error 写入失败
+     */
+    void Close();
+
+    size_t layers_written() const { return layers_; }
+    uint64_t bytes_written() const { return bytes_written_; }
+
+private:
+    void Write(const char* data, size_t size);
+    void Write(const std::string& data) { Write(data.data(), data.size()); }
+
+    std::string path_;
+    std::ofstream file_;
+    std::ostream* out_ = nullptr;
+    std::string tile_key_;
+    size_t layer_count_;
+    size_t layers_ = 0;
+    uint64_t bytes_written_ = 0;
+    bool closed_ = false;
+    std::string buffer_;
+};
+
+/**
+ * raw:pb 的原始图层导出：每个图层的 protobuf 消息直接序列化为二进制写入，不做任何格式转换。
+ *
+ * 文件格式（字符串均为 varint 长度 + 字节）：
+ *   "OCMRAWPB" 8 字节魔数，varint 版本号（当前为 1），字符串 tile_key，
+ *   之后每个图层一条记录：varint layer_index，字符串 layer_name，字符串消息类型全名，字符串消息的序列化字节。
+ * 读回时按消息类型全名选择对应的 protobuf 类型 ParseFromString 即可。
+ */
+class RawLayerPbWriter {
+public:
+    /**
+     * @brief 写入文件；文件在第一个图层写入时才创建，没有图层时不生成文件
+     */
+    RawLayerPbWriter(const std::string& path, const std::string& tile_key);
+    RawLayerPbWriter(std::ostream& out, const std::string& tile_key);
+    ~RawLayerPbWriter();
+
+    RawLayerPbWriter(const RawLayerPbWriter&) = delete;
+    RawLayerPbWriter& operator=(const RawLayerPbWriter&) = delete;
+
+    /**
+     * @brief 写入一个图层
+     * @return 序列化失败时跳过该图层并返回 false
+     * @throws std::runtime_error 文件无法打开或写入失败
+     */
+    bool WriteLayer(const google::protobuf::Message& msg, const std::string& layer_name, size_t layer_index);
+
+    /**
+     * @brief 刷新输出，析构时会自动调用
+     * @throws std::runtime_error 写入失败
+     */
+    void Close();
+
+    size_t layers_written() const { return layers_; }
+    uint64_t bytes_written() const { return bytes_written_; }
+
+private:
+    void Write(const std::string& data);
+
+    std::string path_;
+    std::ofstream file_;
+    std::ostream* out_ = nullptr;
+    std::string tile_key_;
+    size_t layers_ = 0;
+    uint64_t bytes_written_ = 0;
+    bool closed_ = false;
+    std::string header_;
+    std::string payload_;
+};
+
+/**
+ * raw:pb 文件中的一个图层
+ */
+struct RawLayerRecord {
+    uint32_t layer_index = 0;
+    std::string layer_name;
+    std::string type_name;   // protobuf 消息类型全名
+    std::string payload;     // 消息的序列化字节
+};
+
+/**
+ * 按顺序读取 RawLayerPbWriter 写出的图层
+ */
+class RawLayerPbReader {
+public:
+    /**
+     * @throws std::runtime_error 不是 raw:pb 文件或版本不支持
+     */
+    explicit RawLayerPbReader(std::istream& in);
+
+    const std::string& tile_key() const { return tile_key_; }
+
+    /**
+     * @brief 读取下一个图层
+     * @return 已到文件末尾时返回 false
+     * @throws std::runtime_error 文件被截断或格式错误
+     */
+    bool Next(RawLayerRecord& record);
+
+private:
+    std::istream& in_;
+    std::string tile_key_;
+};
+
+} // namespace common_converter
+
+#endif // RAW_LAYER_WRITER_HPP
@@ -12,6 +12,8 @@
 #include <olp/clientmap/datastore/DataStoreClient.h>
 
 #include <OcmMapEngine.hpp>
+#include "ConvertOptions.hpp"
+#include "GeoJsonWriter.hpp"
 
 using json = nlohmann::json;
 
@@ -29,8 +31,17 @@ public:
 
     /**
      * 从 FetchTileResult 中提取各层然后调用 convertInternal
+     * options.filter 不为空时下推过滤，只有满足条件的 segment 才会构造 JSON
      */
-    json convert(const datastore::Response< datastore::TileLoadResult >& response, const olp::geo::TileKey &tile_key, const std::string& outPath);
+    json convert(const datastore::Response< datastore::TileLoadResult >& response, const olp::geo::TileKey &tile_key, const std::string& outPath,
+                 const converter::ConvertOptions& options = converter::ConvertOptions());
+
+    /**
+     * 与 convert() 输出相同的要素，但直接从 protobuf 写入 out，不构造 JSON DOM
+     * @return false 表示 filter 无法下推，未写入任何要素，调用方应改用 convert() 并在输出端过滤
+     */
+    bool stream(const datastore::Response< datastore::TileLoadResult >& response, const olp::geo::TileKey &tile_key,
+                const converter::ConvertOptions& options, converter::FeatureCollectionWriter& out);
 
 private:
   
@@ -10,6 +10,7 @@
 
 #include <olp/clientmap/datastore/DataStoreClient.h>
 #include <OcmMapEngine.hpp>
+#include "GeoJsonWriter.hpp"
 
 using json = nlohmann::json;
 
@@ -27,6 +28,12 @@ public:
 
     json convert(const datastore::Response< datastore::TileLoadResult >& response, const olp::geo::TileKey &tile_key, const std::string& outPath);
 
+    /**
+     * 与 convert() 输出相同的要素，直接写入 out，不构造 JSON DOM
+     */
+    bool stream(const datastore::Response< datastore::TileLoadResult >& response, const olp::geo::TileKey &tile_key,
+                converter::FeatureCollectionWriter& out);
+
 private:
 
 
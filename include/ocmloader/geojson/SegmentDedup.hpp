@@ -0,0 +1,114 @@
+#ifndef SEGMENT_DEDUP_HPP
+#define SEGMENT_DEDUP_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "GeoJsonWriter.hpp"
+
+namespace converter {
+
+/**
+ * bbox 导出的跨瓦片去重：跨越瓦片边界的 segment 会作为 foreign segment 出现在相邻瓦片中，
+ * 以 (host_tile_id, local_id) 识别同一条 segment，每条只输出一次。
+ *
+ * host 瓦片不在导出范围内时，输出第一个遇到的 foreign 副本。
+ * host 瓦片在导出范围内时 segment 应由 host 瓦片输出（带 attributes）：host 已提交则跳过副本，
+ * 否则把第一个副本序列化后暂存（Defer），host 提交时丢弃；host 加载失败、被回滚或导出提前结束时，
+ * Close() 写出暂存的副本，segment 不会从输出中消失。
+ *
+ * 瓦片内的判断先暂存，CommitTile() 时才生效，RollbackTile() 丢弃：被回滚的瓦片不会占用键。
+ * 一个瓦片转换期间 CheckForeign() / Defer() 可由转换线程并发调用（按键分片加锁），
+ * CommitTile() / RollbackTile() / Close() 在瓦片之间由写出线程调用。
+ */
+class SegmentDedup {
+public:
+    enum class ForeignCopy {
+        kWrite,   // 输出
+        kSkip,    // 已由其它瓦片输出（或暂存），跳过
+        kDefer,   // host 瓦片尚未提交：写入 NewChunk() 后交给 Defer()
+    };
+
+    /**
+     * @param tile_ids 本次导出的全部瓦片（HERE Tile ID）
+     * @param indent 与输出的 FeatureCollectionWriter 相同
+     */
+    explicit SegmentDedup(const std::vector<uint64_t>& tile_ids, int indent = 4);
+
+    SegmentDedup(const SegmentDedup&) = delete;
+    SegmentDedup& operator=(const SegmentDedup&) = delete;
+
+    /**
+     * @brief 当前瓦片中的 foreign segment 如何处理，同一个键在提交或回滚前只会得到一次 kWrite / kDefer
+     */
+    ForeignCopy CheckForeign(uint64_t host_tile_id, uint64_t local_id);
+
+    // 暂存副本用的 chunk，格式与输出文件中的要素一致
+    FeatureChunk NewChunk() const { return FeatureChunk(indent_); }
+
+    // 暂存 kDefer 的副本（chunk 中至多一个要素，空 chunk 忽略），线程安全
+    void Defer(uint64_t host_tile_id, uint64_t local_id, FeatureChunk&& chunk);
+
+    // 当前瓦片已写入输出：暂存的判断生效，该瓦片作为 host 的暂存副本不再需要
+    void CommitTile(uint64_t tile_id);
+
+    // 丢弃当前瓦片的判断和暂存副本（瓦片转换失败时）
+    void RollbackTile();
+
+    // 写出 host 瓦片始终没有提交的暂存副本，之后由调用方 CommitTile()
+    void Close(FeatureCollectionWriter& out);
+
+    // 已跳过的 foreign segment 副本数
+    size_t skipped() const { return skipped_.load(std::memory_order_relaxed); }
+
+    // Close() 中补写的副本数
+    size_t recovered() const { return recovered_; }
+
+private:
+    struct Key {
+        uint64_t host_tile_id;
+        uint64_t local_id;
+
+        bool operator==(const Key& other) const {
+            return host_tile_id == other.host_tile_id && local_id == other.local_id;
+        }
+        bool operator<(const Key& other) const {
+            return host_tile_id != other.host_tile_id ? host_tile_id < other.host_tile_id : local_id < other.local_id;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    static constexpr size_t kShardBits = 4;
+    static constexpr size_t kShards = size_t{1} << kShardBits;
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_set<Key, KeyHash> keys;     // 已提交的瓦片中输出或暂存过的
+        std::unordered_set<Key, KeyHash> staged;   // 当前瓦片
+    };
+
+    int indent_;
+    std::unordered_set<uint64_t> tiles_;       // 构造后只读
+    std::unordered_set<uint64_t> committed_;   // 只在瓦片之间修改
+    std::array<Shard, kShards> shards_;
+
+    std::mutex deferred_mutex_;
+    std::vector<std::pair<Key, FeatureChunk>> staged_deferred_;   // 当前瓦片
+    std::map<Key, FeatureChunk> deferred_;                        // 按键排序，Close() 的输出顺序确定
+
+    std::atomic<size_t> skipped_{0};
+    size_t recovered_ = 0;
+};
+
+} // namespace converter
+
+#endif // SEGMENT_DEDUP_HPP
@@ -0,0 +1,23 @@
+#ifndef SEGMENT_KEY_HASH_HPP
+#define SEGMENT_KEY_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace converter {
+
+/**
+ * @brief segment 的跨瓦片标识 (host_tile_id, local_id) 的哈希，SegmentDedup 和 SegmentStitcher 共用
+ *
+ * splitmix64 的混合步骤：local_id 多为小整数，直接异或时分布很差。高位同样均匀，可用于分片。
+ */
+inline size_t HashSegmentKey(uint64_t host_tile_id, uint64_t local_id) {
+    uint64_t h = host_tile_id * 0x9E3779B97F4A7C15ull ^ local_id;
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+    return static_cast<size_t>(h ^ (h >> 31));
+}
+
+} // namespace converter
+
+#endif // SEGMENT_KEY_HASH_HPP
@@ -0,0 +1,163 @@
+#ifndef SEGMENT_STITCHER_HPP
+#define SEGMENT_STITCHER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <olp/core/geo/tiling/TileKey.h>
+#include "GeoJsonWriter.hpp"
+#include "GeometryEncoding.hpp"
+#include "SpatialClip.hpp"
+
+namespace converter {
+
+/**
+ * bbox 导出的跨瓦片拼接（stitch:on）：同一条 segment（host_tile_id, local_id）在各瓦片中的几何片段，
+ * 按端点相接合并为一条连续的 LineString，只输出一个要素。
+ *
+ * 片段端点按量化后的世界坐标建哈希索引（容差 kSnapUnits），首尾相接的片段依次合并，
+ * 首尾都重合的片段视为重复副本（如 foreign segment 的完整拷贝）直接丢弃。
+ * 合并结果的 properties 取 host 瓦片中的片段（带 attributes），没有时取 tile_id 最小的片段。
+ *
+ * 按瓦片流式处理：某条折线的两个端点都不在尚未处理的瓦片边界上（host 瓦片也已处理）时，
+ * 它不会再有新的片段，立即写出并释放。瓦片按 Morton 顺序处理时，内存中只保留处理前沿上的折线。
+ *
+ * Add() 可由转换线程并发调用（片段先暂存），FinishTile() 在写出线程中按确定的顺序合并和输出。
+ */
+class SegmentStitcher {
+public:
+    // 一条 segment 在一个瓦片中的几何片段
+    struct Fragment {
+        uint64_t host_tile_id = 0;
+        uint64_t local_id = 0;
+        uint64_t tile_id = 0;                  // 片段所在瓦片
+        uint32_t world_bits = 0;
+        std::vector<utils::WorldPoint> points;
+        std::string properties;                // 已序列化的 properties 对象，见 PropertiesWriter()
+    };
+
+    /**
+     * @param tiles 本次导出的全部瓦片（同一 level）
+     * @param precision、encoding 与 ConvertOptions 相同，决定输出几何的格式
+     * @param indent 与输出的 FeatureCollectionWriter 相同
+     */
+    SegmentStitcher(const std::vector<olp::geo::TileKey>& tiles, int precision,
+                    utils::GeometryEncoding encoding, int indent = 4);
+
+    SegmentStitcher(const SegmentStitcher&) = delete;
+    SegmentStitcher& operator=(const SegmentStitcher&) = delete;
+
+    // 写 Fragment::properties 用的 writer，缩进与要素中 properties 的位置一致
+    JsonWriter PropertiesWriter() const { return JsonWriter(indent_, 3); }
+
+    // 暂存当前瓦片的一个片段，线程安全
+    void Add(Fragment&& fragment);
+
+    // 丢弃当前瓦片暂存的片段（瓦片转换失败时），之后仍需调用 FinishTile()
+    void DiscardTile();
+
+    /**
+     * @brief 当前瓦片转换完成：合并暂存的片段，写出所有不会再变化的折线
+     */
+    void FinishTile(const olp::geo::TileKey& tile, FeatureCollectionWriter& out);
+
+    // 写出剩余的全部折线（导出提前结束时也要调用）
+    void Close(FeatureCollectionWriter& out);
+
+    size_t fragments() const { return fragments_; }
+    size_t features_written() const { return features_written_; }
+    size_t duplicates() const { return duplicates_; }
+
+    // 端点匹配的容差（世界坐标单位）
+    static constexpr int kSnapBits = 2;
+    static constexpr int64_t kSnapUnits = int64_t{1} << kSnapBits;
+
+private:
+    struct SegmentKey {
+        uint64_t host_tile_id;
+        uint64_t local_id;
+
+        bool operator==(const SegmentKey& other) const {
+            return host_tile_id == other.host_tile_id && local_id == other.local_id;
+        }
+        bool operator<(const SegmentKey& other) const {
+            return host_tile_id != other.host_tile_id ? host_tile_id < other.host_tile_id : local_id < other.local_id;
+        }
+    };
+
+    // 同一 segment 的量化端点
+    struct EndpointKey {
+        SegmentKey segment;
+        int64_t qx;
+        int64_t qy;
+
+        bool operator==(const EndpointKey& other) const {
+            return segment == other.segment && qx == other.qx && qy == other.qy;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const SegmentKey& key) const;
+        size_t operator()(const EndpointKey& key) const;
+    };
+
+    struct Chain {
+        SegmentKey key;
+        uint32_t world_bits = 0;
+        std::vector<utils::WorldPoint> points;
+        std::string properties;
+        uint64_t properties_tile = 0;   // properties 来自的瓦片
+    };
+
+    using EndpointIndex = std::unordered_map<EndpointKey, size_t, KeyHash>;
+
+    void Merge(Fragment& fragment, std::vector<size_t>& touched);
+    void TakeProperties(Chain& chain, Fragment& fragment);
+
+    // 在 index 中查找与 p 在容差内重合的端点
+    EndpointIndex::const_iterator Find(const EndpointIndex& index, const SegmentKey& key,
+                                       const utils::WorldPoint& p, bool at_start) const;
+    void Index(size_t id);
+    void Unindex(size_t id);
+
+    // 端点所在（或相邻）的尚未处理的瓦片，以及尚未处理的 host 瓦片，写入 blockers
+    void Blockers(const Chain& chain, std::vector<uint64_t>& blockers) const;
+    uint64_t TileIdAt(int64_t column, int64_t row) const;
+
+    void Write(const Chain& chain, FeatureCollectionWriter& out);
+    void WriteGeometry(JsonWriter& w, const Chain& chain);
+
+    uint32_t level_ = 0;
+    int precision_;
+    utils::GeometryEncoding encoding_;
+    int indent_;
+
+    std::mutex staged_mutex_;
+    std::vector<Fragment> staged_;
+
+    std::unordered_set<uint64_t> tiles_;      // 导出范围内的全部瓦片
+    std::unordered_set<uint64_t> pending_;    // 尚未处理的瓦片
+    std::unordered_map<size_t, Chain> chains_;
+    size_t next_chain_ = 0;
+    EndpointIndex starts_;
+    EndpointIndex ends_;
+    std::unordered_map<uint64_t, std::vector<size_t>> waiting_;   // 瓦片 -> 等待它的折线
+    // 已写出的 segment 及其首尾点，用于识别之后才遇到的重复副本
+    std::unordered_map<SegmentKey, std::pair<utils::WorldPoint, utils::WorldPoint>, KeyHash> emitted_;
+
+    std::map<uint32_t, utils::PolylineEncoder> encoders_;   // 按 world_bits
+
+    size_t fragments_ = 0;
+    size_t features_written_ = 0;
+    size_t duplicates_ = 0;
+};
+
+} // namespace converter
+
+#endif // SEGMENT_STITCHER_HPP
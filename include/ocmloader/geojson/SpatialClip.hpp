@@ -0,0 +1,135 @@
+// SpatialClip.hpp
+#pragma once
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <olp/core/geo/tiling/TileKey.h>
+
+namespace utils {
+
+/**
+ * @brief 裁剪方式（对应命令行参数 clip:）
+ */
+enum class ClipMode {
+    kNone,   // 不裁剪，保持整瓦片输出
+    kDrop,   // 丢弃几何完全在区域外的要素
+    kCut     // 丢弃区域外要素，并把跨越边界的线裁剪到区域内（可能得到 MultiLineString）
+};
+
+/**
+ * @brief 解析 clip: 参数值（"none" / "drop" / "cut"）
+ * @throws std::invalid_argument 未知的裁剪方式
+ */
+ClipMode ParseClipMode(const std::string& name);
+
+/**
+ * @brief 裁剪区域：矩形（bbox）或简单多边形，坐标为经纬度
+ */
+class ClipArea {
+public:
+    static ClipArea FromBBox(double min_lng, double min_lat, double max_lng, double max_lat);
+
+    /**
+     * @param lng_lat 依次为 lng,lat,lng,lat,...，首尾不需要重复
+     * @throws std::invalid_argument 少于 3 个顶点
+     */
+    static ClipArea FromPolygon(const std::vector<double>& lng_lat);
+
+    bool is_polygon() const { return !ring_.empty(); }
+
+    // 外接矩形（经纬度），也用于计算需要加载的瓦片
+    double min_lng() const { return min_lng_; }
+    double min_lat() const { return min_lat_; }
+    double max_lng() const { return max_lng_; }
+    double max_lat() const { return max_lat_; }
+
+    // 多边形顶点 (lng, lat)，矩形时为空
+    const std::vector<std::pair<double, double>>& ring() const { return ring_; }
+
+private:
+    double min_lng_ = 0.0;
+    double min_lat_ = 0.0;
+    double max_lng_ = 0.0;
+    double max_lat_ = 0.0;
+    std::vector<std::pair<double, double>> ring_;
+};
+
+// 世界坐标（与转换器中 I_LNG / I_LAT 一致），用 int64 避免瓦片原点相加时溢出
+struct WorldPoint {
+    int64_t x;
+    int64_t y;
+};
+
+enum class ClipResult { kInside, kOutside, kPartial };
+
+/**
+ * @brief 单个瓦片内的裁剪器：区域在构造时按瓦片的 world_coordinate_bits 投影一次，
+ *        之后直接在解码出的整数坐标上判断，不需要先转换为经纬度。
+ *
+ * 矩形区域用 Cohen–Sutherland 区域码快速接受/拒绝，再按参数化方式求交；
+ * 多边形区域先用外接矩形拒绝，再与各条边求交并用奇偶规则判断内外。
+ */
+class TileClipper {
+public:
+    /**
+     * @param area 裁剪区域，为空或 mode 为 kNone 时不生效
+     */
+    TileClipper(const ClipArea* area, ClipMode mode, const olp::geo::TileKey& tile_key, uint32_t world_bits);
+
+    bool active() const { return mode_ != ClipMode::kNone; }
+
+    ClipMode mode() const { return mode_; }
+
+    /**
+     * @brief 把 LineString 的瓦片内坐标 xy_coords 转为世界坐标追加到 out
+     */
+    template <typename LineString>
+    void AppendLine(const LineString& line_string, std::vector<WorldPoint>& out) const {
+        const int num_coords = line_string.xy_coords_size();
+        for (int j = 0; j + 1 < num_coords; j += 2) {
+            out.push_back({origin_x_ + line_string.xy_coords(j), origin_y_ + line_string.xy_coords(j + 1)});
+        }
+    }
+
+    /**
+     * @brief 判断折线与区域的关系：只在角点或边界上擦过（相交部分长度为 0）的折线为 kOutside
+     */
+    ClipResult Classify(const std::vector<WorldPoint>& line) const;
+
+    /**
+     * @brief 把折线裁剪为区域内的若干段（每段至少两个点）
+     */
+    std::vector<std::vector<WorldPoint>> Cut(const std::vector<WorldPoint>& line) const;
+
+    /**
+     * @brief 裁剪结果转为 GeoJSON geometry：一段为 LineString，多段为 MultiLineString
+     * @param precision 坐标小数位数（见 precision:），< 0 时不舍入
+     */
+    nlohmann::json ToGeometry(const std::vector<std::vector<WorldPoint>>& pieces, int precision = -1) const;
+
+private:
+    using Interval = std::pair<double, double>;
+
+    // 线段 p->q 在区域内的参数区间 [t0, t1]（按 t 递增）
+    void SegmentIntervals(const WorldPoint& p, const WorldPoint& q, std::vector<Interval>& out) const;
+
+    bool RectContains(const WorldPoint& p) const;
+    bool PolygonContains(double x, double y) const;
+    int OutCode(const WorldPoint& p) const;
+
+    ClipMode mode_ = ClipMode::kNone;
+    uint32_t world_bits_ = 0;
+    int64_t origin_x_ = 0;
+    int64_t origin_y_ = 0;
+
+    // 投影后的区域（世界坐标）：外接矩形取整后包含边界
+    int64_t min_x_ = 0;
+    int64_t min_y_ = 0;
+    int64_t max_x_ = 0;
+    int64_t max_y_ = 0;
+    std::vector<std::pair<double, double>> polygon_;
+};
+
+} // namespace utils
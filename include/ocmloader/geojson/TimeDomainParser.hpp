@@ -1,17 +1,160 @@
 #ifndef TIMEDOMAIN_PARSER_HPP
 #define TIMEDOMAIN_PARSER_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace TimeDomainParser {
 
 /**
- * 将 TimeDomain 前缀表达式转换为可读字符串。
- * @param expr TimeDomain 前缀形式表达式 (e.g. "-(d1){w1}(d3){d1}")
+ * 时间项中的一个字段，如 h8 -> {'h', 8}、M10 -> {'M', 10}；没有数字时 value 为 -1
+ */
+struct TimeField {
+    char unit;
+    int value;
+};
+
+/**
+ * 求值用的本地时间（TimeDomain 按道路所在地的本地时间定义）
+ */
+struct LocalTime {
+    int year = 1970;
+    int month = 1;    // 1-12
+    int day = 1;      // 1-31
+    int hour = 0;
+    int minute = 0;
+    int second = 0;
+};
+
+/**
+ * 时间项编译后的集合/区间形式，按 GDF 定义求值：y 年，M 月，w 月内第几周（第 1 周为 1-7 日），
+ * d 月内日期，t 星期（t1 = 周日），h/m/s 时分秒。
+ * 起始时间中未给出且比最小给出单位大的字段取全部值，比它小的字段取最小值；
+ * 没有 {} 持续时间时持续一个最小给出单位。
+ */
+struct Schedule {
+    bool evaluable = false;    // 含 z（日出日落）等无法按时刻求值的单位时为 false
+    int year = -1;             // -1 表示不限
+    uint16_t months = 0;       // 第 m-1 位对应 m 月
+    uint32_t days = 0;         // 第 d-1 位对应 d 日
+    uint8_t weeks = 0;         // 第 w-1 位对应月内第 w 周
+    uint8_t weekdays = 0;      // 第 t-1 位对应 t（0 位为周日）
+    uint32_t hours = 0;
+    uint64_t minutes = 0;
+    uint64_t seconds = 0;
+    int duration_months = 0;
+    int64_t duration_seconds = 0;
+};
+
+/**
+ * TimeDomain 前缀表达式编译后的语法树节点
+ */
+struct Node {
+    enum class Kind {
+        Empty,   // 表达式已结束
+        Term,    // 时间项，如 (d1){w1} 或 d1
+        Not,     // !A
+        Range,   // -A B
+        And,     // *A B ...
+        Or       // +A B ...
+    };
+
+    Kind kind = Kind::Empty;
+
+    // Term：起始时间的主项（括号内第一个逗号/空格之前的部分）及其字段，以及 {} 中的持续时间字段
+    std::string term;
+    std::vector<TimeField> start;
+    std::vector<TimeField> duration;
+    Schedule schedule;
+
+    std::vector<Node> children;
+};
+
+/**
+ * 编译后的 TimeDomain 表达式：只解析一次，可读字符串在编译时生成，
+ * 语法树（roots()）可供其他用途直接使用，不需要重新解析。
+ */
+class Expression {
+public:
+    /**
+     * @brief 解析表达式；不认识的字符被跳过，与 TimeDomainToReadable 的容错方式相同
+     */
+    static Expression Compile(const std::string& expr);
+
+    // 顶层的各个表达式（可读形式中以 "; " 连接）
+    const std::vector<Node>& roots() const { return roots_; }
+
+    const std::string& readable() const { return readable_; }
+
+    /**
+     * @brief 在本地时间 t 是否生效。+ 为并集，* 为交集，! 为补集，-A B 为 A 中去掉 B，顶层多个表达式取并集；
+     *        含无法求值的时间项而不能确定结果时按生效处理
+     */
+    bool AppliesAt(const LocalTime& t) const;
+
+private:
+    std::vector<Node> roots_;
+    std::string readable_;
+};
+
+/**
+ * @brief 解析 ISO 8601 时间，如 2024-05-01、2024-05-01T08:30、2024-05-01T08:30:00Z；
+ *        时区后缀被忽略，按本地时间求值
+ * @throws std::invalid_argument 格式错误或数值越界
+ */
+LocalTime ParseTimestamp(const std::string& iso);
+
+// 缓存的表达式条数上限（按最近使用淘汰）
+constexpr size_t kCacheCapacity = 4096;
+
+/**
+ * @brief 带缓存的编译：同一表达式字符串只解析一次，线程安全。
+ *        缓存按表达式分片加锁，总条数不超过 kCacheCapacity，超出时淘汰分片内最久未使用的条目
+ */
+std::shared_ptr<const Expression> CompileCached(const std::string& expr);
+
+/**
+ * 将 TimeDomain 前缀表达式转换为可读字符串（经 CompileCached 缓存）。
+ * tN 为星期（t1 为周日），dN 为每月第 N 天；"-" 为减运算，与 ValidityFilter 的求值一致。
+ * @param expr TimeDomain 前缀形式表达式 (e.g. "-(t2){d1}(t4){d1}")
  * @return 人类可读字符串 (e.g. "Mon excluding Wed")
  */
 std::string TimeDomainToReadable(const std::string& expr);
 
+/**
+ * @brief valid_at: 对应的时间过滤：在固定时刻对 applies_during 求值，
+ *        每个表达式字符串只编译、求值一次（线程安全），之后的 segment 直接查表
+ */
+class ValidityFilter {
+public:
+    explicit ValidityFilter(const LocalTime& time) : time_(time) {}
+
+    const LocalTime& time() const { return time_; }
+
+    bool Applies(const std::string& expr) const;
+
+    // 任一表达式生效即生效，没有表达式表示总是生效
+    template <typename Range>
+    bool AppliesAny(const Range& exprs) const {
+        bool empty = true;
+        for (const auto& expr : exprs) {
+            if (Applies(expr)) return true;
+            empty = false;
+        }
+        return empty;
+    }
+
+private:
+    LocalTime time_;
+    mutable std::mutex mutex_;
+    mutable std::unordered_map<std::string, bool> results_;
+};
+
 } // namespace TimeDomainParser
 
-#endif // TIMEDOMAIN_PARSER_HPP
\ No newline at end of file
+#endif // TIMEDOMAIN_PARSER_HPP
@@ -0,0 +1,1201 @@
+// OCMBench.cpp
+// 转换链路中热点代码的微基准：ocm-bench [filter|serializer|decode|precision|encoding|tileid|all]
+#include "AttributeCache.hpp"
+#include "NameTables.hpp"
+#include "FeatureFilter.hpp"
+#include "GeoJsonWriter.hpp"
+#include "CoordinateDecoder.hpp"
+#include "GeometryEncoding.hpp"
+#include "LineSimplifier.hpp"
+#include "TileIDConverter.hpp"
+#include "TimeDomainParser.hpp"
+#include "RawLayerWriter.hpp"
+#include "ThreadPool.hpp"
+#include "TileArena.hpp"
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <cctype>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/util/json_util.h>
+
+using json = nlohmann::json;
+
+namespace {
+
+// 返回每次调用 fn 的平均耗时（纳秒）
+template <typename Fn>
+double MeasureNs(int iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+void PrintResult(const std::string& name, double baseline_ns, double optimized_ns) {
+    std::cout << name << ": baseline " << baseline_ns << " ns, optimized " << optimized_ns
+              << " ns, speedup x" << (optimized_ns > 0 ? baseline_ns / optimized_ns : 0) << std::endl;
+}
+
+} // namespace
+
+// ------------------------- filter -------------------------
+
+namespace legacy {
+
+// 旧版 OCMLoader.cpp 中按 JSON 解释执行的 filter，作为对照基线
+struct Condition {
+    std::string key;
+    std::string op;
+    std::string value;
+};
+
+enum class NodeType { AND, OR, CONDITION };
+
+struct Node {
+    NodeType type;
+    std::vector<Node> children;  // 对于 AND/OR
+    Condition cond;              // 对于叶子条件
+};
+
+inline std::string trim(const std::string& s) {
+    size_t start = s.find_first_not_of(" \t\n\r");
+    size_t end = s.find_last_not_of(" \t\n\r");
+    return (start == std::string::npos) ? "" : s.substr(start, end - start + 1);
+}
+
+Condition parseCondition(const std::string& s) {
+    static const std::vector<std::string> ops = { ">=", "<=", "=", ">", "<" };
+    for (const auto& op : ops) {
+        size_t pos = s.find(op);
+        if (pos != std::string::npos) {
+            return { trim(s.substr(0,pos)), op, trim(s.substr(pos+op.size())) };
+        }
+    }
+    throw std::runtime_error("Invalid condition: " + s);
+}
+
+Node parseExpression(const std::string& s) {
+    std::string expr = trim(s);
+
+    if (expr.empty()) throw std::runtime_error("Empty expression");
+
+    // AND(...) 或 OR(...)
+    if (expr.substr(0, 4) == "AND(" && expr.back() == ')') {
+        Node node{ NodeType::AND };
+        std::string inner = expr.substr(4, expr.size()-5);
+        std::stringstream ss(inner);
+        std::string token;
+        int paren = 0;
+        std::string buf;
+        for (char c : inner) {
+            if (c=='(') paren++;
+            if (c==')') paren--;
+            if ((c==',' || c==';') && paren==0) {
+                if (!buf.empty()) node.children.push_back(parseExpression(buf));
+                buf.clear();
+            } else buf += c;
+        }
+        if (!buf.empty()) node.children.push_back(parseExpression(buf));
+        return node;
+    } 
+    else if (expr.substr(0,3)=="OR(" && expr.back()==')') {
+        Node node{ NodeType::OR };
+        std::string inner = expr.substr(3, expr.size()-4);
+        std::stringstream ss(inner);
+        std::string token;
+        int paren=0;
+        std::string buf;
+        for (char c:inner){
+            if(c=='(') paren++;
+            if(c==')') paren--;
+            if((c==','||c==';') && paren==0){
+                if(!buf.empty()) node.children.push_back(parseExpression(buf));
+                buf.clear();
+            } else buf += c;
+        }
+        if(!buf.empty()) node.children.push_back(parseExpression(buf));
+        return node;
+    } 
+    else {
+        // 单个条件
+        Node node{ NodeType::CONDITION };
+        node.cond = parseCondition(expr);
+        return node;
+    }
+}
+
+json nodeToJson(const Node& node) {
+    if (node.type == NodeType::CONDITION) {
+        return json{{"key", node.cond.key}, {"op", node.cond.op}, {"value", node.cond.value}};
+    } else {
+        json j;
+        j[node.type == NodeType::AND ? "and" : "or"] = json::array();
+        for (const auto& child : node.children)
+            j[node.type == NodeType::AND ? "and" : "or"].push_back(nodeToJson(child));
+        return j;
+    }
+}
+
+
+static bool compareValues(const json& featureValue, const std::string& op, const json& filterValue) {
+    if (op == "=") {
+        double fv, val;
+        bool fvIsNum = false, valIsNum = false;
+
+        if (featureValue.is_number()) { fv = featureValue.get<double>(); fvIsNum = true; }
+        else if (featureValue.is_string()) { try { fv = std::stod(featureValue.get<std::string>()); fvIsNum = true; } catch (...) {} }
+
+        if (filterValue.is_number()) { val = filterValue.get<double>(); valIsNum = true; }
+        else if (filterValue.is_string()) { try { val = std::stod(filterValue.get<std::string>()); valIsNum = true; } catch (...) {} }
+
+        if (fvIsNum && valIsNum) return fv == val;
+
+        // ---- 忽略大小写的字符串比较 ----
+        if (featureValue.is_string() && filterValue.is_string()) {
+            std::string fvStr = featureValue.get<std::string>();
+            std::string valStr = filterValue.get<std::string>();
+
+            auto toLower = [](std::string& s) {
+                std::transform(s.begin(), s.end(), s.begin(),
+                               [](unsigned char c){ return std::tolower(c); });
+            };
+
+            toLower(fvStr);
+            toLower(valStr);
+
+            return fvStr == valStr;
+        }
+
+        // 兜底
+        return featureValue.dump() == filterValue.dump();
+    }
+
+    // 其他比较符要求数字
+    double fv, val;
+    try {
+        fv = featureValue.is_number() ? featureValue.get<double>() : std::stod(featureValue.get<std::string>());
+        val = filterValue.is_number() ? filterValue.get<double>() : std::stod(filterValue.get<std::string>());
+    } catch (...) { return false; }
+
+    if (op == ">") return fv > val;
+    if (op == "<") return fv < val;
+    if (op == ">=") return fv >= val;
+    if (op == "<=") return fv <= val;
+
+    return false;
+}
+
+static bool matchCondition(const json& feature, const json& cond) {
+    if (!cond.contains("key") || !cond.contains("op") || !cond.contains("value")) {
+        return false;
+    }
+
+    std::string key = cond["key"].get<std::string>();
+    std::string op  = cond["op"].get<std::string>();
+    const json& val = cond["value"];
+
+    // 在 properties 里找
+    if (feature.contains("properties") && feature["properties"].contains(key)) {
+        if (compareValues(feature["properties"][key], op, val)) {
+            return true;
+        }
+    }
+
+    // 在 attributes 数组里找
+    if (feature.contains("properties") &&
+        feature["properties"].contains("attributes") &&
+        feature["properties"]["attributes"].is_array())
+    {
+        for (auto& attr : feature["properties"]["attributes"]) {
+            if (attr.contains(key)) {
+                if (compareValues(attr[key], op, val)) {
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+bool matchFeature(const json& feature, const json& filter) {
+    // filter 是数组
+    if (!filter.is_array()) {
+        return false;
+    }
+
+    // 每个元素是一个 and/or 逻辑对象
+    for (auto& logicGroup : filter) {
+        if (logicGroup.contains("and")) {
+            bool allMatch = true;
+            for (auto& cond : logicGroup["and"]) {
+                if (!matchCondition(feature, cond)) {
+                    allMatch = false;
+                    break;
+                }
+            }
+            if (!allMatch) return false; // and 组里有一个不满足，整个失败
+        }
+        else if (logicGroup.contains("or")) {
+            bool anyMatch = false;
+            for (auto& cond : logicGroup["or"]) {
+                if (matchCondition(feature, cond)) {
+                    anyMatch = true;
+                    break;
+                }
+            }
+            if (!anyMatch) return false; // or 组里全不满足，整个失败
+        }
+    }
+
+    return true;
+}
+
+json BuildFilter(const std::string& filterStr) {
+    std::stringstream ss(filterStr);
+    std::string part;
+    json finalJson = json::array();
+    while (std::getline(ss, part, ';')) {
+        if (part.empty()) continue;
+        finalJson.push_back(nodeToJson(parseExpression(part)));
+    }
+    return finalJson;
+}
+
+} // namespace legacy
+
+std::vector<json> MakeSyntheticFeatures(size_t count) {
+    static const char* kClasses[] = {
+        "FUNCTIONAL_CLASS_1", "FUNCTIONAL_CLASS_2", "FUNCTIONAL_CLASS_3",
+        "FUNCTIONAL_CLASS_4", "FUNCTIONAL_CLASS_5"
+    };
+    std::vector<json> features;
+    features.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        json properties;
+        properties["tile_id"] = 377893287u;
+        properties["local_id"] = static_cast<uint32_t>(i);
+        properties["length"] = static_cast<uint32_t>(i % 400);
+        properties["host_tile_id"] = 377893287u;
+        json attributes = json::array();
+        for (size_t a = 0; a < 3; ++a) {
+            json attr;
+            attr["start_offset"] = static_cast<uint32_t>(a * 1000);
+            attr["forward_speed_limit"] = static_cast<uint32_t>(((i + a) % 8) * 10);
+            attr["backward_speed_limit"] = static_cast<uint32_t>(((i + a) % 6) * 10);
+            attr["functional_class"] = kClasses[(i + a) % 5];
+            attr["travel_direction"] = "BOTH";
+            attr["speed_category"] = "SPEED_CATEGORY_6";
+            attr["urban"] = (i % 2) == 0;
+            attr["access"] = json::array({"AUTOMOBILES", "BUSES", "TRUCKS"});
+            attributes.push_back(attr);
+        }
+        properties["attributes"] = attributes;
+
+        json feature;
+        feature["type"] = "Feature";
+        feature["properties"] = properties;
+        features.push_back(feature);
+    }
+    return features;
+}
+
+void BenchFilter() {
+    const std::string filterStr =
+        "AND(forward_speed_limit=30,functional_class=functional_class_3);OR(length>100,backward_speed_limit<=20)";
+    const std::vector<json> features = MakeSyntheticFeatures(20000);
+
+    const json legacyFilter = legacy::BuildFilter(filterStr);
+    const feature_filter::CompiledFilter compiled = feature_filter::CompiledFilter::Compile(filterStr);
+
+    size_t legacyMatched = 0;
+    size_t compiledMatched = 0;
+    const int kRounds = 10;
+    double legacyNs = MeasureNs(kRounds, [&]() {
+        legacyMatched = 0;
+        for (const auto& feature : features) legacyMatched += legacy::matchFeature(feature, legacyFilter);
+    });
+    double compiledNs = MeasureNs(kRounds, [&]() {
+        compiledMatched = 0;
+        for (const auto& feature : features) compiledMatched += compiled.Match(feature);
+    });
+
+    std::cout << "filter: " << features.size() << " features, matched " << legacyMatched
+              << " (legacy) / " << compiledMatched << " (compiled)" << std::endl;
+    PrintResult("filter ns/feature", legacyNs / features.size(), compiledNs / features.size());
+}
+
+// ------------------------- serializer -------------------------
+// 构造 JSON DOM 再 dump(4)（旧输出路径）与 JsonWriter 直接写入的对比，输入为模拟的解码后 segment
+
+struct SyntheticAttribute {
+    uint32_t start_offset;
+    uint32_t forward_speed_limit;
+    const char* functional_class;
+    bool urban;
+};
+
+struct SyntheticSegment {
+    uint32_t local_id;
+    uint32_t length;
+    std::vector<std::pair<double, double>> coordinates;
+    std::vector<SyntheticAttribute> attributes;
+};
+
+std::vector<SyntheticSegment> MakeSyntheticSegments(size_t count) {
+    static const char* kClasses[] = {
+        "FUNCTIONAL_CLASS_1", "FUNCTIONAL_CLASS_2", "FUNCTIONAL_CLASS_3",
+        "FUNCTIONAL_CLASS_4", "FUNCTIONAL_CLASS_5"
+    };
+    std::vector<SyntheticSegment> segments(count);
+    for (size_t i = 0; i < count; ++i) {
+        SyntheticSegment& seg = segments[i];
+        seg.local_id = static_cast<uint32_t>(i);
+        seg.length = static_cast<uint32_t>(i % 400);
+        for (size_t p = 0; p < 12; ++p) {
+            seg.coordinates.emplace_back(13.0883 + (i * 12 + p) * 1.7e-5, 52.3381 + p * 2.3e-5);
+        }
+        for (size_t a = 0; a < 3; ++a) {
+            seg.attributes.push_back({static_cast<uint32_t>(a * 1000), static_cast<uint32_t>(((i + a) % 8) * 10),
+                                      kClasses[(i + a) % 5], (i % 2) == 0});
+        }
+    }
+    return segments;
+}
+
+std::string SerializeDom(const std::vector<SyntheticSegment>& segments) {
+    json fc;
+    fc["type"] = "FeatureCollection";
+    fc["features"] = json::array();
+    for (const auto& seg : segments) {
+        json geometry;
+        geometry["type"] = "LineString";
+        geometry["coordinates"] = json::array();
+        for (const auto& c : seg.coordinates) geometry["coordinates"].push_back({c.first, c.second});
+
+        json attributes = json::array();
+        for (const auto& a : seg.attributes) {
+            json attr;
+            attr["start_offset"] = a.start_offset;
+            attr["forward_speed_limit"] = a.forward_speed_limit;
+            attr["functional_class"] = a.functional_class;
+            attr["urban"] = a.urban;
+            attributes.push_back(attr);
+        }
+        json properties;
+        properties["tile_id"] = 377893287u;
+        properties["local_id"] = seg.local_id;
+        properties["length"] = seg.length;
+        properties["attributes"] = attributes;
+
+        json feature;
+        feature["type"] = "Feature";
+        feature["geometry"] = geometry;
+        feature["properties"] = properties;
+        fc["features"].push_back(feature);
+    }
+    return fc.dump(4);
+}
+
+std::string SerializeStream(const std::vector<SyntheticSegment>& segments) {
+    std::ostringstream os;
+    converter::FeatureCollectionWriter out(os);
+    for (const auto& seg : segments) {
+        converter::JsonWriter& w = out.BeginFeature();
+        w.BeginObject();
+        w.Key("geometry");
+        w.BeginObject();
+        w.Key("coordinates");
+        w.BeginArray();
+        for (const auto& c : seg.coordinates) {
+            w.BeginArray();
+            w.Double(c.first);
+            w.Double(c.second);
+            w.EndArray();
+        }
+        w.EndArray();
+        w.Field("type", "LineString");
+        w.EndObject();
+        w.Key("properties");
+        w.BeginObject();
+        w.Key("attributes");
+        w.BeginArray();
+        for (const auto& a : seg.attributes) {
+            w.BeginObject();
+            w.Field("forward_speed_limit", a.forward_speed_limit);
+            w.Field("functional_class", a.functional_class);
+            w.Field("start_offset", a.start_offset);
+            w.Field("urban", a.urban);
+            w.EndObject();
+        }
+        w.EndArray();
+        w.Field("length", seg.length);
+        w.Field("local_id", seg.local_id);
+        w.Field("tile_id", 377893287u);
+        w.EndObject();
+        w.Field("type", "Feature");
+        w.EndObject();
+        out.EndFeature();
+    }
+    out.Close();
+    return os.str();
+}
+
+void BenchSerializer() {
+    const std::vector<SyntheticSegment> segments = MakeSyntheticSegments(5000);
+
+    std::string domOut;
+    std::string streamOut;
+    const int kRounds = 5;
+    double domNs = MeasureNs(kRounds, [&]() { domOut = SerializeDom(segments); });
+    double streamNs = MeasureNs(kRounds, [&]() { streamOut = SerializeStream(segments); });
+
+    std::cout << "serializer: " << segments.size() << " features, " << domOut.size() << " bytes, output "
+              << (domOut == streamOut ? "identical" : "DIFFERENT") << std::endl;
+    PrintResult("serializer ns/feature", domNs / segments.size(), streamNs / segments.size());
+}
+
+// ------------------------- decode -------------------------
+// 旧版逐点计算（每点重新计算瓦片原点）与 CoordinateDecoder 批量解码的对比
+
+void BenchDecode() {
+    const uint32_t worldBits = 24;
+    const uint32_t level = 14;
+    const olp::geo::TileKey tileKey = olp::geo::TileKey::FromRowColumnLevel(5427, 8787, level);
+
+    std::vector<uint32_t> xy(2 * 100000);
+    for (size_t i = 0; i < xy.size(); ++i) {
+        xy[i] = static_cast<uint32_t>((i * 2654435761u) % (1u << (worldBits - level)));
+    }
+    const size_t count = xy.size() / 2;
+    std::vector<double> lng(count), lat(count);
+    std::vector<double> refLng(count), refLat(count);
+
+    const int kRounds = 50;
+    double legacyNs = MeasureNs(kRounds, [&]() {
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t I_LNG = (tileKey.Column() << (worldBits - level)) + xy[2 * i];
+            refLng[i] = (I_LNG * 360.0) / (1 << worldBits) - 180.0;
+            uint32_t I_LAT = (tileKey.Row() << (worldBits - level)) + xy[2 * i + 1];
+            refLat[i] = (I_LAT * 360.0) / (1 << worldBits) - 90.0;
+        }
+    });
+    const utils::CoordinateDecoder decoder(tileKey, worldBits, level);
+    double decoderNs = MeasureNs(kRounds, [&]() {
+        decoder.Decode(xy.data(), count, lng.data(), lat.data());
+    });
+
+    std::cout << "decode: " << count << " points, backend " << utils::CoordinateDecoder::Backend() << ", output "
+              << (lng == refLng && lat == refLat ? "identical" : "DIFFERENT") << std::endl;
+    PrintResult("decode ns/point", legacyNs / count, decoderNs / count);
+}
+
+// ------------------------- precision -------------------------
+// 坐标输出：double 最短往返表示（Grisu2）与 precision:7 定点整数格式化的对比
+
+void BenchPrecision() {
+    const uint32_t worldBits = 24;
+    const uint32_t level = 14;
+    const int precision = 7;
+    const olp::geo::TileKey tileKey = olp::geo::TileKey::FromRowColumnLevel(5427, 8787, level);
+
+    std::vector<uint32_t> xy(2 * 100000);
+    for (size_t i = 0; i < xy.size(); ++i) {
+        xy[i] = static_cast<uint32_t>((i * 2654435761u) % (1u << (worldBits - level)));
+    }
+    const size_t count = xy.size() / 2;
+    const utils::CoordinateDecoder decoder(tileKey, worldBits, level);
+    std::vector<double> lng(count), lat(count);
+    std::vector<int64_t> lngFixed(count), latFixed(count);
+
+    converter::JsonWriter w(-1);
+    size_t doubleBytes = 0;
+    size_t fixedBytes = 0;
+    const int kRounds = 10;
+    double doubleNs = MeasureNs(kRounds, [&]() {
+        w.buffer().clear();
+        decoder.Decode(xy.data(), count, lng.data(), lat.data());
+        w.BeginArray();
+        for (size_t i = 0; i < count; ++i) {
+            w.BeginArray();
+            w.Double(lng[i]);
+            w.Double(lat[i]);
+            w.EndArray();
+        }
+        w.EndArray();
+        doubleBytes = w.buffer().size();
+    });
+    double fixedNs = MeasureNs(kRounds, [&]() {
+        w.buffer().clear();
+        decoder.DecodeFixed(xy.data(), count, precision, lngFixed.data(), latFixed.data());
+        w.BeginArray();
+        for (size_t i = 0; i < count; ++i) {
+            w.BeginArray();
+            w.Fixed(lngFixed[i], precision);
+            w.Fixed(latFixed[i], precision);
+            w.EndArray();
+        }
+        w.EndArray();
+        fixedBytes = w.buffer().size();
+    });
+
+    std::cout << "precision: " << count << " points, " << doubleBytes << " bytes (shortest) / "
+              << fixedBytes << " bytes (precision:" << precision << ")" << std::endl;
+    PrintResult("precision ns/point", doubleNs / count, fixedNs / count);
+}
+
+// ------------------------- encoding -------------------------
+// geometry: 输出：coordinates 数组与 flexpolyline / delta64 编码字符串的体积和耗时
+
+// 与 LineString 相同的访问接口
+struct SyntheticLine {
+    std::vector<uint32_t> xy;
+    int xy_coords_size() const { return static_cast<int>(xy.size()); }
+    uint32_t xy_coords(int i) const { return xy[static_cast<size_t>(i)]; }
+    const std::vector<uint32_t>& xy_coords() const { return xy; }
+};
+
+void BenchEncoding() {
+    const uint32_t worldBits = 24;
+    const uint32_t level = 14;
+    const olp::geo::TileKey tileKey = olp::geo::TileKey::FromRowColumnLevel(5427, 8787, level);
+    const utils::CoordinateDecoder decoder(tileKey, worldBits, level);
+
+    // 随机游走的折线，每条 16 个点，相邻点间距不超过 ±8 个世界坐标单位
+    std::vector<SyntheticLine> lines(10000);
+    uint32_t seed = 12345;
+    auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+    for (auto& line : lines) {
+        uint32_t x = next() % 1024, y = next() % 1024;
+        for (int k = 0; k < 16; ++k) {
+            x = std::min<uint32_t>(1023, x + next() % 17 - std::min<uint32_t>(x, 8));
+            y = std::min<uint32_t>(1023, y + next() % 17 - std::min<uint32_t>(y, 8));
+            line.xy.push_back(x);
+            line.xy.push_back(y);
+        }
+    }
+
+    converter::JsonWriter w(-1);
+    std::vector<double> lng, lat;
+    size_t geojsonBytes = 0;
+    const int kRounds = 10;
+    const double geojsonNs = MeasureNs(kRounds, [&]() {
+        w.buffer().clear();
+        for (const auto& line : lines) {
+            w.BeginObject();
+            w.Key("coordinates");
+            w.BeginArray();
+            decoder.Decode(line, lng, lat);
+            for (size_t k = 0; k < lng.size(); ++k) {
+                w.BeginArray();
+                w.Double(lng[k]);
+                w.Double(lat[k]);
+                w.EndArray();
+            }
+            w.EndArray();
+            w.Field("type", "LineString");
+            w.EndObject();
+        }
+        geojsonBytes = w.buffer().size();
+    });
+
+    for (const auto encoding : {utils::GeometryEncoding::kFlexPolyline, utils::GeometryEncoding::kDelta64}) {
+        utils::PolylineEncoder encoder(encoding, worldBits, -1);
+        size_t bytes = 0;
+        const double encodedNs = MeasureNs(kRounds, [&]() {
+            w.buffer().clear();
+            for (const auto& line : lines) {
+                encoder.Clear();
+                encoder.AddLine(line, decoder);
+                encoder.WriteGeometry(w);
+            }
+            bytes = w.buffer().size();
+        });
+        std::cout << "encoding: " << lines.size() << " lines, " << geojsonBytes << " bytes (geojson) / "
+                  << bytes << " bytes (" << utils::GeometryEncodingName(encoding) << ")" << std::endl;
+        PrintResult(std::string("encoding ns/line ") + utils::GeometryEncodingName(encoding),
+                    geojsonNs / lines.size(), encodedNs / lines.size());
+    }
+}
+
+// ------------------------- simplify -------------------------
+// simplify: 输出：完整坐标与 Douglas–Peucker 简化后的体积和耗时（耗时包含简化本身）
+
+void BenchSimplify() {
+    const uint32_t worldBits = 31;
+    const uint32_t level = 14;
+    const olp::geo::TileKey tileKey = olp::geo::TileKey::FromRowColumnLevel(5427, 8787, level);
+    const utils::CoordinateDecoder decoder(tileKey, worldBits, level);
+
+    // 弯曲的道路：每条 200 个点，点间距约 5 米，带 ±0.3 米的抖动（31 位世界坐标一个单位约 1.9 厘米）
+    std::vector<SyntheticLine> lines(2000);
+    uint32_t seed = 12345;
+    auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+    for (auto& line : lines) {
+        double x = next() % 100000, y = next() % 100000;
+        double heading = (next() % 628) / 100.0;
+        const double turn = ((next() % 200) / 100.0 - 1.0) * 0.02;
+        for (int k = 0; k < 200; ++k) {
+            heading += turn;
+            x += 260.0 * std::cos(heading);
+            y += 260.0 * std::sin(heading);
+            line.xy.push_back(static_cast<uint32_t>(std::max(0.0, x + next() % 32 - 16.0)));
+            line.xy.push_back(static_cast<uint32_t>(std::max(0.0, y + next() % 32 - 16.0)));
+        }
+    }
+
+    const int precision = 7;
+    converter::JsonWriter w(-1);
+    std::vector<int64_t> lng, lat;
+    auto writeLines = [&](utils::LineSimplifier& simplifier) {
+        w.buffer().clear();
+        for (const auto& line : lines) {
+            const auto points = simplifier.Points(line);
+            lng.resize(points.second);
+            lat.resize(points.second);
+            decoder.DecodeFixed(points.first, points.second, precision, lng.data(), lat.data());
+            w.BeginArray();
+            for (size_t k = 0; k < points.second; ++k) {
+                w.BeginArray();
+                w.Fixed(lng[k], precision);
+                w.Fixed(lat[k], precision);
+                w.EndArray();
+            }
+            w.EndArray();
+        }
+    };
+
+    const int kRounds = 10;
+    utils::LineSimplifier full(utils::SimplifyTolerance(), tileKey, worldBits);
+    const double fullNs = MeasureNs(kRounds, [&]() { writeLines(full); });
+    const size_t fullBytes = w.buffer().size();
+
+    for (const char* option : {"1", "z16", "z12"}) {
+        utils::LineSimplifier simplifier(utils::ParseSimplifyTolerance(option), tileKey, worldBits);
+        const double simplifiedNs = MeasureNs(kRounds, [&]() { writeLines(simplifier); });
+        std::cout << "simplify:" << option << " (" << simplifier.tolerance_meters() << " m): "
+                  << fullBytes << " bytes -> " << w.buffer().size() << " bytes" << std::endl;
+        PrintResult(std::string("simplify ns/line simplify:") + option, fullNs / lines.size(), simplifiedNs / lines.size());
+    }
+}
+
+// ------------------------- tileid -------------------------
+// 旧版 TileIDConverter（二进制字符串 + stoi / stoull）与位运算实现的对比
+
+namespace legacy {
+
+std::string ToBinaryString(uint32_t num, uint32_t bits) {
+    std::string bin;
+    for (int i = static_cast<int>(bits) - 1; i >= 0; --i) {
+        bin += (num & (1U << i)) ? '1' : '0';
+    }
+    return bin;
+}
+
+uint64_t XYtoTileId(uint32_t x, uint32_t y, uint32_t level) {
+    const std::string x_bin = ToBinaryString(x, level);
+    const std::string y_bin = ToBinaryString(y, level);
+    std::string quadkey;
+    for (uint32_t i = 0; i < level; ++i) {
+        std::string two_bits = std::string(1, y_bin[i]) + x_bin[i];
+        quadkey += "0123"[std::stoi(two_bits, nullptr, 2)];
+    }
+    return std::stoull("1" + quadkey, nullptr, 4);
+}
+
+} // namespace legacy
+
+void BenchTileId() {
+    std::vector<TileIDConverter::TileXY> tiles(100000);
+    uint32_t seed = 7;
+    for (auto& tile : tiles) {
+        seed = seed * 1664525u + 1013904223u;
+        tile.level = 14;
+        tile.x = (seed >> 4) & 0x3FFF;
+        tile.y = (seed >> 18) & 0x3FFF;
+    }
+    std::vector<uint64_t> legacyIds(tiles.size()), ids(tiles.size()), batchIds(tiles.size());
+    std::vector<TileIDConverter::TileXY> decoded(tiles.size());
+
+    const int kRounds = 5;
+    const double legacyNs = MeasureNs(kRounds, [&]() {
+        for (size_t i = 0; i < tiles.size(); ++i) {
+            legacyIds[i] = legacy::XYtoTileId(tiles[i].x, tiles[i].y, tiles[i].level);
+        }
+    });
+    const double scalarNs = MeasureNs(kRounds, [&]() {
+        for (size_t i = 0; i < tiles.size(); ++i) {
+            ids[i] = TileIDConverter::XYtoTileId(tiles[i].x, tiles[i].y, tiles[i].level);
+        }
+    });
+    const double batchNs = MeasureNs(kRounds, [&]() {
+        TileIDConverter::XYtoTileIds(tiles.data(), tiles.size(), batchIds.data());
+    });
+    const double inverseNs = MeasureNs(kRounds, [&]() {
+        TileIDConverter::TileIdsToXY(batchIds.data(), batchIds.size(), decoded.data());
+    });
+
+    bool roundTrip = true;
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        roundTrip = roundTrip && decoded[i].x == tiles[i].x && decoded[i].y == tiles[i].y && decoded[i].level == tiles[i].level;
+    }
+    std::cout << "tileid: " << tiles.size() << " tiles, output "
+              << (ids == legacyIds && batchIds == legacyIds ? "identical" : "DIFFERENT")
+              << ", round trip " << (roundTrip ? "ok" : "FAILED") << std::endl;
+    PrintResult("tileid ns/tile (scalar)", legacyNs / tiles.size(), scalarNs / tiles.size());
+    PrintResult("tileid ns/tile (batch)", legacyNs / tiles.size(), batchNs / tiles.size());
+    std::cout << "tileid inverse (batch): " << inverseNs / tiles.size() << " ns/tile" << std::endl;
+}
+
+// ------------------------- timedomain -------------------------
+// 每次重新解析（Expression::Compile）与带缓存的 TimeDomainToReadable 对比；
+// 瓦片中 applies_during 的取值很少，同一表达式会被反复转换
+
+void BenchTimeDomain() {
+    const std::vector<std::string> distinct = {
+        "(h7){h2}", "*(d1){d5}(h7){h12}", "+(d6){d2}-(M5){M1}(M9){M1}",
+        "*(M10d1){M6}!(d7){d1}", "(z1){h12}", "*(t1){w1}(h22){h8}",
+    };
+    std::vector<std::string> periods;
+    for (int i = 0; i < 60000; ++i) periods.push_back(distinct[(i * 7) % distinct.size()]);
+
+    size_t parsedBytes = 0, cachedBytes = 0;
+    bool identical = true;
+    const int kRounds = 5;
+    const double parseNs = MeasureNs(kRounds, [&]() {
+        for (const auto& p : periods) parsedBytes += TimeDomainParser::Expression::Compile(p).readable().size();
+    });
+    const double cachedNs = MeasureNs(kRounds, [&]() {
+        for (const auto& p : periods) cachedBytes += TimeDomainParser::TimeDomainToReadable(p).size();
+    });
+    for (const auto& p : distinct) {
+        identical = identical && TimeDomainParser::Expression::Compile(p).readable() == TimeDomainParser::TimeDomainToReadable(p);
+    }
+
+    std::cout << "timedomain: " << periods.size() << " expressions (" << distinct.size() << " distinct), output "
+              << (identical && parsedBytes == cachedBytes ? "identical" : "DIFFERENT") << std::endl;
+    PrintResult("timedomain ns/expr", parseNs / periods.size(), cachedNs / periods.size());
+
+    // valid_at: 每次编译并求值，与按表达式缓存结果的 ValidityFilter 对比
+    const TimeDomainParser::LocalTime at = TimeDomainParser::ParseTimestamp("2024-05-01T08:30");
+    const TimeDomainParser::ValidityFilter validAt(at);
+    size_t evaluated = 0, filtered = 0;
+    const double evalNs = MeasureNs(kRounds, [&]() {
+        for (const auto& p : periods) evaluated += TimeDomainParser::Expression::Compile(p).AppliesAt(at);
+    });
+    const double filterNs = MeasureNs(kRounds, [&]() {
+        for (const auto& p : periods) filtered += validAt.Applies(p);
+    });
+    std::cout << "timedomain valid_at: " << filtered / kRounds << " of " << periods.size() << " apply, output "
+              << (evaluated == filtered ? "identical" : "DIFFERENT") << std::endl;
+    PrintResult("timedomain valid_at ns/expr", evalNs / periods.size(), filterNs / periods.size());
+}
+
+// ------------------------- rawdump -------------------------
+// 原始图层导出：MessageToJsonString + json::parse + setw(4) 重新输出，与 RawLayerWriter 直接写入对比；
+// 用一个较大的 FileDescriptorProto 代替图层消息
+
+void BenchRawDump() {
+    google::protobuf::FileDescriptorProto layer;
+    layer.set_name("layer.proto");
+    for (int m = 0; m < 400; ++m) {
+        auto* message = layer.add_message_type();
+        message->set_name("Segment" + std::to_string(m));
+        for (int f = 0; f < 50; ++f) {
+            auto* field = message->add_field();
+            field->set_name("attribute_" + std::to_string(f));
+            field->set_number(f + 1);
+            field->set_type(google::protobuf::FieldDescriptorProto::TYPE_UINT64);
+            field->set_json_name("attribute" + std::to_string(f));
+        }
+    }
+
+    size_t legacyBytes = 0;
+    const int kRounds = 3;
+    const double legacyNs = MeasureNs(kRounds, [&]() {
+        google::protobuf::util::JsonPrintOptions options;
+        options.add_whitespace = true;
+        std::string text;
+        (void)google::protobuf::util::MessageToJsonString(layer, &text, options);
+        json merged;
+        merged["features"] = json::array();
+        merged["features"].push_back(json::parse(text));
+        std::ostringstream out;
+        out << std::setw(4) << merged << std::endl;
+        legacyBytes = out.str().size();
+    });
+    std::string direct;
+    const double directNs = MeasureNs(kRounds, [&]() {
+        std::ostringstream out;
+        common_converter::RawLayerWriter writer(out, "23618402", 1);
+        writer.WriteLayer(layer, "isa-segment", 0);
+        writer.Close();
+        direct = out.str();
+    });
+    const json reparsed = json::parse(direct);
+
+    std::cout << "rawdump: " << layer.ByteSizeLong() << " bytes protobuf, legacy " << legacyBytes
+              << " bytes, direct " << direct.size() << " bytes, "
+              << (reparsed["features"][0]["messageType"].size() == 400 ? "valid JSON" : "INVALID") << std::endl;
+    PrintResult("rawdump ns/layer", legacyNs, directNs);
+
+    // raw:pb：同一图层直接写 protobuf 二进制，并读回校验
+    std::string binary;
+    const double binaryNs = MeasureNs(kRounds, [&]() {
+        std::ostringstream out;
+        common_converter::RawLayerPbWriter writer(out, "23618402");
+        writer.WriteLayer(layer, "isa-segment", 0);
+        writer.Close();
+        binary = out.str();
+    });
+    std::istringstream in(binary);
+    common_converter::RawLayerPbReader reader(in);
+    common_converter::RawLayerRecord record;
+    google::protobuf::FileDescriptorProto replayed;
+    const bool roundTrip = reader.Next(record) && replayed.ParseFromString(record.payload) &&
+                           replayed.SerializeAsString() == layer.SerializeAsString();
+    std::cout << "rawdump pb: " << binary.size() << " bytes, " << (roundTrip ? "round trip ok" : "ROUND TRIP FAILED") << std::endl;
+    PrintResult("rawdump json vs pb ns/layer", directNs, binaryNs);
+
+    // 大小不一的多个图层：顺序序列化与线程池并行序列化、按序号写入（CommonDataConverter::convert 的做法）对比
+    std::vector<google::protobuf::FileDescriptorProto> layers;
+    for (int n : {400, 40, 200, 10, 400, 100, 20, 300, 60, 5}) {
+        google::protobuf::FileDescriptorProto l = layer;
+        while (l.message_type_size() > n) l.mutable_message_type()->RemoveLast();
+        layers.push_back(l);
+    }
+    std::string sequential, parallel;
+    const double sequentialNs = MeasureNs(kRounds, [&]() {
+        std::ostringstream out;
+        common_converter::RawLayerWriter writer(out, "23618402", layers.size());
+        for (size_t i = 0; i < layers.size(); ++i) writer.WriteLayer(layers[i], "layer", i);
+        writer.Close();
+        sequential = out.str();
+    });
+    ning::maps::ocm::ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+    const double parallelNs = MeasureNs(kRounds, [&]() {
+        std::vector<std::string> texts(layers.size());
+        std::vector<std::future<bool>> done;
+        for (size_t i = 0; i < layers.size(); ++i) {
+            done.push_back(pool.enqueue([&, i]() { return common_converter::RawLayerWriter::Serialize(layers[i], texts[i]); }));
+        }
+        std::ostringstream out;
+        common_converter::RawLayerWriter writer(out, "23618402", layers.size());
+        for (size_t i = 0; i < layers.size(); ++i) {
+            if (done[i].get()) writer.WriteSerialized(texts[i], "layer", i);
+        }
+        writer.Close();
+        parallel = out.str();
+    });
+    std::cout << "rawdump " << layers.size() << " layers, " << std::thread::hardware_concurrency() << " threads, output "
+              << (parallel == sequential ? "identical" : "DIFFERENT") << std::endl;
+    PrintResult("rawdump ns/tile (parallel layers)", sequentialNs, parallelNs);
+}
+
+// ------------------------- attributes -------------------------
+// 每个 attributes 都转换（原有输出）与按序列化字节缓存（AttributeCache）、文件级字典（attributes:dict）的对比；
+// 用 FieldDescriptorProto 代替 Attributes 消息，取值组合有限，与真实数据中大量重复的情况相同
+
+void WriteSyntheticAttribute(converter::JsonWriter& w, const google::protobuf::FieldDescriptorProto& attr) {
+    using Field = google::protobuf::FieldDescriptorProto;
+    w.BeginObject();
+    w.Field("default_value", attr.default_value());
+    w.Field("json_name", attr.json_name());
+    w.Field("label", Field::Label_Name(attr.label()));
+    w.Field("name", attr.name());
+    w.Field("number", attr.number());
+    w.Field("oneof_index", attr.oneof_index());
+    w.Field("proto3_optional", attr.proto3_optional());
+    w.Field("type", Field::Type_Name(attr.type()));
+    w.EndObject();
+}
+
+void BenchAttributes() {
+    using Field = google::protobuf::FieldDescriptorProto;
+    // 每个 segment 3 个 attributes，共 48 种不同的取值
+    std::vector<std::vector<Field>> segments(20000);
+    uint32_t seed = 7;
+    auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+    for (auto& attributes : segments) {
+        for (int a = 0; a < 3; ++a) {
+            Field attr;
+            const uint32_t v = next() % 48;
+            attr.set_name("FUNCTIONAL_CLASS_" + std::to_string(v % 5 + 1));
+            attr.set_json_name("speed_" + std::to_string(v % 8 * 10));
+            attr.set_default_value(v % 2 ? "urban" : "rural");
+            attr.set_number(static_cast<int>(a * 1000));
+            attr.set_oneof_index(static_cast<int>(v % 3));
+            attr.set_label(Field::LABEL_OPTIONAL);
+            attr.set_type(static_cast<Field::Type>(v % 18 + 1));
+            attr.set_proto3_optional(v % 6 == 0);
+            attributes.push_back(attr);
+        }
+    }
+
+    auto writeSegments = [&](auto writeAttributes) {
+        std::ostringstream os;
+        converter::FeatureCollectionWriter out(os);
+        for (size_t i = 0; i < segments.size(); ++i) {
+            converter::JsonWriter& w = out.BeginFeature();
+            w.BeginObject();
+            w.Key("properties");
+            w.BeginObject();
+            writeAttributes(w, segments[i]);
+            w.Field("local_id", i);
+            w.EndObject();
+            w.Field("type", "Feature");
+            w.EndObject();
+            out.EndFeature();
+        }
+        return os;
+    };
+
+    std::string direct, cached, dictionary;
+    const int kRounds = 5;
+    const double directNs = MeasureNs(kRounds, [&]() {
+        direct = writeSegments([](converter::JsonWriter& w, const std::vector<Field>& attributes) {
+            w.Key("attributes");
+            w.BeginArray();
+            for (const auto& attr : attributes) WriteSyntheticAttribute(w, attr);
+            w.EndArray();
+        }).str();
+    });
+    const double cachedNs = MeasureNs(kRounds, [&]() {
+        converter::AttributeCache cache;
+        cached = writeSegments([&cache](converter::JsonWriter& w, const std::vector<Field>& attributes) {
+            w.Key("attributes");
+            w.BeginArray();
+            for (const auto& attr : attributes) cache.Write(w, attr, WriteSyntheticAttribute);
+            w.EndArray();
+        }).str();
+    });
+    size_t distinct = 0;
+    const double dictionaryNs = MeasureNs(kRounds, [&]() {
+        converter::AttributeDictionary dict;
+        std::ostringstream os = writeSegments([&dict](converter::JsonWriter& w, const std::vector<Field>& attributes) {
+            w.Key("attribute_refs");
+            w.BeginArray();
+            for (const auto& attr : attributes) w.Uint(dict.Index(attr, WriteSyntheticAttribute));
+            w.EndArray();
+        });
+        distinct = dict.size();
+        dictionary = os.str();
+    });
+
+    std::cout << "attributes: " << segments.size() * 3 << " attributes, " << distinct << " distinct, output "
+              << (cached == direct ? "identical" : "DIFFERENT") << ", attributes:dict " << direct.size()
+              << " bytes -> " << dictionary.size() << " bytes (without dictionary)" << std::endl;
+    PrintResult("attributes ns/feature (cache)", directNs / segments.size(), cachedNs / segments.size());
+    PrintResult("attributes ns/feature (dict)", directNs / segments.size(), dictionaryNs / segments.size());
+}
+
+// ------------------------- arena -------------------------
+// 逐瓦片转换：attributes 缓存的条目用 std::string + 默认分配器（原实现）与从 TileArena 分配的对比，
+// 每个瓦片一个新的缓存，瓦片结束时整体释放
+
+namespace legacy {
+
+class AttributeCache {
+public:
+    template <typename Message, typename WriteFn>
+    void Write(converter::JsonWriter& w, const Message& attr, WriteFn write) {
+        attr.SerializeToString(&key_);
+        auto it = entries_.find(key_);
+        if (it == entries_.end()) {
+            converter::JsonWriter fragment(w.indent(), w.depth());
+            write(fragment, attr);
+            it = entries_.emplace(key_, std::move(fragment.buffer())).first;
+        }
+        w.RawValue(it->second);
+    }
+
+private:
+    std::string key_;
+    std::unordered_map<std::string, std::string> entries_;
+};
+
+} // namespace legacy
+
+void BenchArena() {
+    using Field = google::protobuf::FieldDescriptorProto;
+    // 400 个瓦片，每个瓦片 2000 个 attributes，其中约 300 种不同的取值
+    const size_t kTiles = 400;
+    const size_t kAttributesPerTile = 2000;
+    std::vector<Field> attributes(kTiles * kAttributesPerTile);
+    uint32_t seed = 5;
+    for (size_t i = 0; i < attributes.size(); ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        const uint32_t v = (seed >> 8) % 300;
+        Field& attr = attributes[i];
+        attr.set_name("FUNCTIONAL_CLASS_" + std::to_string(v % 5 + 1));
+        attr.set_json_name("speed_" + std::to_string(v % 12 * 10));
+        attr.set_default_value(v % 2 ? "urban" : "rural");
+        attr.set_number(static_cast<int>(i / kAttributesPerTile));   // 不同瓦片的取值不同
+        attr.set_oneof_index(static_cast<int>(v % 5));
+        attr.set_type(static_cast<Field::Type>(v % 18 + 1));
+    }
+
+    auto convertTiles = [&](auto convertTile) {
+        std::string out;
+        converter::JsonWriter w(4, 2);
+        for (size_t t = 0; t < kTiles; ++t) {
+            w.Reset(4, 2);
+            w.BeginArray();
+            convertTile(w, &attributes[t * kAttributesPerTile], kAttributesPerTile);
+            w.EndArray();
+            out += w.buffer();
+        }
+        return out;
+    };
+
+    std::string heap, arena;
+    const int kRounds = 3;
+    const double heapNs = MeasureNs(kRounds, [&]() {
+        heap = convertTiles([](converter::JsonWriter& w, const Field* tile, size_t count) {
+            legacy::AttributeCache cache;
+            for (size_t i = 0; i < count; ++i) cache.Write(w, tile[i], WriteSyntheticAttribute);
+        });
+    });
+    const double arenaNs = MeasureNs(kRounds, [&]() {
+        arena = convertTiles([](converter::JsonWriter& w, const Field* tile, size_t count) {
+            ning::maps::ocm::TileArena::Scope arenaScope;
+            converter::AttributeCache cache;
+            for (size_t i = 0; i < count; ++i) cache.Write(w, tile[i], WriteSyntheticAttribute);
+        });
+    });
+
+    std::cout << "arena: " << kTiles << " tiles x " << kAttributesPerTile << " attributes, output "
+              << (arena == heap ? "identical" : "DIFFERENT") << std::endl;
+    PrintResult("arena ns/tile", heapNs / kTiles, arenaNs / kTiles);
+}
+
+// ------------------------- names -------------------------
+// bitmask / 枚举名称：逐位测试和 X_Name() 与预先生成的名称表（NameTables.hpp）、预先转义的键的对比
+
+void BenchNames() {
+    using Field = google::protobuf::FieldDescriptorProto;
+    static const converter::BitFlag kFlags[] = {
+        {1,  "BOAT_FERRY"}, {2,  "BRIDGE"}, {4,  "MULTIPLY_DIGITIZED"}, {8,  "PAVED"}, {16, "PRIVATE"},
+        {32, "RAIL_FERRY"}, {64, "TUNNEL"}, {128,"DELIVERY_ROAD"}, {256,"MOVABLE_BRIDGE"}
+    };
+    const converter::FlagNameTable flagNames(kFlags);
+    const converter::EnumNameTable typeNames(Field::Type_descriptor());
+    const converter::JsonKey physicalKey("physical");
+    const converter::JsonKey typeKey("type");
+
+    std::vector<std::pair<uint32_t, int>> values(200000);
+    uint32_t seed = 11;
+    for (auto& v : values) {
+        seed = seed * 1664525u + 1013904223u;
+        v = {(seed >> 8) & 0x3FF, static_cast<int>((seed >> 20) % 20)};   // 含超出表的位和未知的枚举值
+    }
+
+    const int kRounds = 5;
+    for (const int indent : {4, -1}) {
+        std::string loop, table;
+        const double loopNs = MeasureNs(kRounds, [&]() {
+            converter::JsonWriter w(indent, 2);
+            w.BeginArray();
+            for (const auto& v : values) {
+                w.BeginObject();
+                w.Key("physical");
+                w.BeginObject();
+                w.Key("active");
+                w.BeginArray();
+                for (const auto& f : kFlags) {
+                    if (v.first & f.bit) w.Value(f.name);
+                }
+                w.EndArray();
+                w.Field("is_empty", v.first == 0);
+                w.Field("raw", v.first);
+                w.EndObject();
+                w.Field("type", Field::Type_Name(static_cast<Field::Type>(v.second)));
+                w.EndObject();
+            }
+            w.EndArray();
+            loop = std::move(w.buffer());
+        });
+        const double tableNs = MeasureNs(kRounds, [&]() {
+            converter::JsonWriter w(indent, 2);
+            w.BeginArray();
+            for (const auto& v : values) {
+                w.BeginObject();
+                w.Key(physicalKey);
+                flagNames.WriteObject(w, v.first);
+                w.Key(typeKey);
+                typeNames.Write(w, v.second);
+                w.EndObject();
+            }
+            w.EndArray();
+            table = std::move(w.buffer());
+        });
+        std::cout << "names: indent " << indent << ", output " << (table == loop ? "identical" : "DIFFERENT") << std::endl;
+        PrintResult(indent < 0 ? "names ns/attribute (stream, compact)" : "names ns/attribute (stream)",
+                    loopNs / values.size(), tableNs / values.size());
+    }
+
+    // convert() 路径：逐位构造 DOM 与复制预先生成的 DOM
+    auto domLoop = [&](uint32_t mask, int type) {
+        json a;
+        json active = json::array();
+        for (const auto& f : kFlags) {
+            if (mask & f.bit) active.push_back(f.name);
+        }
+        a["physical"]["raw"] = mask;
+        a["physical"]["active"] = active;
+        a["physical"]["is_empty"] = (mask == 0);
+        a["type"] = Field::Type_Name(static_cast<Field::Type>(type));
+        return a;
+    };
+    auto domTable = [&](uint32_t mask, int type) {
+        json a;
+        a["physical"] = flagNames.ObjectJson(mask);
+        a["type"] = typeNames.Name(type);
+        return a;
+    };
+    size_t sink = 0;
+    const double domLoopNs = MeasureNs(kRounds, [&]() {
+        for (const auto& v : values) sink += domLoop(v.first, v.second).size();
+    });
+    const double domTableNs = MeasureNs(kRounds, [&]() {
+        for (const auto& v : values) sink += domTable(v.first, v.second).size();
+    });
+
+    bool domSame = sink != 0;
+    for (uint32_t mask = 0; mask < 0x400; ++mask) {
+        for (int type = -2; type < 24; ++type) {
+            domSame = domSame && domTable(mask, type) == domLoop(mask, type);
+        }
+    }
+    std::cout << "names: " << values.size() << " bitmask + enum values, DOM "
+              << (domSame ? "identical" : "DIFFERENT") << std::endl;
+    PrintResult("names ns/attribute (DOM)", domLoopNs / values.size(), domTableNs / values.size());
+}
+
+int main(int argc, char* argv[]) {
+    const std::string which = argc > 1 ? argv[1] : "all";
+    if (which == "all" || which == "filter") BenchFilter();
+    if (which == "all" || which == "serializer") BenchSerializer();
+    if (which == "all" || which == "decode") BenchDecode();
+    if (which == "all" || which == "precision") BenchPrecision();
+    if (which == "all" || which == "encoding") BenchEncoding();
+    if (which == "all" || which == "simplify") BenchSimplify();
+    if (which == "all" || which == "tileid") BenchTileId();
+    if (which == "all" || which == "timedomain") BenchTimeDomain();
+    if (which == "all" || which == "rawdump") BenchRawDump();
+    if (which == "all" || which == "attributes") BenchAttributes();
+    if (which == "all" || which == "arena") BenchArena();
+    if (which == "all" || which == "names") BenchNames();
+    return 0;
+}
@@ -4,10 +4,24 @@
 #include "ISADataToGeoJsonConverter.hpp"
 #include "RoutingDataToGeoJsonConverter.hpp"
 #include "CommonDataConverter.hpp"
+#include "RawLayerWriter.hpp"
 #include "FileUtils.hpp"
+#include "FeatureFilter.hpp"
+#include "TileScheduler.hpp"
+#include "GeoJsonWriter.hpp"
+#include "AttributeCache.hpp"
+#include "CoordinateDecoder.hpp"
+#include "GeometryEncoding.hpp"
+#include "LineSimplifier.hpp"
+#include "SegmentDedup.hpp"
+#include "SegmentStitcher.hpp"
+#include "TimeDomainParser.hpp"
+#include "ThreadPool.hpp"
 #include <fstream>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -148,271 +162,62 @@ auto processBBox(string layerGroup, double lon1, double lat1, double lon2, doubl
 
 
 
-struct Condition {
-    std::string key;
-    std::string op;
-    std::string value;
-};
-
-enum class NodeType { AND, OR, CONDITION };
-
-struct Node {
-    NodeType type;
-    std::vector<Node> children;  // 对于 AND/OR
-    Condition cond;              // 对于叶子条件
-};
-
-inline std::string trim(const std::string& s) {
-    size_t start = s.find_first_not_of(" \t\n\r");
-    size_t end = s.find_last_not_of(" \t\n\r");
-    return (start == std::string::npos) ? "" : s.substr(start, end - start + 1);
-}
-
-Condition parseCondition(const std::string& s) {
-    static const std::vector<std::string> ops = { ">=", "<=", "=", ">", "<" };
-    for (const auto& op : ops) {
-        size_t pos = s.find(op);
-        if (pos != std::string::npos) {
-            return { trim(s.substr(0,pos)), op, trim(s.substr(pos+op.size())) };
-        }
-    }
-    throw std::runtime_error("Invalid condition: " + s);
-}
-
-Node parseExpression(const std::string& s) {
-    std::string expr = trim(s);
-
-    if (expr.empty()) throw std::runtime_error("Empty expression");
-
-    // AND(...) 或 OR(...)
-    if (expr.substr(0, 4) == "AND(" && expr.back() == ')') {
-        Node node{ NodeType::AND };
-        std::string inner = expr.substr(4, expr.size()-5);
-        std::stringstream ss(inner);
-        std::string token;
-        int paren = 0;
-        std::string buf;
-        for (char c : inner) {
-            if (c=='(') paren++;
-            if (c==')') paren--;
-            if ((c==',' || c==';') && paren==0) {
-                if (!buf.empty()) node.children.push_back(parseExpression(buf));
-                buf.clear();
-            } else buf += c;
-        }
-        if (!buf.empty()) node.children.push_back(parseExpression(buf));
-        return node;
-    } 
-    else if (expr.substr(0,3)=="OR(" && expr.back()==')') {
-        Node node{ NodeType::OR };
-        std::string inner = expr.substr(3, expr.size()-4);
-        std::stringstream ss(inner);
-        std::string token;
-        int paren=0;
-        std::string buf;
-        for (char c:inner){
-            if(c=='(') paren++;
-            if(c==')') paren--;
-            if((c==','||c==';') && paren==0){
-                if(!buf.empty()) node.children.push_back(parseExpression(buf));
-                buf.clear();
-            } else buf += c;
+// DOM 兜底路径：按 filter 逻辑过滤后追加到 FeatureCollection
+void appendFeaturesToGeoJSON(converter::FeatureCollectionWriter& out,
+                             const json& newFeatures,
+                             const feature_filter::CompiledFilter& filter)
+{
+    for (const auto& feature : newFeatures["features"]) {
+        if (filter.Match(feature)) {
+            out.AppendFeature(feature);
         }
-        if(!buf.empty()) node.children.push_back(parseExpression(buf));
-        return node;
-    } 
-    else {
-        // 单个条件
-        Node node{ NodeType::CONDITION };
-        node.cond = parseCondition(expr);
-        return node;
-    }
-}
-
-json nodeToJson(const Node& node) {
-    if (node.type == NodeType::CONDITION) {
-        return json{{"key", node.cond.key}, {"op", node.cond.op}, {"value", node.cond.value}};
-    } else {
-        json j;
-        j[node.type == NodeType::AND ? "and" : "or"] = json::array();
-        for (const auto& child : node.children)
-            j[node.type == NodeType::AND ? "and" : "or"].push_back(nodeToJson(child));
-        return j;
     }
 }
 
-
-static bool compareValues(const json& featureValue, const std::string& op, const json& filterValue) {
-    if (op == "=") {
-        double fv, val;
-        bool fvIsNum = false, valIsNum = false;
-
-        if (featureValue.is_number()) { fv = featureValue.get<double>(); fvIsNum = true; }
-        else if (featureValue.is_string()) { try { fv = std::stod(featureValue.get<std::string>()); fvIsNum = true; } catch (...) {} }
-
-        if (filterValue.is_number()) { val = filterValue.get<double>(); valIsNum = true; }
-        else if (filterValue.is_string()) { try { val = std::stod(filterValue.get<std::string>()); valIsNum = true; } catch (...) {} }
-
-        if (fvIsNum && valIsNum) return fv == val;
-
-        // ---- 忽略大小写的字符串比较 ----
-        if (featureValue.is_string() && filterValue.is_string()) {
-            std::string fvStr = featureValue.get<std::string>();
-            std::string valStr = filterValue.get<std::string>();
-
-            auto toLower = [](std::string& s) {
-                std::transform(s.begin(), s.end(), s.begin(),
-                               [](unsigned char c){ return std::tolower(c); });
-            };
-
-            toLower(fvStr);
-            toLower(valStr);
-
-            return fvStr == valStr;
-        }
-
-        // 兜底
-        return featureValue.dump() == filterValue.dump();
+// 转换一个瓦片并写入 out：优先直接流式输出，filter 无法下推时构造 JSON 后在输出端过滤
+template <typename Converter>
+void writeTileFeatures(Converter& converter,
+                       const datastore::Response<datastore::TileLoadResult>& load_response,
+                       const olp::geo::TileKey& tileKey,
+                       const std::string& outpath,
+                       const converter::ConvertOptions& options,
+                       const feature_filter::CompiledFilter& filter,
+                       converter::FeatureCollectionWriter& out)
+{
+    if (!converter.stream(load_response, tileKey, options, out)) {
+        json feature_collection = converter.convert(load_response, tileKey, outpath, options);
+        appendFeaturesToGeoJSON(out, feature_collection, filter);
     }
-
-    // 其他比较符要求数字
-    double fv, val;
-    try {
-        fv = featureValue.is_number() ? featureValue.get<double>() : std::stod(featureValue.get<std::string>());
-        val = filterValue.is_number() ? filterValue.get<double>() : std::stod(filterValue.get<std::string>());
-    } catch (...) { return false; }
-
-    if (op == ">") return fv > val;
-    if (op == "<") return fv < val;
-    if (op == ">=") return fv >= val;
-    if (op == "<=") return fv <= val;
-
-    return false;
+    out.CommitTile();
 }
 
-static bool matchCondition(const json& feature, const json& cond) {
-    if (!cond.contains("key") || !cond.contains("op") || !cond.contains("value")) {
-        return false;
-    }
-
-    std::string key = cond["key"].get<std::string>();
-    std::string op  = cond["op"].get<std::string>();
-    const json& val = cond["value"];
-
-    // 在 properties 里找
-    if (feature.contains("properties") && feature["properties"].contains(key)) {
-        if (compareValues(feature["properties"][key], op, val)) {
-            return true;
-        }
-    }
-
-    // 在 attributes 数组里找
-    if (feature.contains("properties") &&
-        feature["properties"].contains("attributes") &&
-        feature["properties"]["attributes"].is_array())
-    {
-        for (auto& attr : feature["properties"]["attributes"]) {
-            if (attr.contains(key)) {
-                if (compareValues(attr[key], op, val)) {
-                    return true;
-                }
-            }
-        }
-    }
-
-    return false;
+// 写入 attributes:dict 的文件级字典后关闭输出文件
+void closeGeoJson(converter::FeatureCollectionWriter& out, const converter::AttributeDictionary* dictionary)
+{
+    if (dictionary) out.AddMember("attribute_dictionary", dictionary->Serialize());
+    out.Close();
 }
 
-bool matchFeature(const json& feature, const json& filter) {
-    // filter 是数组
-    if (!filter.is_array()) {
-        return false;
-    }
-
-    // 每个元素是一个 and/or 逻辑对象
-    for (auto& logicGroup : filter) {
-        if (logicGroup.contains("and")) {
-            bool allMatch = true;
-            for (auto& cond : logicGroup["and"]) {
-                if (!matchCondition(feature, cond)) {
-                    allMatch = false;
-                    break;
-                }
-            }
-            if (!allMatch) return false; // and 组里有一个不满足，整个失败
-        }
-        else if (logicGroup.contains("or")) {
-            bool anyMatch = false;
-            for (auto& cond : logicGroup["or"]) {
-                if (matchCondition(feature, cond)) {
-                    anyMatch = true;
-                    break;
-                }
-            }
-            if (!anyMatch) return false; // or 组里全不满足，整个失败
-        }
-    }
-
-    return true;
-}
-void appendFeaturesToGeoJSON(const std::string& outpath, 
-                             const json& newFeatures, 
-                             bool firstTile,
-                             const json& filter) 
+// raw: 原始图层导出，文件名按瓦片区分：<here tile>-<layer group>.json / .pb
+void writeRawDump(const datastore::Response<datastore::TileLoadResult>& load_response,
+                  const olp::geo::TileKey& tileKey,
+                  const std::string& layerGroupName,
+                  common_converter::RawDumpFormat format,
+                  ning::maps::ocm::ThreadPool* pool)
 {
-    json geoJson;
+    if (format == common_converter::RawDumpFormat::kNone) return;
 
-    // 第一次写入：新建 FeatureCollection
-    if (firstTile) {
-        geoJson["type"] = "FeatureCollection";
-        geoJson["features"] = json::array();
+    std::string fileName = tileKey.ToHereTile() + "-" + layerGroupName + common_converter::RawDumpExtension(format);
+    std::string outpath = getRawDataFilePath(fileName);
+    if (format == common_converter::RawDumpFormat::kProtobuf) {
+        commonConverter.convertToProtobuf(load_response, tileKey, outpath);
     } else {
-        // 读取已有文件
-        std::ifstream inFile(outpath);
-        if (!inFile.is_open()) {
-            throw std::runtime_error("Failed to open existing GeoJSON file: " + outpath);
-        }
-
-        try {
-            inFile >> geoJson;
-        } catch (const std::exception& e) {
-            throw std::runtime_error(std::string("Failed to parse existing GeoJSON: ") + e.what());
-        }
-
-        if (!geoJson.contains("features") || !geoJson["features"].is_array()) {
-            throw std::runtime_error("Existing GeoJSON does not contain a valid 'features' array");
-        }
-    }
-
-    // 遍历新 features，并按 filter 逻辑过滤
-    for (const auto& feature : newFeatures["features"]) {
-        if (matchFeature(feature, filter)) {
-        geoJson["features"].push_back(feature);
-        }
-    }
-
-
-    // 写回文件
-    std::ofstream outFile(outpath, std::ios::out | std::ios::trunc);
-    if (!outFile.is_open()) {
-        throw std::runtime_error("Failed to open GeoJSON file for writing: " + outpath);
-    }
-
-    outFile << geoJson.dump(4);
-    if (!outFile.good()) {
-        throw std::runtime_error("Failed to write GeoJSON to file: " + outpath);
+        commonConverter.convert(load_response, tileKey, outpath, pool);
     }
+    OLP_SDK_LOG_INFO_F(kLogTag, "瓦片数据成功写入 %s", outpath.c_str());
 }
 
-
-bool exceedFileLimit(const std::string& filename, std::size_t MB) {
-    std::ifstream in(filename, std::ifstream::ate | std::ifstream::binary);
-    if (!in.is_open()) {
-        return false; // 文件不存在或无法打开，不算超限
-    }
-    std::size_t filesize = static_cast<std::size_t>(in.tellg());
-    return filesize > MB * 1024 * 1024;
-}
+constexpr uint64_t kGeoJsonFileLimit = 50ull * 1024 * 1024; // 50MB
 
 void calculateRoadLength()
 {
@@ -459,6 +264,8 @@ int main(int argc, char* argv[]) {
     //Examples
     //1. ocm-loader lg:isa point:13.08836,52.33812 tile:377893287 version:188
     //2. ocm-loader lg:rendering bbox:13.08836,52.33812,13.761,52.6755 version:180 filter:AND(forward_speed_limit=30)
+    //   order:morton  按 Morton 顺序加载瓦片；order:center  由 bbox 中心向外加载
+    //4. ocm-loader lg:isa point:13.08836,52.33812 prefetch:on heading:90,15
     //3. ocm-loader tile:377893287 version:188
     //Default parameter, when command line parameter is not enough
     //    //std::string filterStr = "AND(functional_class=functional_class_1)";
@@ -503,6 +310,20 @@ int main(int argc, char* argv[]) {
     string point = "13.08836,52.33812";
     string bbox = "13.08836,52.33812,13.761,52.6755";
     string filterStr = "";
+    string fieldsStr = "";
+    bool rawEnums = false;
+    utils::ClipMode clipMode = utils::ClipMode::kNone;
+    int coordinatePrecision = -1;
+    utils::GeometryEncoding geometryEncoding = utils::GeometryEncoding::kGeoJson;
+    utils::SimplifyTolerance simplifyTolerance;
+    string validAtStr = "";
+    common_converter::RawDumpFormat rawFormat = common_converter::RawDumpFormat::kNone;
+    ning::maps::ocm::TileOrder tileOrder = ning::maps::ocm::TileOrder::kDefault;
+    bool prefetchNeighbors = false;
+    bool dedupSegments = true;
+    bool stitchSegments = false;
+    converter::AttributeOutput attributeOutput = converter::AttributeOutput::kInline;
+    ning::maps::ocm::PrefetchHint prefetchHint;
 
     map<string, string> params;
 
@@ -521,55 +342,184 @@ int main(int argc, char* argv[]) {
         cout << "key: " << item.first << ", value: " << item.second << endl;
     }
     
-    if(params.find("lg") != params.end())
-    {
-        layerGroupName = params["lg"];
+    // 选项的取值非法（如 order:mortn、valid_at:2024-02-30）时报错退出，而不是在加载途中终止
+    utils::ClipArea clipArea;
+    bool hasClipArea = false;
+    std::unique_ptr<TimeDomainParser::ValidityFilter> validAt;
+    feature_filter::CompiledFilter finalFilter;
+    vector<double> pointCoords;
+    vector<double> bboxCoords;
+    try {
+        if(params.find("lg") != params.end())
+        {
+            layerGroupName = params["lg"];
+
+            if (params.find("version") != params.end()) {
+                catalogVersion = atoi(params["version"].c_str());
+            }
+            cout << "CatalogVersion = " << catalogVersion << endl;
+
+            if (params.find("filter") != params.end()) {
+                filterStr = params["filter"];
+            }
+
+            // fields:字段1,字段2 只输出指定字段；enums:raw 枚举和 bitmask 输出整数
+            if (params.find("fields") != params.end()) {
+                fieldsStr = params["fields"];
+            }
+            if (params.find("enums") != params.end()) {
+                rawEnums = (params["enums"] == "raw");
+            }
+
+            // clip:drop 丢弃区域外的要素，clip:cut 同时裁剪跨越边界的线；区域为 bbox: 或 polygon:
+            if (params.find("clip") != params.end()) {
+                clipMode = utils::ParseClipMode(params["clip"]);
+            }
+
+            // precision:7 坐标保留 7 位小数（约 1 cm），默认按 double 最短往返表示输出
+            if (params.find("precision") != params.end()) {
+                coordinatePrecision = utils::ParseCoordinatePrecision(params["precision"]);
+            }
+
+            // geometry:flexpolyline / geometry:delta64 几何输出为编码字符串（直接由整数坐标编码），默认 geojson
+            if (params.find("geometry") != params.end()) {
+                geometryEncoding = utils::ParseGeometryEncoding(params["geometry"]);
+            }
+
+            // simplify:5（米）/ simplify:z10（10 级显示时一个像素）输出前简化几何，保留 segment 端点
+            if (params.find("simplify") != params.end()) {
+                simplifyTolerance = utils::ParseSimplifyTolerance(params["simplify"]);
+            }
+
+            // valid_at:2024-05-01T08:30 只保留该时刻（道路所在地本地时间）生效的限速、通行限制和收费条目
+            if (params.find("valid_at") != params.end()) {
+                validAtStr = params["valid_at"];
+            }
+
+            // raw:json / raw:pb 额外导出瓦片的原始图层数据（pb 为 protobuf 原始字节，可回放），默认不导出
+            if (params.find("raw") != params.end()) {
+                rawFormat = common_converter::ParseRawDumpFormat(params["raw"]);
+            }
+
+            if (params.find("order") != params.end()) {
+                tileOrder = ning::maps::ocm::ParseTileOrder(params["order"]);
+            }
+
+            // dedup:off 关闭 bbox 导出的跨瓦片 foreign segment 去重（默认开启）
+            if (params.find("dedup") != params.end()) {
+                dedupSegments = (params["dedup"] != "off");
+            }
+
+            // stitch:on 把 bbox 导出中同一 segment 在各瓦片的片段合并为一条 LineString（默认关闭，未指定 order: 时按 Morton 顺序加载）
+            if (params.find("stitch") != params.end()) {
+                stitchSegments = (params["stitch"] == "on");
+                if (stitchSegments && params.find("order") == params.end()) {
+                    tileOrder = ning::maps::ocm::TileOrder::kMorton;
+                }
+            }
+
+            // attributes:dict 相同的 attributes 只在文件末尾的 attribute_dictionary 中写一次，要素中输出下标 attribute_refs
+            if (params.find("attributes") != params.end()) {
+                attributeOutput = converter::ParseAttributeOutput(params["attributes"]);
+            }
+
+            // prefetch:on 返回瓦片后在后台预热相邻瓦片（只用于 point:/tile:）；heading:方向角,速度(m/s) 时只预取前方瓦片
+            if (params.find("prefetch") != params.end()) {
+                prefetchNeighbors = (params["prefetch"] != "off");
+            }
+            if (params.find("heading") != params.end()) {
+                vector<double> heading = parseCoordinates(params["heading"]);
+                if (!heading.empty()) {
+                    prefetchHint.has_heading = true;
+                    prefetchHint.heading_deg = heading[0];
+                    prefetchHint.speed_mps = heading.size() > 1 ? heading[1] : 0.0;
+                }
+            }
 
-        if (params.find("version") != params.end()) {
-            catalogVersion = atoi(params["version"].c_str());
         }
-        cout << "CatalogVersion = " << catalogVersion << endl;
 
-        if (params.find("filter") != params.end()) {
-            filterStr = params["filter"];
+        // point: / bbox: 的坐标也在这里解析，非法数值（stod 的异常）统一报错
+        if (params.find("point") != params.end()) {
+            pointCoords = parseCoordinates(params["point"]);
+        }
+        if (params.find("bbox") != params.end()) {
+            bboxCoords = parseCoordinates(params["bbox"]);
         }
 
-    }
+        // polygon:lng,lat,lng,lat,... 优先于 bbox: 作为裁剪区域
+        if (params.find("polygon") != params.end()) {
+            clipArea = utils::ClipArea::FromPolygon(parseCoordinates(params["polygon"]));
+            hasClipArea = true;
+        } else if (bboxCoords.size() == 4) {
+            clipArea = utils::ClipArea::FromBBox(bboxCoords[0], bboxCoords[1], bboxCoords[2], bboxCoords[3]);
+            hasClipArea = true;
+        }
+        if (clipMode != utils::ClipMode::kNone && !hasClipArea) {
+            throw std::invalid_argument("clip: requires bbox: or polygon:");
+        }
+
+        if (!validAtStr.empty()) {
+            validAt.reset(new TimeDomainParser::ValidityFilter(TimeDomainParser::ParseTimestamp(validAtStr)));
+        }
 
+        // 解析并编译 filter（顶层按 ; 分割的各组为 AND 关系）
+        finalFilter = feature_filter::CompiledFilter::Compile(filterStr);
+    } catch (const std::exception& e) {
+        // 除 ParseXxx 的 invalid_argument 外还有 filter 的 runtime_error、坐标 stod 的 out_of_range
+        printError(e.what());
+        return 1;
+    }
 
-    // 按 ; 分割顶层 AND / OR
-    std::stringstream ss(filterStr);
-    std::string part;
-    json finalJson = json::array();
+    // filter 引用的字段并入投影，保证输出端过滤仍能取到条件字段
+    converter::FieldMask fieldMask = converter::FieldMask::Parse(fieldsStr);
+    fieldMask.AddFilterKeys(finalFilter);
 
+    converter::ConvertOptions convertOptions;
+    convertOptions.filter = &finalFilter;
+    convertOptions.fields = &fieldMask;
+    convertOptions.raw_enums = rawEnums;
+    convertOptions.clip_area = hasClipArea ? &clipArea : nullptr;
+    convertOptions.clip_mode = clipMode;
+    convertOptions.coordinate_precision = coordinatePrecision;
+    convertOptions.geometry_encoding = geometryEncoding;
+    convertOptions.simplify = simplifyTolerance;
+    convertOptions.valid_at = validAt.get();
 
-     
-  
+    // 单个瓦片内的 segment 分块并行转换（point:/tile: 只有一个瓦片时也能用上所有核）
+    std::unique_ptr<ning::maps::ocm::ThreadPool> convertPool;
+    if (std::thread::hardware_concurrency() > 1) {
+        convertPool.reset(new ning::maps::ocm::ThreadPool(std::thread::hardware_concurrency()));
+    }
+    convertOptions.pool = convertPool.get();
 
-    while (std::getline(ss, part, ';')) {
-        if (part.empty()) continue;
-        Node n = parseExpression(part);
-        finalJson.push_back(nodeToJson(n));
+    // 每次运行只写一个输出文件，字典在整个文件的各瓦片之间共享
+    std::unique_ptr<converter::AttributeDictionary> attributeDictionary;
+    if (attributeOutput == converter::AttributeOutput::kDictionary) {
+        attributeDictionary.reset(new converter::AttributeDictionary());
     }
+    convertOptions.attribute_dictionary = attributeDictionary.get();
 
 
     if (params.find("point") != params.end() ){
-        string coordPart = params["point"]; 
-        vector<double> coords = parseCoordinates(coordPart);
+        const vector<double>& coords = pointCoords;
         if (coords.size() == 2) {
            kTileKey =  processPoint(layerGroupName, coords[0], coords[1]);
         }
     } else if (params.find("bbox") != params.end()) {
-        string coordPart = params["bbox"];
-        vector<double> coords;
-        stringstream ss(coordPart);
-        string token;
-        while (getline(ss, token, ',')) {
-            coords.push_back(stod(token));
-        }
+        const vector<double>& coords = bboxCoords;
         if (coords.size() == 4) {
             tileKeys = processBBox(layerGroupName, coords[0], coords[1], coords[2], coords[3]);
+            // 按 order: 策略调整加载顺序（默认保持原顺序）
+            auto center = olp::geo::GeoCoordinates::FromDegrees((coords[1] + coords[3]) / 2,
+                                                                (coords[0] + coords[2]) / 2);
+            ning::maps::ocm::ScheduleTileKeys(tileKeys, tileOrder, center);
         }
+    } else if (hasClipArea && clipArea.is_polygon()) {
+        // 只给了 polygon: 时加载其外接矩形覆盖的瓦片
+        tileKeys = processBBox(layerGroupName, clipArea.min_lng(), clipArea.min_lat(), clipArea.max_lng(), clipArea.max_lat());
+        auto center = olp::geo::GeoCoordinates::FromDegrees((clipArea.min_lat() + clipArea.max_lat()) / 2,
+                                                            (clipArea.min_lng() + clipArea.max_lng()) / 2);
+        ning::maps::ocm::ScheduleTileKeys(tileKeys, tileOrder, center);
     } else if (params.find("tile") != params.end()) 
     {
          string tileId = params["tile"];
@@ -592,6 +542,7 @@ int main(int argc, char* argv[]) {
     settings.path_to_credentials_file = kPathToCredentialsFile;
     settings.access_key_secret = kHereAccessKeySecret; // 替换为您的访问密钥 Secret
     settings.cache_folder = getDiskCachePath();
+    settings.prefetch_neighbors = prefetchNeighbors;
 
       // ------------------------------
     // 步骤 2：创建地图引擎实例
@@ -665,8 +616,41 @@ int main(int argc, char* argv[]) {
     {
           cout << "Total Tile size : " << tileKeys.size() << endl;
 
-          bool first = true; // 标记是否是第一个 TileKey
           int tileLoaded = 0;
+
+          // 整个 bbox 的要素写入同一个文件，只打开一次
+          std::unique_ptr<converter::FeatureCollectionWriter> geoJsonOut;
+          if ("isa" == layerGroupName) {
+              geoJsonOut.reset(new converter::FeatureCollectionWriter(getGeoDataFilePath("isa.geojson")));
+          } else if ("rendering" == layerGroupName) {
+              geoJsonOut.reset(new converter::FeatureCollectionWriter(getGeoDataFilePath("data.geojson")));
+          }
+
+          // 跨越瓦片边界的 segment 在相邻瓦片中作为 foreign segment 重复出现，每条只输出一次
+          // stitch:on 时流式路径的重复片段由拼接器处理；filter 无法下推而改走 convert() 时不经过拼接器，仍按 foreign segment 去重
+          std::unique_ptr<converter::SegmentDedup> dedup;
+          const bool stitch = stitchSegments && "isa" == layerGroupName;
+          // 只有 ISA 转换器处理 foreign segment，其它图层组不创建（也不输出统计）
+          if (dedupSegments && "isa" == layerGroupName) {
+              std::vector<uint64_t> tileIds;
+              tileIds.reserve(tileKeys.size());
+              for (const auto& key : tileKeys) {
+                  tileIds.push_back(TileIDConverter::XYtoTileId(key.Column(), key.Row(), key.Level()));
+              }
+              dedup.reset(new converter::SegmentDedup(tileIds, geoJsonOut->indent()));
+          }
+          convertOptions.dedup = dedup.get();
+
+          std::unique_ptr<converter::SegmentStitcher> stitcher;
+          if (stitch) {
+              stitcher.reset(new converter::SegmentStitcher(tileKeys, convertOptions.coordinate_precision,
+                                                            convertOptions.geometry_encoding, geoJsonOut->indent()));
+          }
+          convertOptions.stitcher = stitcher.get();
+
+          // 要加载的瓦片已全部在 tileKeys 中，相邻瓦片的预取大多重复或落在 bbox 外，这里关闭
+          ning::maps::ocm::PrefetchHint bboxPrefetchHint;
+          bboxPrefetchHint.enabled = false;
       for(olp::geo::TileKey tileKey : tileKeys)
       {
           try{
@@ -678,15 +662,20 @@ int main(int argc, char* argv[]) {
                 OLP_SDK_LOG_INFO_F(kLogTag, "开始获取瓦片数据...");
 
                 const datastore::Response<datastore::TileLoadResult> load_response =
-                    engine.FetchTileAsync(tileKey, layers);
+                    engine.FetchTileAsync(tileKey, layers, bboxPrefetchHint);
 
                 if ("isa" == layerGroupName)
                 {
                     std::string outpath =  getGeoDataFilePath("isa.geojson");
-                    json feature_collection = isaConverter.convert(load_response, tileKey, outpath);
-                     appendFeaturesToGeoJSON(outpath, feature_collection, first, finalJson);
+                    writeTileFeatures(isaConverter, load_response, tileKey, outpath, convertOptions, finalFilter, *geoJsonOut);
+                    if (dedup) dedup->CommitTile(TileIDConverter::XYtoTileId(tileKey.Column(), tileKey.Row(), tileKey.Level()));
+                    if (stitcher) {
+                        // 写出已不会再有新片段的 segment
+                        stitcher->FinishTile(tileKey, *geoJsonOut);
+                        geoJsonOut->CommitTile();
+                    }
 
-                    if (exceedFileLimit(outpath, 50)) { // 50MB
+                    if (geoJsonOut->bytes_written() > kGeoJsonFileLimit) {
                         std::cout << "文件超过 50MB，停止写入\n";
                         break;
                     }
@@ -695,10 +684,9 @@ int main(int argc, char* argv[]) {
                 else if ("rendering" == layerGroupName)
                 {
                      std::string outpath =  getGeoDataFilePath("data.geojson");
-                    json feature_collection = renderingConverter.convert(load_response, tileKey, outpath);
-                     appendFeaturesToGeoJSON(outpath, feature_collection, first, finalJson);
+                    writeTileFeatures(renderingConverter, load_response, tileKey, outpath, convertOptions, finalFilter, *geoJsonOut);
 
-                    if (exceedFileLimit(outpath, 50)) { // 50MB
+                    if (geoJsonOut->bytes_written() > kGeoJsonFileLimit) {
                         std::cout << "文件超过 50MB，停止写入\n";
                         break;
                     }
@@ -707,22 +695,47 @@ int main(int argc, char* argv[]) {
                 }
 
 
-                first = false; // 后续写都走追加
                 tileLoaded ++;
 
-
-                 //Write raw json data into file
-            std::string  fileName = kTileKey.ToHereTile() +"-"+ layerGroupName+ ".json";
-            std::string outpath =  getRawDataFilePath(fileName);
-            commonConverter.convert(load_response, kTileKey, outpath);
-             OLP_SDK_LOG_INFO_F(kLogTag, "瓦片数据成功写入 %s", outpath.c_str());
+                // 瓦片已提交，原始图层导出失败不能回滚已写出的要素和去重/拼接状态
+                try {
+                    writeRawDump(load_response, tileKey, layerGroupName, rawFormat, convertOptions.pool);
+                } catch (const std::exception& e) {
+                    OLP_SDK_LOG_INFO_F(kLogTag, "Error in raw dump: %s", e.what());
+                }
 
             }catch(...)
             {
+                  // 丢弃该瓦片已写入缓冲区的要素，保持输出文件完整
+                  if (geoJsonOut) geoJsonOut->RollbackTile();
+                  if (stitcher) {
+                      // 失败的瓦片也要标记为已处理，否则与它相邻的折线要等到 Close() 才写出
+                      stitcher->DiscardTile();
+                      stitcher->FinishTile(tileKey, *geoJsonOut);
+                      geoJsonOut->CommitTile();
+                  }
+                  if (dedup) dedup->RollbackTile();
                   OLP_SDK_LOG_INFO_F(kLogTag, "Error in load tile.");
             }
             
       }
+      if (stitcher) {
+          // 提前停止或加载失败的瓦片上仍在等待的 segment
+          stitcher->Close(*geoJsonOut);
+          geoJsonOut->CommitTile();
+          cout << "Stitched " << stitcher->fragments() << " segment fragments into " << stitcher->features_written()
+               << " features (" << stitcher->duplicates() << " duplicates dropped)" << endl;
+      }
+      if (dedup) {
+          // host 瓦片加载失败或提前停止时，补写暂存的 foreign 副本
+          dedup->Close(*geoJsonOut);
+          geoJsonOut->CommitTile();
+          cout << "Skipped duplicate foreign segments: " << dedup->skipped()
+               << " (recovered " << dedup->recovered() << " from unloaded host tiles)" << endl;
+      }
+      if (geoJsonOut) closeGeoJson(*geoJsonOut, attributeDictionary.get());
+      convertOptions.dedup = nullptr;
+      convertOptions.stitcher = nullptr;
 
       calculateRoadLength();
 
@@ -731,12 +744,13 @@ int main(int argc, char* argv[]) {
         printTileRequestInfo(kTileKey);
         OLP_SDK_LOG_INFO_F(kLogTag, "待加载图层 - %s", joinLayerNames(layers).c_str());
         OLP_SDK_LOG_INFO_F(kLogTag, "开始获取瓦片数据...");
-        const datastore::Response< datastore::TileLoadResult > load_response = engine.FetchTileAsync(kTileKey, layers);
+        const datastore::Response< datastore::TileLoadResult > load_response = engine.FetchTileAsync(kTileKey, layers, prefetchHint);
         if("isa" == layerGroupName)
         {
             std::string outpath =  getGeoDataFilePath("isa.geojson");
-            json feature_collection = isaConverter.convert(load_response, kTileKey, outpath);
-             appendFeaturesToGeoJSON(outpath, feature_collection, true, finalJson);
+            converter::FeatureCollectionWriter geoJsonOut(outpath);
+            writeTileFeatures(isaConverter, load_response, kTileKey, outpath, convertOptions, finalFilter, geoJsonOut);
+            closeGeoJson(geoJsonOut, attributeDictionary.get());
             OLP_SDK_LOG_INFO_F(kLogTag, "瓦片数据成功写入 %s", outpath.c_str());
             // writeGeoJsonFeatures(outpath, feature_collection, true);
             // finalizeGeoJsonFile(outpath);
@@ -744,17 +758,13 @@ int main(int argc, char* argv[]) {
         else if("rendering" == layerGroupName)
         {
              std::string outpath =  getGeoDataFilePath("data.geojson");
-            json feature_collection = renderingConverter.convert(load_response, kTileKey, outpath);
-             appendFeaturesToGeoJSON(outpath, feature_collection, true, finalJson);
+            converter::FeatureCollectionWriter geoJsonOut(outpath);
+            writeTileFeatures(renderingConverter, load_response, kTileKey, outpath, convertOptions, finalFilter, geoJsonOut);
+            closeGeoJson(geoJsonOut, attributeDictionary.get());
             OLP_SDK_LOG_INFO_F(kLogTag, "瓦片数据成功写入 %s", outpath.c_str());
         }
         
-        //Write raw json data into file
-            std::string  fileName = kTileKey.ToHereTile() +"-"+ layerGroupName+ ".json";
-            std::string outpath =  getRawDataFilePath(fileName);
-            commonConverter.convert(load_response, kTileKey, outpath);
-             OLP_SDK_LOG_INFO_F(kLogTag, "瓦片数据成功写入 %s", outpath.c_str());
-        
+        writeRawDump(load_response, kTileKey, layerGroupName, rawFormat, convertOptions.pool);
     }
 
      cout << "Filter string: " << filterStr << endl;
@@ -7,10 +7,14 @@
 #include <olp/clientmap/datastore/DataStoreServerBuilder.h>
 #include <olp/authentication/TokenProvider.h>
 #include <olp/core/logging/Log.h>
+#include <algorithm>
 #include <atomic>
+#include <cmath>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <stdexcept>
+#include <unordered_map>
 
 using namespace std;
 using namespace olp;
@@ -20,13 +24,92 @@ namespace ning {
 namespace maps {
 namespace ocm {
 
+namespace {
+
+constexpr auto kLogTag = "OcmMapEngineImpl";
+
+// 预取前方瓦片时覆盖的时间窗口（秒）
+constexpr double kPrefetchHorizonSeconds = 60.0;
+constexpr int kMaxPrefetchStepsAhead = 4;
+
+std::string MakeCacheKey(const geo::TileKey& tileKey, const TileRequest::Layers& layers) {
+    std::string key = tileKey.ToHereTile();
+    for (const auto& layer : layers) {
+        key += '|';
+        key += layer;
+    }
+    return key;
+}
+
+// 同一 level 下按 (行, 列) 偏移取相邻瓦片，列方向在经度 180° 处回绕；行越过两极时返回无效的 TileKey
+geo::TileKey NeighborTile(const geo::TileKey& tileKey, int64_t dRow, int64_t dColumn) {
+    // 行、列号都在 [0, 1 << level) 内：列取模回绕，行超出时无效
+    const int64_t limit = int64_t(1) << tileKey.Level();
+    const int64_t row = static_cast<int64_t>(tileKey.Row()) + dRow;
+    const int64_t column = ((static_cast<int64_t>(tileKey.Column()) + dColumn) % limit + limit) % limit;
+    if (row < 0 || row >= limit) return geo::TileKey();
+    return geo::TileKey::FromRowColumnLevel(static_cast<uint64_t>(row),
+                                            static_cast<uint64_t>(column),
+                                            tileKey.Level());
+}
+
+// 生成预取候选：无方向时为周围 8 个瓦片（先上下左右、再四角），有方向时为前方若干瓦片
+std::vector<geo::TileKey> PrefetchCandidates(const geo::TileKey& tileKey, const PrefetchHint& hint) {
+    std::vector<geo::TileKey> candidates;
+    if (!hint.has_heading) {
+        static const int kOffsets[8][2] = {
+            {1, 0}, {0, 1}, {-1, 0}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}
+        };
+        for (const auto& offset : kOffsets) {
+            candidates.push_back(NeighborTile(tileKey, offset[0], offset[1]));
+        }
+    } else {
+        // HERE 瓦片行号向北递增；瓦片边长按赤道处经度跨度估算
+        const double kPi = 3.14159265358979323846;
+        const double heading = hint.heading_deg * kPi / 180.0;
+        const double dColumn = std::sin(heading);
+        const double dRow = std::cos(heading);
+        const double tile_meters = 111320.0 * 360.0 / static_cast<double>(uint64_t(1) << tileKey.Level());
+        int steps = static_cast<int>(std::ceil(hint.speed_mps * kPrefetchHorizonSeconds / tile_meters));
+        steps = std::max(1, std::min(steps, kMaxPrefetchStepsAhead));
+
+        for (int step = 1; step <= steps; ++step) {
+            const int64_t row = static_cast<int64_t>(std::lround(dRow * step));
+            const int64_t column = static_cast<int64_t>(std::lround(dColumn * step));
+            candidates.push_back(NeighborTile(tileKey, row, column));
+            if (step == 1) {
+                // 第一步同时覆盖前进方向两侧，容忍转弯
+                candidates.push_back(NeighborTile(tileKey, row - static_cast<int64_t>(std::lround(dColumn)),
+                                                  column + static_cast<int64_t>(std::lround(dRow))));
+                candidates.push_back(NeighborTile(tileKey, row + static_cast<int64_t>(std::lround(dColumn)),
+                                                  column - static_cast<int64_t>(std::lround(dRow))));
+            }
+        }
+    }
+
+    std::vector<geo::TileKey> result;
+    for (const auto& candidate : candidates) {
+        if (!candidate.IsValid() || candidate == tileKey) continue;
+        if (std::find(result.begin(), result.end(), candidate) != result.end()) continue;
+        result.push_back(candidate);
+    }
+    return result;
+}
+
+} // namespace
+
 class OcmMapEngine::OcmMapEngineImpl : public enable_shared_from_this<OcmMapEngineImpl> {
 public:
     explicit OcmMapEngineImpl(const Settings& settings)
         : m_settings(settings) {}
 
     ~OcmMapEngineImpl() noexcept {
-
+        // 先停止预取线程再释放 client/server。排队中的预取作废（结果不会再被使用），
+        // shutdown() 只等待正在进行的那一个，不再逐个下载
+        ++m_prefetch_generation;
+        if (m_prefetch_pool) {
+            m_prefetch_pool->shutdown();
+        }
     }
 
     OcmMapEngineImpl(const OcmMapEngineImpl&) = delete;
@@ -36,9 +119,55 @@ public:
 
     Response<datastore::TileLoadResult>  FetchTileAsync(
         const geo::TileKey& tileKey,
-        const TileRequest::Layers& layers) 
+        const TileRequest::Layers& layers,
+        const PrefetchHint& hint)
+    {
+        auto prefetched = TakePrefetched(tileKey, layers);
+        Response<datastore::TileLoadResult> response =
+            prefetched ? std::move(*prefetched) : FetchTileInternal(tileKey, layers);
+
+        if (m_settings.prefetch_neighbors && hint.enabled) {
+            PrefetchAround(tileKey, layers, hint);
+        }
+        return response;
+    }
+
+    void PrefetchAround(
+        const geo::TileKey& tileKey,
+        const TileRequest::Layers& layers,
+        const PrefetchHint& hint)
     {
-        return FetchTileInternal(tileKey, layers);
+        std::vector<geo::TileKey> candidates = PrefetchCandidates(tileKey, hint);
+        if (candidates.empty()) return;
+
+        // 新的请求使之前尚未执行的预取失效（Viewer 已经移动到别处）
+        const uint64_t generation = ++m_prefetch_generation;
+        ThreadPool* pool = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_prefetch_mutex);
+            if (!m_prefetch_pool) {
+                // 单线程：预取始终排在前台请求之后，不与其争抢
+                m_prefetch_pool.reset(new ThreadPool(1));
+            }
+            pool = m_prefetch_pool.get();
+        }
+
+        for (const auto& candidate : candidates) {
+            pool->enqueue([this, candidate, layers, generation]() {
+                if (generation != m_prefetch_generation.load()) return;
+                const std::string key = MakeCacheKey(candidate, layers);
+                {
+                    std::lock_guard<std::mutex> lock(m_prefetch_mutex);
+                    if (m_prefetched.count(key)) return;
+                }
+                Response<datastore::TileLoadResult> response = FetchTileInternal(candidate, layers);
+                if (!response.IsSuccessful()) {
+                    OLP_SDK_LOG_WARNING_F(kLogTag, "Prefetch tile %s failed", candidate.ToHereTile().c_str());
+                    return;
+                }
+                StorePrefetched(key, std::move(response));
+            });
+        }
     }
 
 private:
@@ -75,10 +204,13 @@ private:
         return version_response.GetResult( );
     }
 
-    Response<datastore::TileLoadResult>  FetchTileInternal(
-        const geo::TileKey& tileKey,
-        const TileRequest::Layers& layers) 
+    // 创建 server/client 并注册 catalog，只执行一次；前台请求与预取共用同一个磁盘缓存
+    std::shared_ptr<datastore::DataStoreClient> GetClient()
     {
+        std::lock_guard<std::mutex> lock(m_client_mutex);
+        if (m_client) {
+            return m_client;
+        }
 
         auto credentials = GetAuthenticationCredentials();
         if (!credentials) {
@@ -111,8 +243,7 @@ private:
                 const auto version_response = server -> GetAvailableVersion(
         m_settings.catalog_hrn, olp::cache::DefaultCache::CacheType::kProtected );
 
-        datastore::DataStoreClient client(server, datastore::DataStoreClientSettings{64u} );
-       // m_layer_client = make_shared<DataStoreClient>(m_server, DataStoreClientSettings{64u});
+        auto client = std::make_shared<datastore::DataStoreClient>(server, datastore::DataStoreClientSettings{64u} );
         auto add_server_catalog_response =
             datastore::AddCatalog(*server, m_settings.catalog_hrn,
                                   m_settings.catalog_version, credentials);
@@ -138,7 +269,7 @@ private:
         datastore::AddCatalog(*server, m_settings.catalog_hrn,
                                   catalogVersion, credentials);
        
-        auto catalog_handle = client.AddCatalog(
+        auto catalog_handle = client->AddCatalog(
             m_settings.catalog_hrn, ClientCatalogSettings{static_cast<int64_t>(catalogVersion)});
         if (!catalog_handle) {
             OLP_SDK_LOG_ERROR_F("OcmMapEngineImpl",
@@ -146,6 +277,19 @@ private:
                                 ToString(catalog_handle.GetError()).c_str());
            // return false;
         }
+
+        m_task_scheduler = task_scheduler;
+        m_server = server;
+        m_client = client;
+        return m_client;
+    }
+
+    Response<datastore::TileLoadResult>  FetchTileInternal(
+        const geo::TileKey& tileKey,
+        const TileRequest::Layers& layers) 
+    {
+        auto client = GetClient();
+
         std::promise< Response<datastore::TileLoadResult>  > load_promise;
 
         auto callback = [&]( const datastore::Response< datastore::TileLoadResult >& response ) {
@@ -153,13 +297,55 @@ private:
         };
 
         auto load_request = LoadTileRequest().WithTileKey(tileKey).WithLayers(layers);
-        client.Load(load_request).Detach( std::move( callback ) );
+        client->Load(load_request).Detach( std::move( callback ) );
 
         return load_promise.get_future( ).get( );
     }
 
+    // 取出预取结果（命中后从内存中移除）
+    boost::optional<Response<datastore::TileLoadResult>> TakePrefetched(
+        const geo::TileKey& tileKey,
+        const TileRequest::Layers& layers)
+    {
+        const std::string key = MakeCacheKey(tileKey, layers);
+        std::lock_guard<std::mutex> lock(m_prefetch_mutex);
+        auto it = m_prefetched.find(key);
+        if (it == m_prefetched.end()) {
+            return boost::none;
+        }
+        boost::optional<Response<datastore::TileLoadResult>> response = std::move(it->second);
+        m_prefetched.erase(it);
+        m_prefetch_order.erase(std::find(m_prefetch_order.begin(), m_prefetch_order.end(), key));
+        return response;
+    }
+
+    void StorePrefetched(const std::string& key, Response<datastore::TileLoadResult> response)
+    {
+        std::lock_guard<std::mutex> lock(m_prefetch_mutex);
+        if (m_prefetched.count(key)) return;
+        // 超出上限时丢弃最早预取的瓦片（磁盘缓存中仍然保留）
+        while (!m_prefetch_order.empty() && m_prefetch_order.size() >= m_settings.prefetch_cache_size) {
+            m_prefetched.erase(m_prefetch_order.front());
+            m_prefetch_order.pop_front();
+        }
+        if (m_settings.prefetch_cache_size == 0) return;
+        m_prefetched.emplace(key, std::move(response));
+        m_prefetch_order.push_back(key);
+    }
+
 private:
     Settings m_settings;
+
+    std::mutex m_client_mutex;
+    std::shared_ptr<olp::thread::TaskScheduler> m_task_scheduler;
+    std::shared_ptr<DataStoreServer> m_server;
+    std::shared_ptr<datastore::DataStoreClient> m_client;
+
+    std::mutex m_prefetch_mutex;
+    std::atomic<uint64_t> m_prefetch_generation{0};
+    std::unordered_map<std::string, Response<datastore::TileLoadResult>> m_prefetched;
+    std::deque<std::string> m_prefetch_order;
+    std::unique_ptr<ThreadPool> m_prefetch_pool;
 };
 
 // OcmMapEngine implementation
@@ -173,10 +359,26 @@ Response<datastore::TileLoadResult>  OcmMapEngine::FetchTileAsync(
     const geo::TileKey& tileKey,
     const datastore::TileRequest::Layers& layers) 
 {
-    return m_impl->FetchTileAsync(tileKey, layers);
+    return m_impl->FetchTileAsync(tileKey, layers, PrefetchHint());
                  
 }
 
+Response<datastore::TileLoadResult>  OcmMapEngine::FetchTileAsync(
+    const geo::TileKey& tileKey,
+    const datastore::TileRequest::Layers& layers,
+    const PrefetchHint& hint)
+{
+    return m_impl->FetchTileAsync(tileKey, layers, hint);
+}
+
+void OcmMapEngine::PrefetchAround(
+    const geo::TileKey& tileKey,
+    const datastore::TileRequest::Layers& layers,
+    const PrefetchHint& hint)
+{
+    m_impl->PrefetchAround(tileKey, layers, hint);
+}
+
 } // namespace ocm
 } // namespace maps
 } // namespace ning
\ No newline at end of file
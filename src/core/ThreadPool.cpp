@@ -0,0 +1,48 @@
+// ThreadPool.cpp
+#include "ThreadPool.hpp"
+
+namespace ning {
+namespace maps {
+namespace ocm {
+
+ThreadPool::ThreadPool(size_t threads)
+    : stop(false)
+{
+    if (threads == 0) threads = 1;
+    for (size_t i = 0; i < threads; ++i) {
+        workers.emplace_back([this] {
+            for (;;) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(queue_mutex);
+                    condition.wait(lock, [this] { return stop || !tasks.empty(); });
+                    // stop 之后仍然把队列中剩余任务执行完
+                    if (stop && tasks.empty()) return;
+                    task = std::move(tasks.front());
+                    tasks.pop();
+                }
+                task();
+            }
+        });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    shutdown();
+}
+
+void ThreadPool::shutdown() {
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        if (stop) return;
+        stop = true;
+    }
+    condition.notify_all();
+    for (std::thread& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+} // namespace ocm
+} // namespace maps
+} // namespace ning
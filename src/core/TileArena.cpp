@@ -0,0 +1,67 @@
+#include "TileArena.hpp"
+
+namespace ning {
+namespace maps {
+namespace ocm {
+
+namespace {
+
+// 每个线程的 arena 和 Scope 嵌套深度
+thread_local TileArena t_arena;
+thread_local int t_depth = 0;
+
+} // namespace
+
+constexpr size_t TileArena::kDefaultBlockSize;
+
+TileArena::TileArena(size_t block_size)
+    : block_size_(block_size)
+{
+}
+
+TileArena::~TileArena() {
+    Reset();
+    for (char* block : blocks_) ::operator delete(block);
+}
+
+void* TileArena::AllocateSlow(size_t bytes, size_t alignment) {
+    // 大对象单独分配，不占用普通块（new 的结果已按 max_align_t 对齐）
+    if (bytes > block_size_ / 4) {
+        char* p = static_cast<char*>(::operator new(bytes));
+        large_.push_back(p);
+        allocated_ += bytes;
+        return p;
+    }
+
+    if (next_block_ == blocks_.size()) {
+        blocks_.push_back(static_cast<char*>(::operator new(block_size_)));
+    }
+    cursor_ = blocks_[next_block_++];
+    limit_ = cursor_ + block_size_;
+    return Allocate(bytes, alignment);
+}
+
+void TileArena::Reset() {
+    for (char* p : large_) ::operator delete(p);
+    large_.clear();
+    next_block_ = 0;
+    cursor_ = nullptr;
+    limit_ = nullptr;
+    allocated_ = 0;
+}
+
+TileArena* TileArena::Active() {
+    return t_depth > 0 ? &t_arena : nullptr;
+}
+
+TileArena::Scope::Scope() {
+    ++t_depth;
+}
+
+TileArena::Scope::~Scope() {
+    if (--t_depth == 0) t_arena.Reset();
+}
+
+} // namespace ocm
+} // namespace maps
+} // namespace ning
@@ -1,85 +1,98 @@
 #include "TileIDConverter.hpp"
-#include <sstream>
-#include <algorithm>
-#include <cassert>
-#include <iostream> 
 
-// ------------------------- TileToQuadkey 实现 -------------------------
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
 
-// 将数值转换为固定长度的二进制字符串（高位在前）
-std::string to_binary_string(uint32_t num, uint32_t bits) {
-   // assert(bits > 0 && "Bit length must be positive");
-    assert(num < (1U << bits) && "Number exceeds bit length");
+constexpr uint32_t TileIDConverter::kMaxLevel;
 
-    std::string bin;
-    for (int i = bits - 1; i >= 0; --i) {  // 从最高位开始遍历
-        bin += (num & (1U << i)) ? '1' : '0';
-    }
-    return bin;
+namespace {
+
+constexpr uint64_t kEvenBits = 0x5555555555555555ull;
+constexpr uint64_t kOddBits = 0xAAAAAAAAAAAAAAAAull;
+
+inline uint64_t MortonCode(uint32_t x, uint32_t y) {
+#if defined(__BMI2__)
+    return _pdep_u64(x, kEvenBits) | _pdep_u64(y, kOddBits);
+#else
+    return TileIDConverter::Interleave(x, y);
+#endif
+}
+
+inline uint32_t EvenBits(uint64_t bits) {
+#if defined(__BMI2__)
+    return static_cast<uint32_t>(_pext_u64(bits, kEvenBits));
+#else
+    return TileIDConverter::Compact(bits);
+#endif
 }
 
+} // namespace
+
+// ------------------------- TileToQuadkey 实现 -------------------------
+
 std::string TileIDConverter::TileToQuadkey(uint32_t x, uint32_t y, uint32_t level) {
-    // 校验输入合法性
-  //  assert(level > 0 && "Tile level must be positive");
-    assert(x < (1U << level) && "X coordinate exceeds tile level");
-    assert(y < (1U << level) && "Y coordinate exceeds tile level");
-
-    // 步骤1：将 X/Y 转换为固定长度的二进制字符串（高位在前）
-    std::string x_bin = to_binary_string(x, level);
-    std::string y_bin = to_binary_string(y, level);
-
-    // 步骤2：交错 Y/X 的二进制位，转换为四进制字符串
-    std::string quadkey;
-    for (int i = 0; i < level; ++i) {
-        // 取 Y 和 X 的第 i 位（从高位到低位）
-        char y_bit = y_bin[i];
-        char x_bit = x_bin[i];
-
-        // 组合两位二进制并转换为四进制（00->0, 01->1, 10->2, 11->3）
-        std::string two_bits = std::string(1, y_bit) + x_bit;
-        int value = std::stoi(two_bits, nullptr, 2);  // 二进制转十进制
-        quadkey += "0123"[value];  // 十进制转四进制字符
+    if (level > 32) {
+        throw std::invalid_argument("Tile level must not exceed 32");
     }
+    const uint32_t mask = level >= 32 ? 0xFFFFFFFFu : (1u << level) - 1;
 
+    // Morton 码从高位起每两位 (y_bit << 1 | x_bit) 即一个四进制字符
+    const uint64_t morton = Interleave(x & mask, y & mask);
+    std::string quadkey(level, '0');
+    for (uint32_t i = 0; i < level; ++i) {
+        quadkey[i] = static_cast<char>('0' + ((morton >> (2 * (level - 1 - i))) & 3));
+    }
     return quadkey;
 }
 
 // ------------------------- QuadkeyToHereTileId 实现 -------------------------
 
 uint64_t TileIDConverter::QuadkeyToHereTileId(const std::string& quadkey) {
-    // 校验输入合法性
-    //if (quadkey.empty() || quadkey[0] != '1') {
-     //   throw std::invalid_argument("Quadkey must start with '1'");
-    //}
-    if (!std::all_of(quadkey.begin() + 1, quadkey.end(), [](char c) {
-        return c >= '0' && c <= '3';
-    })) {
-        //throw std::invalid_argument("Quadkey contains invalid characters (must be 0-3 after '1')");
+    // 前缀 "1" 后按四进制累加
+    uint64_t hereId = 1;
+    for (const char c : quadkey) {
+        if (c < '0' || c > '3') {
+            throw std::invalid_argument("Quadkey contains trailing invalid characters");
+        }
+        if ((hereId >> 62) != 0) {
+            throw std::overflow_error("Quadkey is too long, exceeds uint64_t capacity");
+        }
+        hereId = (hereId << 2) | static_cast<uint64_t>(c - '0');
     }
+    return hereId;
+}
 
-    // 步骤1：添加前缀 "1"（题目描述要求）
-    std::string prefixed = "1" + quadkey;
-
-    // 步骤2：四进制转十进制（使用 stoull）
-    size_t parsedChars = 0;
-    uint64_t hereId;
-    try {
-        hereId = std::stoull(prefixed, &parsedChars, 4);
-    } catch (const std::out_of_range&) {
-        throw std::overflow_error("Quadkey is too long, exceeds uint64_t capacity");
-    } catch (const std::invalid_argument&) {
-        // 理论上不会触发（已校验字符）
-        throw std::invalid_argument("Invalid quadkey format");
-    }
+// ------------------------- 逆转换与批量接口 -------------------------
 
-    // 校验是否所有字符都被解析
-    if (parsedChars != prefixed.size()) {
-        throw std::invalid_argument("Quadkey contains trailing invalid characters");
-    }
+std::string TileIDConverter::TileIdToQuadkey(uint64_t tile_id) {
+    const TileXY tile = TileIdToXY(tile_id);
+    return TileToQuadkey(tile.x, tile.y, tile.level);
+}
 
-    return hereId;
+void TileIDConverter::XYtoTileIds(const TileXY* tiles, size_t count, uint64_t* tile_ids) {
+    for (size_t i = 0; i < count; ++i) {
+        const TileXY& tile = tiles[i];
+        if (tile.level > kMaxLevel) {
+            throw std::overflow_error("Tile level exceeds 31, tile id does not fit uint64_t");
+        }
+        const uint32_t mask = (1u << tile.level) - 1;
+        tile_ids[i] = (uint64_t{1} << (2 * tile.level)) | MortonCode(tile.x & mask, tile.y & mask);
+    }
 }
 
-uint64_t TileIDConverter::XYtoTileId(uint32_t x, uint32_t y, uint32_t level){
-    return QuadkeyToHereTileId(TileToQuadkey(x,y,level));
-}
\ No newline at end of file
+void TileIDConverter::TileIdsToXY(const uint64_t* tile_ids, size_t count, TileXY* tiles) {
+    for (size_t i = 0; i < count; ++i) {
+        const uint64_t id = tile_ids[i];
+#if defined(__GNUC__)
+        const uint32_t level = id == 0 ? 0 : static_cast<uint32_t>(63 - __builtin_clzll(id)) / 2;
+#else
+        const uint32_t level = TileIdLevel(id);
+#endif
+        if ((id >> (2 * level)) != 1) {
+            throw std::invalid_argument("Invalid HERE tile id");
+        }
+        const uint64_t morton = id & ~(uint64_t{1} << (2 * level));
+        tiles[i] = TileXY{EvenBits(morton), EvenBits(morton >> 1), level};
+    }
+}
@@ -0,0 +1,62 @@
+// TileScheduler.cpp
+#include "TileScheduler.hpp"
+#include <olp/core/geo/tiling/TileKeyUtils.h>
+#include <olp/core/geo/tiling/TilingSchemeRegistry.h>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+namespace ning {
+namespace maps {
+namespace ocm {
+
+TileOrder ParseTileOrder(const std::string& name) {
+    if (name.empty() || name == "default") return TileOrder::kDefault;
+    if (name == "morton" || name == "zorder") return TileOrder::kMorton;
+    if (name == "center") return TileOrder::kCenterOut;
+    throw std::invalid_argument("Unknown tile order: " + name);
+}
+
+void ScheduleTileKeys(datastore::TileKeys& tile_keys,
+                      TileOrder order,
+                      const olp::geo::GeoCoordinates& center)
+{
+    if (tile_keys.size() < 2 || order == TileOrder::kDefault) {
+        return;
+    }
+
+    // 同一 level 下 ToQuadKey64 即为 Morton 码，也用作中心优先时的次序键，保证结果确定
+    auto morton_less = [](const olp::geo::TileKey& a, const olp::geo::TileKey& b) {
+        return a.ToQuadKey64() < b.ToQuadKey64();
+    };
+
+    if (order == TileOrder::kMorton) {
+        std::sort(tile_keys.begin(), tile_keys.end(), morton_less);
+        return;
+    }
+
+    // kCenterOut：按与中心瓦片的 (列, 行) 距离由近到远
+    const olp::geo::HalfQuadTreeIdentityTilingScheme tiling_scheme;
+    const olp::geo::TileKey center_key = olp::geo::TileKeyUtils::GeoCoordinatesToTileKey(
+        tiling_scheme, center, tile_keys.front().Level());
+    const int64_t cx = static_cast<int64_t>(center_key.Column());
+    const int64_t cy = static_cast<int64_t>(center_key.Row());
+
+    auto distance2 = [cx, cy](const olp::geo::TileKey& key) {
+        const int64_t dx = static_cast<int64_t>(key.Column()) - cx;
+        const int64_t dy = static_cast<int64_t>(key.Row()) - cy;
+        return dx * dx + dy * dy;
+    };
+
+    std::sort(tile_keys.begin(), tile_keys.end(),
+        [&](const olp::geo::TileKey& a, const olp::geo::TileKey& b) {
+            const int64_t da = distance2(a);
+            const int64_t db = distance2(b);
+            if (da != db) return da < db;
+            return morton_less(a, b);
+        });
+}
+
+} // namespace ocm
+} // namespace maps
+} // namespace ning
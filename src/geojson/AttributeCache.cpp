@@ -0,0 +1,22 @@
+#include "AttributeCache.hpp"
+#include <stdexcept>
+
+namespace converter {
+
+AttributeOutput ParseAttributeOutput(const std::string& name) {
+    if (name.empty() || name == "inline") return AttributeOutput::kInline;
+    if (name == "dict") return AttributeOutput::kDictionary;
+    throw std::invalid_argument("Unknown attributes output: " + name);
+}
+
+std::string AttributeDictionary::Serialize() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 作为顶层对象成员的值，层级为 1
+    JsonWriter w(indent_, 1);
+    w.BeginArray();
+    for (const auto& entry : entries_) w.RawValue(entry);
+    w.EndArray();
+    return std::move(w.buffer());
+}
+
+} // namespace converter
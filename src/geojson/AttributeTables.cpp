@@ -0,0 +1,200 @@
+#include "AttributeTables.hpp"
+#include "here-devel/com/here/platform/schema/clientmap/v1/layers/SegmentAttributeLayer.pb.h"
+#include "here-devel/com/here/platform/schema/clientmap/v1/layers/common/AccessBitMask.pb.h"
+#include "here-devel/com/here/platform/schema/clientmap/v1/layers/common/FunctionalClass.pb.h"
+#include "here-devel/com/here/platform/schema/clientmap/v1/layers/common/IntersectionCategory.pb.h"
+#include "here-devel/com/here/platform/schema/clientmap/v1/layers/common/LocalRoadBitMask.pb.h"
+#include "here-devel/com/here/platform/schema/clientmap/v1/layers/common/RelativeDirection.pb.h"
+#include "here-devel/com/here/platform/schema/clientmap/v1/layers/common/RoadDivider.pb.h"
+#include "here-devel/com/here/platform/schema/clientmap/v1/layers/common/RoadUsageBitMask.pb.h"
+#include "here-devel/com/here/platform/schema/clientmap/v1/layers/common/SpecialSpeedSituation.pb.h"
+#include "here-devel/com/here/platform/schema/clientmap/v1/layers/common/SpecialTrafficAreaCategory.pb.h"
+#include "here-devel/com/here/platform/schema/clientmap/v1/layers/common/SpeedCategory.pb.h"
+
+namespace converter {
+
+using namespace com::here::platform::schema::clientmap::v1::layers::common;
+
+namespace {
+
+const BitFlag kAccessFlags[] = {
+    {AccessBitMask::AUTOMOBILES, "AUTOMOBILES"},
+    {AccessBitMask::BUSES,       "BUSES"},
+    {AccessBitMask::TRUCKS,      "TRUCKS"},
+    {AccessBitMask::PEDESTRIANS, "PEDESTRIANS"},
+    {AccessBitMask::MOTORCYCLES, "MOTORCYCLES"}
+};
+
+const BitFlag kLocalRoadFlags[] = {
+    {LocalRoadBitMask::FRONTAGE,         "FRONTAGE"},
+    {LocalRoadBitMask::PARKING_LOT_ROAD, "PARKING_LOT_ROAD"},
+    {LocalRoadBitMask::POI_ACCESS,       "POI_ACCESS"}
+};
+
+const BitFlag kRoadUsageFlags[] = {
+    {RoadUsageBitMask::CARPOOL_ROAD,        "CARPOOL_ROAD"},
+    {RoadUsageBitMask::CONTROLLED_ACCESS,   "CONTROLLED_ACCESS"},
+    {RoadUsageBitMask::EXPRESS_LANE,        "EXPRESS_LANE"},
+    {RoadUsageBitMask::LIMITED_ACCESS,      "LIMITED_ACCESS"},
+    {RoadUsageBitMask::PRIORITY_ROAD,       "PRIORITY_ROAD"},
+    {RoadUsageBitMask::RAMP,                "RAMP"},
+    {RoadUsageBitMask::REVERSIBLE,          "REVERSIBLE"},
+    {RoadUsageBitMask::TOLLWAY,             "TOLLWAY"},
+    {RoadUsageBitMask::DIMINISHED_PRIORITY, "DIMINISHED_PRIORITY"},
+    {RoadUsageBitMask::PUBLIC_ACCESS,       "PUBLIC_ACCESS"}
+};
+
+const BitFlag kPhysicalFlags[] = {
+    {1,  "BOAT_FERRY"},
+    {2,  "BRIDGE"},
+    {4,  "MULTIPLY_DIGITIZED"},
+    {8,  "PAVED"},
+    {16, "PRIVATE"},
+    {32, "RAIL_FERRY"},
+    {64, "TUNNEL"},
+    {128,"DELIVERY_ROAD"},
+    {256,"MOVABLE_BRIDGE"}
+};
+
+const BitFlag kSpeedLimitRainingFlags[] = {
+    {1, "MAX_SPEED_RAINING_EMPTY"},
+    {2, "MOTORWAYS_AND_CONTROLLED_ACCESS_ROADS_LIMIT_110_KMH"}
+};
+
+// 对应 proto 中的 ParkingSideBitMask
+const BitFlag kParkingSideFlags[] = {
+    {1, "BOTH_SIDES_ONE_WAY_ROAD"},
+    {2, "OPPOSITE_LANE_TWO_WAY_ROAD"}
+};
+
+} // namespace
+
+const FlagNameTable& AccessFlagNames() {
+    static const FlagNameTable table(kAccessFlags);
+    return table;
+}
+
+const FlagNameTable& LocalRoadFlagNames() {
+    static const FlagNameTable table(kLocalRoadFlags);
+    return table;
+}
+
+const FlagNameTable& RoadUsageFlagNames() {
+    static const FlagNameTable table(kRoadUsageFlags);
+    return table;
+}
+
+const FlagNameTable& PhysicalFlagNames() {
+    static const FlagNameTable table(kPhysicalFlags);
+    return table;
+}
+
+const FlagNameTable& SpeedLimitRainingFlagNames() {
+    static const FlagNameTable table(kSpeedLimitRainingFlags);
+    return table;
+}
+
+const FlagNameTable& ParkingSideFlagNames() {
+    static const FlagNameTable table(kParkingSideFlags);
+    return table;
+}
+
+const EnumNameTable& FunctionalClassNames() {
+    static const EnumNameTable table(FunctionalClass_descriptor());
+    return table;
+}
+
+const EnumNameTable& RelativeDirectionNames() {
+    static const EnumNameTable table(RelativeDirection_descriptor());
+    return table;
+}
+
+const EnumNameTable& SpeedCategoryNames() {
+    static const EnumNameTable table(SpeedCategory_descriptor());
+    return table;
+}
+
+const EnumNameTable& IntersectionCategoryNames() {
+    static const EnumNameTable table(IntersectionCategory_descriptor());
+    return table;
+}
+
+const EnumNameTable& RoadDividerNames() {
+    static const EnumNameTable table(RoadDivider_descriptor());
+    return table;
+}
+
+const EnumNameTable& SpecialTrafficAreaCategoryNames() {
+    static const EnumNameTable table(SpecialTrafficAreaCategory_descriptor());
+    return table;
+}
+
+const EnumNameTable& SpecialSpeedTypeNames() {
+    static const EnumNameTable table(SpecialSpeedSituation::SpecialSpeedType_descriptor());
+    return table;
+}
+
+const EnumNameTable& TollFeatureTypeNames() {
+    static const EnumNameTable table(UsageFeeRequired::TollFeatureType_descriptor());
+    return table;
+}
+
+namespace attribute_keys {
+
+const JsonKey kAccess("access");
+const JsonKey kAccessRestrictions("access_restrictions");
+const JsonKey kAdministrativeRoadContextId("administrative_road_context_id");
+const JsonKey kAdministrativeRoutingContextId("administrative_routing_context_id");
+const JsonKey kAppliesDuring("applies_during");
+const JsonKey kAppliesDuringReadable("applies_during_readable");
+const JsonKey kAppliesTo("applies_to");
+const JsonKey kBackwardAccessPermissions("backward_access_permissions");
+const JsonKey kBackwardFreeFlowSpeed("backward_free_flow_speed");
+const JsonKey kBackwardSpeedLimit("backward_speed_limit");
+const JsonKey kBackwardSpeedLimitSource("backward_speed_limit_source");
+const JsonKey kBackwardSpeedLimitUnlimited("backward_speed_limit_unlimited");
+const JsonKey kBackwardThroughLaneCount("backward_through_lane_count");
+const JsonKey kBackwardVariableSpeedLimit("backward_variable_speed_limit");
+const JsonKey kBuiltUpArea("built_up_area");
+const JsonKey kConstructionStatuses("construction_statuses");
+const JsonKey kEnvironmentalZoneConditions("environmental_zone_conditions");
+const JsonKey kEnvironmentalZoneId("environmental_zone_id");
+const JsonKey kForwardAccessPermissions("forward_access_permissions");
+const JsonKey kForwardFreeFlowSpeed("forward_free_flow_speed");
+const JsonKey kForwardSpeedLimit("forward_speed_limit");
+const JsonKey kForwardSpeedLimitSource("forward_speed_limit_source");
+const JsonKey kForwardSpeedLimitUnlimited("forward_speed_limit_unlimited");
+const JsonKey kForwardThroughLaneCount("forward_through_lane_count");
+const JsonKey kForwardVariableSpeedLimit("forward_variable_speed_limit");
+const JsonKey kFunctionalClass("functional_class");
+const JsonKey kHasPolygonalGeometry("has_polygonal_geometry");
+const JsonKey kIntersectionCategory("intersection_category");
+const JsonKey kLocalRoad("local_road");
+const JsonKey kMinZoomLevel("min_zoom_level");
+const JsonKey kPhysical("physical");
+const JsonKey kRelativeDirection("relative_direction");
+const JsonKey kRestArea("rest_area");
+const JsonKey kRoadDivider("road_divider");
+const JsonKey kRoadUsage("road_usage");
+const JsonKey kSeasonalAppliesDuring("seasonal_applies_during");
+const JsonKey kShapePointIndex("shape_point_index");
+const JsonKey kShapePointRatio("shape_point_ratio");
+const JsonKey kSpecialSpeedLimit("special_speed_limit");
+const JsonKey kSpecialSpeedSituations("special_speed_situations");
+const JsonKey kSpecialSpeedType("special_speed_type");
+const JsonKey kSpecialTrafficAreaCategory("special_traffic_area_category");
+const JsonKey kSpeedCategory("speed_category");
+const JsonKey kStartOffset("start_offset");
+const JsonKey kStateCode("state_code");
+const JsonKey kTollFeatureType("toll_feature_type");
+const JsonKey kTollSystemId("toll_system_id");
+const JsonKey kTravelDirection("travel_direction");
+const JsonKey kTruckToll("truck_toll");
+const JsonKey kUnderConstruction("under_construction");
+const JsonKey kUrban("urban");
+const JsonKey kUsageFeeRequired("usage_fee_required");
+const JsonKey kZLevel("z_level");
+
+} // namespace attribute_keys
+
+} // namespace converter
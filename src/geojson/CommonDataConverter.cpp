@@ -1,8 +1,10 @@
 #include "CommonDataConverter.hpp"
+#include "RawLayerWriter.hpp"
 #include "TimeDomainParser.hpp"
 #include "TileIDConverter.hpp"
 #include <olp/core/logging/Log.h>
 #include <fstream>
+#include <future>
 #include <cmath>
 #include <sstream>
 #include <LayerFinder.hpp>
@@ -90,48 +92,86 @@ const google::protobuf::Message* CommonDataConverter::ExtractProtobufFromLayer(c
 }
 
 
-// 修正：处理 Protobuf JSON 转换的警告
-json CommonDataConverter::ProtobufToJson(const google::protobuf::Message& msg) {
-    try {
-        std::string json_str;
-        // 修正：用 JsonPrintOptions 替代废弃的 JsonOptions
-        google::protobuf::util::JsonPrintOptions print_options;
-        print_options.add_whitespace = true;  // 保留缩进，便于阅读
+// 核心转换方法
+void CommonDataConverter::convert(
+    const olp::clientmap::datastore::Response<olp::clientmap::datastore::TileLoadResult>& response, 
+    const olp::geo::TileKey& tile_key, 
+    const std::string& outPath,
+    ocm::ThreadPool* pool) {
 
-        // 修正：不忽略 nodiscard 返回值，判断转换状态
-        (void)google::protobuf::util::MessageToJsonString(msg, &json_str, print_options);
+    if (!response.IsSuccessful()) {
+        OLP_SDK_LOG_ERROR_F(kLogTag, "Tile load response is failed, error: %s", response.GetError());
+        return;
+    }
 
+    const auto& layer_results = response.GetResult().GetLayersResults();
+    if (layer_results.empty()) {
+        OLP_SDK_LOG_WARNING(kLogTag, "No layers found in the response");
+        return;
+    }
 
-        return json::parse(json_str);
-    } catch (const json::parse_error& e) {
-        OLP_SDK_LOG_ERROR_F(kLogTag, "JSON parse failed: %s", e.what());
-        return json::object();
+    // 各图层在工作线程中并行序列化，再按图层序号依次写入文件，输出与顺序执行相同
+    struct LayerJob {
+        std::string name;
+        const google::protobuf::Message* msg = nullptr;
+        std::string json;
+        std::future<bool> serialized;
+    };
+    std::vector<LayerJob> jobs(layer_results.size());
+
+    for (size_t i = 0; i < layer_results.size(); ++i) {
+        LayerJob& job = jobs[i];
+        try {
+            job.name = layer_results[i].GetPayload().layer_name;
+            OLP_SDK_LOG_INFO_F(kLogTag, "Processing layer: %s (index: %zu)", job.name.c_str(), i);
+
+            job.msg = ExtractProtobufFromLayer(layer_results[i]);
+            if (!job.msg) {
+                OLP_SDK_LOG_WARNING_F(kLogTag, "Skip layer %s: failed to extract protobuf data", job.name.c_str());
+                continue;
+            }
+
+            auto serialize = [&job]() { return RawLayerWriter::Serialize(*job.msg, job.json); };
+            job.serialized = pool && layer_results.size() > 1 ? pool->enqueue(serialize)
+                                                              : std::async(std::launch::deferred, serialize);
+        } catch (const std::exception& e) {
+            OLP_SDK_LOG_ERROR_F(kLogTag, "Process layer %zu failed: %s", i, e.what());
+        }
     }
-}
 
-// 写入文件函数
-bool CommonDataConverter::WriteJsonToFile(const json& merged_json, const std::string& out_path) {
-    try {
-        std::ofstream output_file(out_path);
-        if (!output_file.is_open()) {
-            OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to open output file: %s", out_path.c_str());
-            return false;
+    // 每个已提交的任务都在这里等待完成，jobs 在此之前不能析构
+    RawLayerWriter writer(outPath, tile_key.ToHereTile(), layer_results.size());
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        LayerJob& job = jobs[i];
+        if (!job.serialized.valid()) continue;
+        try {
+            if (!job.serialized.get()) {
+                OLP_SDK_LOG_WARNING_F(kLogTag, "Skip layer %s: empty JSON data", job.name.c_str());
+            } else {
+                writer.WriteSerialized(job.json, job.name, i);
+            }
+        } catch (const std::exception& e) {
+            OLP_SDK_LOG_ERROR_F(kLogTag, "Process layer %zu failed: %s", i, e.what());
         }
+        std::string().swap(job.json);   // 写完即释放
+    }
 
-        output_file << std::setw(4) << merged_json << std::endl;
-        output_file.close();
-        OLP_SDK_LOG_INFO_F(kLogTag, "Successfully write merged JSON to: %s", out_path.c_str());
-        return true;
+    try {
+        writer.Close();
     } catch (const std::exception& e) {
         OLP_SDK_LOG_ERROR_F(kLogTag, "Write file failed: %s", e.what());
-        return false;
+        return;
+    }
+    if (writer.layers_written() > 0) {
+        OLP_SDK_LOG_INFO_F(kLogTag, "Successfully write merged JSON to: %s", outPath.c_str());
+    } else {
+        OLP_SDK_LOG_WARNING(kLogTag, "No valid layer data to write");
     }
 }
 
-// 核心转换方法
-void CommonDataConverter::convert(
-    const olp::clientmap::datastore::Response<olp::clientmap::datastore::TileLoadResult>& response, 
-    const olp::geo::TileKey& tile_key, 
+void CommonDataConverter::convertToProtobuf(
+    const olp::clientmap::datastore::Response<olp::clientmap::datastore::TileLoadResult>& response,
+    const olp::geo::TileKey& tile_key,
     const std::string& outPath) {
 
     if (!response.IsSuccessful()) {
@@ -145,48 +185,32 @@ void CommonDataConverter::convert(
         return;
     }
 
-    json merged_json;
-    merged_json["type"] = "FeatureCollection";
-    merged_json["tile_key"] = tile_key.ToHereTile();
-    merged_json["layer_count"] = layer_results.size();
-    merged_json["features"] = json::array();
-
+    // 二进制序列化远比 JSON 便宜，直接在调用线程中按图层顺序写入
+    RawLayerPbWriter writer(outPath, tile_key.ToHereTile());
     for (size_t i = 0; i < layer_results.size(); ++i) {
-        const auto& layer_response = layer_results[i];
-
         try {
-            const auto& payload = layer_response.GetPayload();
-            const std::string& layer_name = payload.layer_name;
-            OLP_SDK_LOG_INFO_F(kLogTag, "Processing layer: %s (index: %zu)", layer_name.c_str(), i);
-
-            const google::protobuf::Message* proto_msg = ExtractProtobufFromLayer(layer_response);
-            if (!proto_msg) {
-                OLP_SDK_LOG_WARNING_F(kLogTag, "Skip layer %s: failed to extract protobuf data", layer_name.c_str());
+            const std::string& name = layer_results[i].GetPayload().layer_name;
+            const google::protobuf::Message* msg = ExtractProtobufFromLayer(layer_results[i]);
+            if (!msg) {
+                OLP_SDK_LOG_WARNING_F(kLogTag, "Skip layer %s: failed to extract protobuf data", name.c_str());
                 continue;
             }
-
-            json layer_json = ProtobufToJson(*proto_msg);
-            if (layer_json.is_null() || layer_json.empty()) {
-                OLP_SDK_LOG_WARNING_F(kLogTag, "Skip layer %s: empty JSON data", layer_name.c_str());
-                continue;
+            if (!writer.WriteLayer(*msg, name, i)) {
+                OLP_SDK_LOG_WARNING_F(kLogTag, "Skip layer %s: failed to serialize protobuf", name.c_str());
             }
-
-            layer_json["layer_meta"] = {
-                {"layer_name", layer_name},
-                {"layer_index", i},
-                {"tile_key", tile_key.ToHereTile()}
-            };
-
-            merged_json["features"].push_back(layer_json);
-
         } catch (const std::exception& e) {
             OLP_SDK_LOG_ERROR_F(kLogTag, "Process layer %zu failed: %s", i, e.what());
-            continue;
         }
     }
 
-    if (!merged_json["features"].empty()) {
-        WriteJsonToFile(merged_json, outPath);
+    try {
+        writer.Close();
+    } catch (const std::exception& e) {
+        OLP_SDK_LOG_ERROR_F(kLogTag, "Write file failed: %s", e.what());
+        return;
+    }
+    if (writer.layers_written() > 0) {
+        OLP_SDK_LOG_INFO_F(kLogTag, "Successfully write raw protobuf to: %s", outPath.c_str());
     } else {
         OLP_SDK_LOG_WARNING(kLogTag, "No valid layer data to write");
     }
@@ -0,0 +1,155 @@
+// CoordinateDecoder.cpp
+#include "CoordinateDecoder.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define OCMLOADER_DECODE_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OCMLOADER_DECODE_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define OCMLOADER_DECODE_NEON 1
+#endif
+
+namespace utils {
+
+int ParseCoordinatePrecision(const std::string& value) {
+    if (value.empty()) return -1;
+    char* end = nullptr;
+    const long digits = std::strtol(value.c_str(), &end, 10);
+    if (*end != '\0' || digits < 0 || digits > kMaxCoordinatePrecision) {
+        throw std::invalid_argument("precision must be an integer in [0, " +
+                                    std::to_string(kMaxCoordinatePrecision) + "]: " + value);
+    }
+    return static_cast<int>(digits);
+}
+
+uint64_t Pow10(int precision) {
+    static const uint64_t kPow10[kMaxCoordinatePrecision + 1] = {
+        1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull, 1000000000ull
+    };
+    return kPow10[precision];
+}
+
+int64_t WorldToFixed(uint64_t world, uint32_t world_bits, int precision) {
+    // world * 360 < 2^42；拆成整数度和小数部分，小数部分 (< 2^world_bits) 乘 10^9 也不会溢出
+    const uint64_t pow10 = Pow10(precision);
+    const uint64_t degrees = world * 360;
+    const uint64_t whole = degrees >> world_bits;
+    const uint64_t frac = degrees & ((1ull << world_bits) - 1);
+    const uint64_t half = world_bits > 0 ? (1ull << (world_bits - 1)) : 0;
+    return static_cast<int64_t>(whole * pow10 + ((frac * pow10 + half) >> world_bits));
+}
+
+CoordinateDecoder::CoordinateDecoder(const olp::geo::TileKey& tile_key, uint32_t world_bits)
+    : CoordinateDecoder(tile_key, world_bits, tile_key.Level())
+{
+}
+
+CoordinateDecoder::CoordinateDecoder(const olp::geo::TileKey& tile_key, uint32_t world_bits, uint32_t level)
+{
+    const uint32_t shift = world_bits - level;
+    world_origin_x_ = static_cast<uint64_t>(tile_key.Column()) << shift;
+    world_origin_y_ = static_cast<uint64_t>(tile_key.Row()) << shift;
+    world_bits_ = world_bits;
+    origin_x_ = static_cast<double>(world_origin_x_);
+    origin_y_ = static_cast<double>(world_origin_y_);
+    scale_ = std::ldexp(360.0, -static_cast<int>(world_bits));
+}
+
+void CoordinateDecoder::DecodeFixed(const uint32_t* xy, size_t count, int precision, int64_t* lng, int64_t* lat) const {
+    const int64_t lng0 = 180 * static_cast<int64_t>(Pow10(precision));
+    const int64_t lat0 = 90 * static_cast<int64_t>(Pow10(precision));
+    for (size_t i = 0; i < count; ++i) {
+        lng[i] = WorldToFixed(world_origin_x_ + xy[2 * i], world_bits_, precision) - lng0;
+        lat[i] = WorldToFixed(world_origin_y_ + xy[2 * i + 1], world_bits_, precision) - lat0;
+    }
+}
+
+const char* CoordinateDecoder::Backend() {
+#if defined(OCMLOADER_DECODE_AVX2)
+    return "avx2";
+#elif defined(OCMLOADER_DECODE_SSE2)
+    return "sse2";
+#elif defined(OCMLOADER_DECODE_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+void CoordinateDecoder::Decode(const uint32_t* xy, size_t count, double* lng, double* lat) const {
+    size_t i = 0;
+
+#if defined(OCMLOADER_DECODE_AVX2)
+    // 每次 4 个点：先把 x0 y0 x1 y1 ... 重排为 x0..x3 | y0..y3，
+    // uint32 -> double 用异或 0x80000000 转为有符号后再加 2^31
+    const __m256i deinterleave = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    const __m128i sign = _mm_set1_epi32(static_cast<int>(0x80000000u));
+    const __m256d bias = _mm256_set1_pd(2147483648.0);
+    const __m256d ox = _mm256_set1_pd(origin_x_);
+    const __m256d oy = _mm256_set1_pd(origin_y_);
+    const __m256d sc = _mm256_set1_pd(scale_);
+    const __m256d lng0 = _mm256_set1_pd(180.0);
+    const __m256d lat0 = _mm256_set1_pd(90.0);
+    for (; i + 4 <= count; i += 4) {
+        const __m256i v = _mm256_permutevar8x32_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(xy + 2 * i)), deinterleave);
+        const __m128i xs = _mm256_castsi256_si128(v);
+        const __m128i ys = _mm256_extracti128_si256(v, 1);
+        const __m256d dx = _mm256_add_pd(_mm256_cvtepi32_pd(_mm_xor_si128(xs, sign)), bias);
+        const __m256d dy = _mm256_add_pd(_mm256_cvtepi32_pd(_mm_xor_si128(ys, sign)), bias);
+        _mm256_storeu_pd(lng + i, _mm256_sub_pd(_mm256_mul_pd(_mm256_add_pd(dx, ox), sc), lng0));
+        _mm256_storeu_pd(lat + i, _mm256_sub_pd(_mm256_mul_pd(_mm256_add_pd(dy, oy), sc), lat0));
+    }
+#elif defined(OCMLOADER_DECODE_SSE2)
+    // 每次 2 个点：uint32 零扩展为 64 位后拼上 2^52 的指数位，再减去 2^52 得到精确的 double
+    const __m128i zero = _mm_setzero_si128();
+    const __m128d magic = _mm_set1_pd(4503599627370496.0);
+    const __m128i magic_bits = _mm_castpd_si128(magic);
+    const __m128d ox = _mm_set1_pd(origin_x_);
+    const __m128d oy = _mm_set1_pd(origin_y_);
+    const __m128d sc = _mm_set1_pd(scale_);
+    const __m128d lng0 = _mm_set1_pd(180.0);
+    const __m128d lat0 = _mm_set1_pd(90.0);
+    for (; i + 2 <= count; i += 2) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(xy + 2 * i));
+        const __m128d p0 = _mm_sub_pd(_mm_castsi128_pd(_mm_or_si128(_mm_unpacklo_epi32(v, zero), magic_bits)), magic);
+        const __m128d p1 = _mm_sub_pd(_mm_castsi128_pd(_mm_or_si128(_mm_unpackhi_epi32(v, zero), magic_bits)), magic);
+        const __m128d dx = _mm_unpacklo_pd(p0, p1);
+        const __m128d dy = _mm_unpackhi_pd(p0, p1);
+        _mm_storeu_pd(lng + i, _mm_sub_pd(_mm_mul_pd(_mm_add_pd(dx, ox), sc), lng0));
+        _mm_storeu_pd(lat + i, _mm_sub_pd(_mm_mul_pd(_mm_add_pd(dy, oy), sc), lat0));
+    }
+#elif defined(OCMLOADER_DECODE_NEON)
+    // 每次 4 个点：vld2q 直接按 x / y 分离
+    const float64x2_t ox = vdupq_n_f64(origin_x_);
+    const float64x2_t oy = vdupq_n_f64(origin_y_);
+    const float64x2_t sc = vdupq_n_f64(scale_);
+    const float64x2_t lng0 = vdupq_n_f64(180.0);
+    const float64x2_t lat0 = vdupq_n_f64(90.0);
+    for (; i + 4 <= count; i += 4) {
+        const uint32x4x2_t v = vld2q_u32(xy + 2 * i);
+        const float64x2_t x_lo = vcvtq_f64_u64(vmovl_u32(vget_low_u32(v.val[0])));
+        const float64x2_t x_hi = vcvtq_f64_u64(vmovl_u32(vget_high_u32(v.val[0])));
+        const float64x2_t y_lo = vcvtq_f64_u64(vmovl_u32(vget_low_u32(v.val[1])));
+        const float64x2_t y_hi = vcvtq_f64_u64(vmovl_u32(vget_high_u32(v.val[1])));
+        vst1q_f64(lng + i,     vsubq_f64(vmulq_f64(vaddq_f64(x_lo, ox), sc), lng0));
+        vst1q_f64(lng + i + 2, vsubq_f64(vmulq_f64(vaddq_f64(x_hi, ox), sc), lng0));
+        vst1q_f64(lat + i,     vsubq_f64(vmulq_f64(vaddq_f64(y_lo, oy), sc), lat0));
+        vst1q_f64(lat + i + 2, vsubq_f64(vmulq_f64(vaddq_f64(y_hi, oy), sc), lat0));
+    }
+#endif
+
+    // 标量实现，以及向量路径剩余的尾部
+    for (; i < count; ++i) {
+        lng[i] = Longitude(xy[2 * i]);
+        lat[i] = Latitude(xy[2 * i + 1]);
+    }
+}
+
+} // namespace utils
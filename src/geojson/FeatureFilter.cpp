@@ -0,0 +1,222 @@
+#include "FeatureFilter.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace feature_filter {
+
+using json = nlohmann::json;
+
+namespace {
+
+std::string trim(const std::string& s) {
+    size_t start = s.find_first_not_of(" \t\n\r");
+    size_t end = s.find_last_not_of(" \t\n\r");
+    return (start == std::string::npos) ? "" : s.substr(start, end - start + 1);
+}
+
+// 与 std::stod 一致：允许前导空白，只要开头能解析出数字即可；不抛异常、不分配内存
+bool ParseNumberPrefix(const char* s, double& out) {
+    char* end = nullptr;
+    out = std::strtod(s, &end);
+    return end != s;
+}
+
+// 在括号深度为 0 的 ',' / ';' 处切分
+std::vector<std::string> SplitTopLevel(const std::string& s, bool split_on_comma) {
+    std::vector<std::string> parts;
+    std::string buf;
+    int paren = 0;
+    for (char c : s) {
+        if (c == '(') paren++;
+        if (c == ')') paren--;
+        if (paren == 0 && (c == ';' || (split_on_comma && c == ','))) {
+            if (!trim(buf).empty()) parts.push_back(buf);
+            buf.clear();
+        } else {
+            buf += c;
+        }
+    }
+    if (!trim(buf).empty()) parts.push_back(buf);
+    return parts;
+}
+
+Predicate ParsePredicate(const std::string& s) {
+    static const struct { const char* text; CompareOp op; } kOps[] = {
+        {">=", CompareOp::kGe}, {"<=", CompareOp::kLe}, {"=", CompareOp::kEq},
+        {">", CompareOp::kGt}, {"<", CompareOp::kLt}
+    };
+    for (const auto& op : kOps) {
+        size_t pos = s.find(op.text);
+        if (pos == std::string::npos) continue;
+
+        Predicate p;
+        p.key = trim(s.substr(0, pos));
+        p.op = op.op;
+        const std::string value = trim(s.substr(pos + std::char_traits<char>::length(op.text)));
+        p.is_number = ParseNumberPrefix(value.c_str(), p.number);
+        p.lowered = value;
+        std::transform(p.lowered.begin(), p.lowered.end(), p.lowered.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (p.lowered == "true") p.boolean = 1;
+        else if (p.lowered == "false") p.boolean = 0;
+        return p;
+    }
+    throw std::runtime_error("Invalid condition: " + s);
+}
+
+bool CompareNumbers(double value, CompareOp op, double constant) {
+    switch (op) {
+    case CompareOp::kEq: return value == constant;
+    case CompareOp::kGt: return value > constant;
+    case CompareOp::kLt: return value < constant;
+    case CompareOp::kGe: return value >= constant;
+    case CompareOp::kLe: return value <= constant;
+    }
+    return false;
+}
+
+} // namespace
+
+bool MatchNumber(double value, const Predicate& p) {
+    return p.is_number && CompareNumbers(value, p.op, p.number);
+}
+
+// value 需以 '\0' 结尾（std::string / protobuf 字符串均满足）
+bool MatchString(const char* value, size_t length, const Predicate& p) {
+    double number = 0.0;
+    if (p.is_number && ParseNumberPrefix(value, number)) {
+        return CompareNumbers(number, p.op, p.number);
+    }
+    if (p.op != CompareOp::kEq || length != p.lowered.size()) {
+        return false;
+    }
+    // 忽略大小写的字符串比较
+    for (size_t i = 0; i < length; ++i) {
+        if (std::tolower(static_cast<unsigned char>(value[i])) != static_cast<unsigned char>(p.lowered[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MatchBool(bool value, const Predicate& p) {
+    return p.op == CompareOp::kEq && p.boolean >= 0 && value == (p.boolean == 1);
+}
+
+bool MatchJsonValue(const json& value, const Predicate& p) {
+    if (value.is_number()) {
+        return MatchNumber(value.get<double>(), p);
+    }
+    if (value.is_string()) {
+        const std::string& s = value.get_ref<const std::string&>();
+        return MatchString(s.c_str(), s.size(), p);
+    }
+    if (value.is_boolean()) {
+        return MatchBool(value.get<bool>(), p);
+    }
+    return false;
+}
+
+bool MatchFieldValue(const FieldValue& value, const Predicate& p) {
+    switch (value.kind) {
+    case FieldValue::Kind::kNumber:
+        return MatchNumber(value.number, p);
+    case FieldValue::Kind::kBool:
+        return MatchBool(value.boolean, p);
+    case FieldValue::Kind::kString: {
+        const std::string& s = value.str ? *value.str : value.owned;
+        return MatchString(s.c_str(), s.size(), p);
+    }
+    case FieldValue::Kind::kNone:
+        break;
+    }
+    return false;
+}
+
+CompiledFilter CompiledFilter::Compile(const std::string& filter_str) {
+    CompiledFilter filter;
+    std::vector<uint32_t> groups;
+    for (const auto& part : SplitTopLevel(filter_str, false)) {
+        groups.push_back(filter.CompileExpression(part));
+    }
+    if (groups.empty()) {
+        return CompiledFilter();
+    }
+    filter.root_ = groups.size() == 1 ? groups[0] : filter.AddGroup(NodeKind::kAnd, groups);
+    return filter;
+}
+
+uint32_t CompiledFilter::CompileExpression(const std::string& s) {
+    const std::string expr = trim(s);
+    if (expr.empty()) throw std::runtime_error("Empty expression");
+
+    NodeKind kind = NodeKind::kPredicate;
+    size_t prefix = 0;
+    if (expr.compare(0, 4, "AND(") == 0 && expr.back() == ')') {
+        kind = NodeKind::kAnd;
+        prefix = 4;
+    } else if (expr.compare(0, 3, "OR(") == 0 && expr.back() == ')') {
+        kind = NodeKind::kOr;
+        prefix = 3;
+    }
+
+    if (kind == NodeKind::kPredicate) {
+        predicates_.push_back(ParsePredicate(expr));
+        nodes_.push_back({NodeKind::kPredicate, static_cast<uint32_t>(predicates_.size() - 1), 0});
+        return static_cast<uint32_t>(nodes_.size() - 1);
+    }
+
+    std::vector<uint32_t> children;
+    for (const auto& part : SplitTopLevel(expr.substr(prefix, expr.size() - prefix - 1), true)) {
+        children.push_back(CompileExpression(part));
+    }
+    return AddGroup(kind, children);
+}
+
+uint32_t CompiledFilter::AddGroup(NodeKind kind, const std::vector<uint32_t>& children) {
+    Node node{kind, static_cast<uint32_t>(children_.size()), static_cast<uint32_t>(children.size())};
+    children_.insert(children_.end(), children.begin(), children.end());
+    nodes_.push_back(node);
+    return static_cast<uint32_t>(nodes_.size() - 1);
+}
+
+bool CompiledFilter::Match(const json& feature) const {
+    if (nodes_.empty()) return true;
+
+    const json* properties = nullptr;
+    const json* attributes = nullptr;
+    auto props_it = feature.find("properties");
+    if (props_it != feature.end() && props_it->is_object()) {
+        properties = &*props_it;
+        auto attrs_it = properties->find("attributes");
+        if (attrs_it != properties->end() && attrs_it->is_array()) {
+            attributes = &*attrs_it;
+        }
+    }
+
+    return Evaluate([&](const Predicate& p, uint32_t) {
+        if (!properties) return false;
+
+        // 在 properties 里找
+        auto it = properties->find(p.key);
+        if (it != properties->end() && MatchJsonValue(*it, p)) {
+            return true;
+        }
+
+        // 在 attributes 数组里找
+        if (attributes) {
+            for (const auto& attr : *attributes) {
+                if (!attr.is_object()) continue;
+                auto ait = attr.find(p.key);
+                if (ait != attr.end() && MatchJsonValue(*ait, p)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    });
+}
+
+} // namespace feature_filter
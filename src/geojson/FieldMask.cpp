@@ -0,0 +1,47 @@
+#include "FieldMask.hpp"
+#include "FeatureFilter.hpp"
+#include <algorithm>
+#include <sstream>
+
+namespace converter {
+
+namespace {
+
+std::string trim(const std::string& s) {
+    size_t start = s.find_first_not_of(" \t\n\r");
+    size_t end = s.find_last_not_of(" \t\n\r");
+    return (start == std::string::npos) ? "" : s.substr(start, end - start + 1);
+}
+
+} // namespace
+
+FieldMask FieldMask::Parse(const std::string& list) {
+    FieldMask mask;
+    std::stringstream ss(list);
+    std::string token;
+    while (std::getline(ss, token, ',')) {
+        token = trim(token);
+        if (!token.empty()) mask.Add(token);
+    }
+    return mask;
+}
+
+bool FieldMask::Contains(const std::string& name) const {
+    return std::binary_search(names_.begin(), names_.end(), name);
+}
+
+void FieldMask::Add(const std::string& name) {
+    auto it = std::lower_bound(names_.begin(), names_.end(), name);
+    if (it == names_.end() || *it != name) {
+        names_.insert(it, name);
+    }
+}
+
+void FieldMask::AddFilterKeys(const feature_filter::CompiledFilter& filter) {
+    if (empty()) return;   // 空掩码本来就输出全部字段
+    for (const auto& p : filter.predicates()) {
+        Add(p.key);
+    }
+}
+
+} // namespace converter
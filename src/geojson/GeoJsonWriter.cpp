@@ -0,0 +1,405 @@
+#include "GeoJsonWriter.hpp"
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+namespace converter {
+
+using json = nlohmann::json;
+
+namespace {
+
+// 与 nlohmann 的 serializer::dump_escaped(ensure_ascii = false) 相同
+void AppendEscaped(std::string& out, const char* s, size_t length) {
+    static const char kHex[] = "0123456789abcdef";
+    size_t run = 0;   // 无需转义的连续字节，批量追加
+    for (size_t i = 0; i < length; ++i) {
+        const unsigned char c = static_cast<unsigned char>(s[i]);
+        const char* escape = nullptr;
+        switch (c) {
+        case '\b': escape = "\\b"; break;
+        case '\t': escape = "\\t"; break;
+        case '\n': escape = "\\n"; break;
+        case '\f': escape = "\\f"; break;
+        case '\r': escape = "\\r"; break;
+        case '"':  escape = "\\\""; break;
+        case '\\': escape = "\\\\"; break;
+        default:
+            if (c > 0x1F) {
+                ++run;
+                continue;
+            }
+            break;
+        }
+        out.append(s + i - run, run);
+        run = 0;
+        if (escape) {
+            out.append(escape, 2);
+        } else {
+            const char u[6] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xF]};
+            out.append(u, 6);
+        }
+    }
+    out.append(s + length - run, run);
+}
+
+void AppendUint(std::string& out, uint64_t value) {
+    char buf[20];
+    char* p = buf + sizeof(buf);
+    do {
+        *--p = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    out.append(p, static_cast<size_t>(buf + sizeof(buf) - p));
+}
+
+} // namespace
+
+JsonKey::JsonKey(const char* name)
+    : name_(name),
+      pretty_(JsonWriter::Quote(name_) + ": "),
+      compact_(JsonWriter::Quote(name_) + ":")
+{
+}
+
+std::string JsonWriter::Quote(const char* value, size_t length) {
+    std::string quoted;
+    quoted.reserve(length + 2);
+    quoted += '"';
+    AppendEscaped(quoted, value, length);
+    quoted += '"';
+    return quoted;
+}
+
+JsonWriter::JsonWriter(int indent, int base_level)
+    : indent_(indent),
+      base_level_(base_level)
+{
+}
+
+void JsonWriter::Reset(int indent, int base_level) {
+    indent_ = indent;
+    base_level_ = base_level;
+    after_key_ = false;
+    stack_.clear();
+    out_.clear();
+}
+
+void JsonWriter::NewLine(size_t depth) {
+    if (indent_ < 0) return;
+    out_ += '\n';
+    out_.append(static_cast<size_t>(indent_) * (static_cast<size_t>(base_level_) + depth), ' ');
+}
+
+void JsonWriter::BeforeValue() {
+    if (after_key_) {
+        after_key_ = false;
+        return;
+    }
+    if (stack_.empty()) return;   // 顶层值
+
+    // 数组元素
+    Level& top = stack_.back();
+    if (!top.empty) out_ += ',';
+    top.empty = false;
+    NewLine(stack_.size());
+}
+
+void JsonWriter::BeginObject() {
+    BeforeValue();
+    out_ += '{';
+    stack_.push_back({true});
+}
+
+void JsonWriter::EndObject() {
+    const bool empty = stack_.back().empty;
+    stack_.pop_back();
+    if (!empty) NewLine(stack_.size());
+    out_ += '}';
+}
+
+void JsonWriter::BeginArray() {
+    BeforeValue();
+    out_ += '[';
+    stack_.push_back({true});
+}
+
+void JsonWriter::EndArray() {
+    const bool empty = stack_.back().empty;
+    stack_.pop_back();
+    if (!empty) NewLine(stack_.size());
+    out_ += ']';
+}
+
+void JsonWriter::Key(const char* key, size_t length) {
+    Level& top = stack_.back();
+    if (!top.empty) out_ += ',';
+    top.empty = false;
+    NewLine(stack_.size());
+    out_ += '"';
+    AppendEscaped(out_, key, length);
+    out_.append(indent_ < 0 ? "\":" : "\": ");
+    after_key_ = true;
+}
+
+void JsonWriter::Key(const JsonKey& key) {
+    Level& top = stack_.back();
+    if (!top.empty) out_ += ',';
+    top.empty = false;
+    NewLine(stack_.size());
+    out_ += key.token(indent_ < 0);
+    after_key_ = true;
+}
+
+void JsonWriter::String(const char* value, size_t length) {
+    BeforeValue();
+    out_ += '"';
+    AppendEscaped(out_, value, length);
+    out_ += '"';
+}
+
+void JsonWriter::Bool(bool value) {
+    BeforeValue();
+    if (value) out_.append("true", 4);
+    else out_.append("false", 5);
+}
+
+void JsonWriter::Int(int64_t value) {
+    BeforeValue();
+    if (value < 0) {
+        out_ += '-';
+        AppendUint(out_, 0 - static_cast<uint64_t>(value));
+    } else {
+        AppendUint(out_, static_cast<uint64_t>(value));
+    }
+}
+
+void JsonWriter::Uint(uint64_t value) {
+    BeforeValue();
+    AppendUint(out_, value);
+}
+
+void JsonWriter::Double(double value) {
+    BeforeValue();
+    if (!std::isfinite(value)) {
+        out_.append("null", 4);
+        return;
+    }
+    // 与 nlohmann 相同的 Grisu2 最短表示
+    std::array<char, 64> buf;
+    char* end = nlohmann::detail::to_chars(buf.data(), buf.data() + buf.size(), value);
+    out_.append(buf.data(), static_cast<size_t>(end - buf.data()));
+}
+
+void JsonWriter::Fixed(int64_t scaled, int precision) {
+    BeforeValue();
+    uint64_t magnitude = static_cast<uint64_t>(scaled);
+    if (scaled < 0) {
+        out_ += '-';
+        magnitude = 0 - magnitude;
+    }
+
+    uint64_t pow10 = 1;
+    for (int i = 0; i < precision; ++i) pow10 *= 10;
+    AppendUint(out_, magnitude / pow10);
+    out_ += '.';
+
+    uint64_t frac = magnitude % pow10;
+    if (frac == 0) {
+        out_ += '0';
+        return;
+    }
+    int digits = precision;
+    while (frac % 10 == 0) {
+        frac /= 10;
+        --digits;
+    }
+    char buf[20];
+    for (int i = digits - 1; i >= 0; --i) {
+        buf[i] = static_cast<char>('0' + frac % 10);
+        frac /= 10;
+    }
+    out_.append(buf, static_cast<size_t>(digits));
+}
+
+void JsonWriter::Null() {
+    BeforeValue();
+    out_.append("null", 4);
+}
+
+void JsonWriter::Value(const json& value) {
+    switch (value.type()) {
+    case json::value_t::object:
+        BeginObject();
+        for (auto it = value.begin(); it != value.end(); ++it) {
+            Key(it.key());
+            Value(it.value());
+        }
+        EndObject();
+        break;
+    case json::value_t::array:
+        BeginArray();
+        for (const auto& element : value) Value(element);
+        EndArray();
+        break;
+    case json::value_t::string:
+        String(value.get_ref<const std::string&>());
+        break;
+    case json::value_t::boolean:
+        Bool(value.get<bool>());
+        break;
+    case json::value_t::number_integer:
+        Int(value.get<int64_t>());
+        break;
+    case json::value_t::number_unsigned:
+        Uint(value.get<uint64_t>());
+        break;
+    case json::value_t::number_float:
+        Double(value.get<double>());
+        break;
+    default:
+        // null / discarded；converter 不会产生 binary
+        Null();
+        break;
+    }
+}
+
+// ------------------------- FeatureChunk -------------------------
+
+FeatureChunk::FeatureChunk(int indent)
+    : indent_(indent),
+      writer_(indent, 2)
+{
+}
+
+JsonWriter& FeatureChunk::BeginFeature() {
+    std::string& buf = writer_.buffer();
+    if (count_ > 0) {
+        buf += ',';
+        if (indent_ >= 0) {
+            buf += '\n';
+            buf.append(static_cast<size_t>(indent_) * 2, ' ');
+        }
+    }
+    ++count_;
+    return writer_;
+}
+
+// ------------------------- FeatureCollectionWriter -------------------------
+
+FeatureCollectionWriter::FeatureCollectionWriter(const std::string& path, int indent)
+    : file_(path, std::ios::out | std::ios::trunc | std::ios::binary),
+      out_(&file_),
+      indent_(indent),
+      writer_(indent, 2)
+{
+    if (!file_.is_open()) {
+        throw std::runtime_error("Failed to open GeoJSON file for writing: " + path);
+    }
+}
+
+FeatureCollectionWriter::FeatureCollectionWriter(std::ostream& out, int indent)
+    : out_(&out),
+      indent_(indent),
+      writer_(indent, 2)
+{
+}
+
+FeatureCollectionWriter::~FeatureCollectionWriter() {
+    try {
+        Close();
+    } catch (...) {
+    }
+}
+
+JsonWriter& FeatureCollectionWriter::BeginFeature() {
+    // 第一个要素前写 FeatureCollection 的开头，之后只写分隔符
+    std::string& buf = writer_.buffer();
+    if (count_ == 0) {
+        buf += indent_ < 0 ? "{\"features\":[" : "{";
+    } else {
+        buf += ',';
+    }
+    if (indent_ >= 0) {
+        if (count_ == 0) {
+            buf += '\n';
+            buf.append(static_cast<size_t>(indent_), ' ');
+            buf += "\"features\": [";
+        }
+        buf += '\n';
+        buf.append(static_cast<size_t>(indent_) * 2, ' ');
+    }
+    ++count_;
+    return writer_;
+}
+
+void FeatureCollectionWriter::AppendFeature(const json& feature) {
+    BeginFeature().Value(feature);
+    EndFeature();
+}
+
+void FeatureCollectionWriter::AppendChunk(const FeatureChunk& chunk) {
+    if (chunk.feature_count() == 0) return;
+    // 第一个要素的分隔符由 BeginFeature 写入，其余要素之间的分隔符已在 chunk 中
+    BeginFeature().Raw(chunk.buffer().data(), chunk.buffer().size());
+    count_ += chunk.feature_count() - 1;
+}
+
+void FeatureCollectionWriter::Write(const std::string& data) {
+    out_->write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!out_->good()) {
+        throw std::runtime_error("Failed to write GeoJSON to file");
+    }
+    bytes_written_ += data.size();
+}
+
+void FeatureCollectionWriter::CommitTile() {
+    Write(writer_.buffer());
+    writer_.buffer().clear();
+    committed_count_ = count_;
+}
+
+void FeatureCollectionWriter::RollbackTile() {
+    writer_.buffer().clear();
+    count_ = committed_count_;
+}
+
+void FeatureCollectionWriter::AddMember(const std::string& key, const std::string& value) {
+    members_.emplace_back(key, value);
+}
+
+void FeatureCollectionWriter::Close() {
+    if (closed_) return;
+    closed_ = true;
+    CommitTile();
+
+    // 额外成员只能在 features 之后写出（此时才完整），所以不再与 dump() 的键顺序一致
+    std::string tail;
+    if (indent_ < 0) {
+        tail = count_ == 0 ? "{\"features\":[]," : "],";
+        for (const auto& member : members_) {
+            tail += '"';
+            AppendEscaped(tail, member.first.data(), member.first.size());
+            tail += "\":" + member.second + ",";
+        }
+        tail += "\"type\":\"FeatureCollection\"}";
+    } else {
+        const std::string pad(static_cast<size_t>(indent_), ' ');
+        if (count_ == 0) {
+            tail = "{\n" + pad + "\"features\": [],\n";
+        } else {
+            tail = "\n" + pad + "],\n";
+        }
+        for (const auto& member : members_) {
+            tail += pad + '"';
+            AppendEscaped(tail, member.first.data(), member.first.size());
+            tail += "\": " + member.second + ",\n";
+        }
+        tail += pad + "\"type\": \"FeatureCollection\"\n}";
+    }
+    Write(tail);
+    out_->flush();
+    if (file_.is_open()) file_.close();
+}
+
+} // namespace converter
@@ -0,0 +1,188 @@
+// GeometryEncoding.cpp
+#include "GeometryEncoding.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace utils {
+
+using json = nlohmann::json;
+
+namespace {
+
+// Flexible Polyline 的 varint：每 5 位一个字符，0x20 表示后面还有
+void AppendFlexUnsigned(std::string& out, uint64_t value) {
+    static const char kTable[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    while (value > 0x1F) {
+        out += kTable[(value & 0x1F) | 0x20];
+        value >>= 5;
+    }
+    out += kTable[value];
+}
+
+void AppendFlexSigned(std::string& out, int64_t value) {
+    uint64_t encoded = static_cast<uint64_t>(value) << 1;
+    if (value < 0) encoded = ~encoded;
+    AppendFlexUnsigned(out, encoded);
+}
+
+// zigzag + LEB128
+void AppendVarint(std::string& out, int64_t value) {
+    uint64_t encoded = (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    while (encoded >= 0x80) {
+        out += static_cast<char>((encoded & 0x7F) | 0x80);
+        encoded >>= 7;
+    }
+    out += static_cast<char>(encoded);
+}
+
+void Base64(const std::string& bytes, std::string& out) {
+    static const char kTable[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    out.clear();
+    out.reserve((bytes.size() + 2) / 3 * 4);
+    size_t i = 0;
+    for (; i + 3 <= bytes.size(); i += 3) {
+        const uint32_t v = (static_cast<uint8_t>(bytes[i]) << 16) |
+                           (static_cast<uint8_t>(bytes[i + 1]) << 8) |
+                           static_cast<uint8_t>(bytes[i + 2]);
+        out += kTable[(v >> 18) & 0x3F];
+        out += kTable[(v >> 12) & 0x3F];
+        out += kTable[(v >> 6) & 0x3F];
+        out += kTable[v & 0x3F];
+    }
+    const size_t rest = bytes.size() - i;
+    if (rest > 0) {
+        uint32_t v = static_cast<uint8_t>(bytes[i]) << 16;
+        if (rest == 2) v |= static_cast<uint8_t>(bytes[i + 1]) << 8;
+        out += kTable[(v >> 18) & 0x3F];
+        out += kTable[(v >> 12) & 0x3F];
+        out += rest == 2 ? kTable[(v >> 6) & 0x3F] : '=';
+        out += '=';
+    }
+}
+
+} // namespace
+
+GeometryEncoding ParseGeometryEncoding(const std::string& name) {
+    if (name.empty() || name == "geojson") return GeometryEncoding::kGeoJson;
+    if (name == "flexpolyline") return GeometryEncoding::kFlexPolyline;
+    if (name == "delta64") return GeometryEncoding::kDelta64;
+    throw std::invalid_argument("Unknown geometry encoding: " + name);
+}
+
+const char* GeometryEncodingName(GeometryEncoding encoding) {
+    switch (encoding) {
+    case GeometryEncoding::kFlexPolyline: return "flexpolyline";
+    case GeometryEncoding::kDelta64: return "delta64";
+    default: return "geojson";
+    }
+}
+
+PolylineEncoder::PolylineEncoder(GeometryEncoding encoding, uint32_t world_bits, int precision)
+    : encoding_(encoding),
+      world_bits_(world_bits),
+      precision_(precision < 0 ? kDefaultPolylinePrecision : precision),
+      lng0_(180 * static_cast<int64_t>(Pow10(precision_))),
+      lat0_(90 * static_cast<int64_t>(Pow10(precision_)))
+{
+}
+
+void PolylineEncoder::Clear() {
+    prev_x_ = 0;
+    prev_y_ = 0;
+    out_.clear();
+    bytes_.clear();
+    if (encoding_ == GeometryEncoding::kFlexPolyline) {
+        // 头部：版本 1；precision，无第三维
+        AppendFlexUnsigned(out_, 1);
+        AppendFlexUnsigned(out_, static_cast<uint64_t>(precision_));
+    }
+}
+
+void PolylineEncoder::Add(uint64_t world_x, uint64_t world_y) {
+    if (encoding_ == GeometryEncoding::kFlexPolyline) {
+        // prev_x_ / prev_y_ 为上一点的 lng / lat 定点值，先写 lat 再写 lng
+        const int64_t lng = WorldToFixed(world_x, world_bits_, precision_) - lng0_;
+        const int64_t lat = WorldToFixed(world_y, world_bits_, precision_) - lat0_;
+        AppendFlexSigned(out_, lat - prev_y_);
+        AppendFlexSigned(out_, lng - prev_x_);
+        prev_x_ = lng;
+        prev_y_ = lat;
+    } else {
+        const int64_t x = static_cast<int64_t>(world_x);
+        const int64_t y = static_cast<int64_t>(world_y);
+        AppendVarint(bytes_, x - prev_x_);
+        AppendVarint(bytes_, y - prev_y_);
+        prev_x_ = x;
+        prev_y_ = y;
+    }
+}
+
+const std::string& PolylineEncoder::Finish() {
+    if (encoding_ != GeometryEncoding::kDelta64) return out_;
+    Base64(bytes_, out_);
+    return out_;
+}
+
+void PolylineEncoder::AddPiece(const std::vector<WorldPoint>& piece) {
+    Clear();
+    for (const auto& p : piece) {
+        Add(static_cast<uint64_t>(std::max<int64_t>(p.x, 0)), static_cast<uint64_t>(std::max<int64_t>(p.y, 0)));
+    }
+}
+
+json PolylineEncoder::ToGeometry() {
+    json geometry;
+    if (encoding_ == GeometryEncoding::kDelta64) geometry["bits"] = world_bits_;
+    geometry["encoded"] = Finish();
+    geometry["encoding"] = GeometryEncodingName(encoding_);
+    geometry["type"] = "LineString";
+    return geometry;
+}
+
+void PolylineEncoder::WriteGeometry(converter::JsonWriter& w) {
+    w.BeginObject();
+    if (encoding_ == GeometryEncoding::kDelta64) w.Field("bits", world_bits_);
+    w.Field("encoded", Finish());
+    w.Field("encoding", GeometryEncodingName(encoding_));
+    w.Field("type", "LineString");
+    w.EndObject();
+}
+
+json PolylineEncoder::ToGeometry(const std::vector<std::vector<WorldPoint>>& pieces) {
+    if (pieces.size() == 1) {
+        AddPiece(pieces.front());
+        return ToGeometry();
+    }
+    json geometry;
+    if (encoding_ == GeometryEncoding::kDelta64) geometry["bits"] = world_bits_;
+    geometry["encoded"] = json::array();
+    for (const auto& piece : pieces) {
+        AddPiece(piece);
+        geometry["encoded"].push_back(Finish());
+    }
+    geometry["encoding"] = GeometryEncodingName(encoding_);
+    geometry["type"] = "MultiLineString";
+    return geometry;
+}
+
+void PolylineEncoder::WriteGeometry(converter::JsonWriter& w, const std::vector<std::vector<WorldPoint>>& pieces) {
+    if (pieces.size() == 1) {
+        AddPiece(pieces.front());
+        WriteGeometry(w);
+        return;
+    }
+    w.BeginObject();
+    if (encoding_ == GeometryEncoding::kDelta64) w.Field("bits", world_bits_);
+    w.Key("encoded");
+    w.BeginArray();
+    for (const auto& piece : pieces) {
+        AddPiece(piece);
+        w.String(Finish());
+    }
+    w.EndArray();
+    w.Field("encoding", GeometryEncodingName(encoding_));
+    w.Field("type", "MultiLineString");
+    w.EndObject();
+}
+
+} // namespace utils
@@ -5,36 +5,84 @@ namespace utils {
 
 using json = nlohmann::json;
 
+void AppendCoordinates(json& coordinates, const CoordinateDecoder& decoder,
+                       const uint32_t* xy, size_t count, int precision, CoordinateBuffer& buffer)
+{
+    auto& points = coordinates.get_ref<json::array_t&>();
+    points.reserve(points.size() + count);
+    if (precision < 0) {
+        buffer.lng.resize(count);
+        buffer.lat.resize(count);
+        if (count > 0) decoder.Decode(xy, count, buffer.lng.data(), buffer.lat.data());
+        for (size_t k = 0; k < count; ++k) {
+            points.push_back({ buffer.lng[k], buffer.lat[k] });
+        }
+    } else {
+        buffer.lng_fixed.resize(count);
+        buffer.lat_fixed.resize(count);
+        if (count > 0) decoder.DecodeFixed(xy, count, precision, buffer.lng_fixed.data(), buffer.lat_fixed.data());
+        for (size_t k = 0; k < count; ++k) {
+            points.push_back({ FixedToDouble(buffer.lng_fixed[k], precision),
+                               FixedToDouble(buffer.lat_fixed[k], precision) });
+        }
+    }
+}
+
+void AppendCoordinates(json& coordinates, const CoordinateDecoder& decoder,
+                       const LineString& line_string, int precision, CoordinateBuffer& buffer)
+{
+    AppendCoordinates(coordinates, decoder, line_string.xy_coords().data(),
+                      static_cast<size_t>(line_string.xy_coords_size()) / 2, precision, buffer);
+}
+
+void WriteCoordinates(converter::JsonWriter& w, const CoordinateDecoder& decoder,
+                      const uint32_t* xy, size_t count, int precision, CoordinateBuffer& buffer)
+{
+    if (precision < 0) {
+        buffer.lng.resize(count);
+        buffer.lat.resize(count);
+        if (count > 0) decoder.Decode(xy, count, buffer.lng.data(), buffer.lat.data());
+        for (size_t k = 0; k < count; ++k) {
+            w.BeginArray();
+            w.Double(buffer.lng[k]);
+            w.Double(buffer.lat[k]);
+            w.EndArray();
+        }
+    } else {
+        buffer.lng_fixed.resize(count);
+        buffer.lat_fixed.resize(count);
+        if (count > 0) decoder.DecodeFixed(xy, count, precision, buffer.lng_fixed.data(), buffer.lat_fixed.data());
+        for (size_t k = 0; k < count; ++k) {
+            w.BeginArray();
+            w.Fixed(buffer.lng_fixed[k], precision);
+            w.Fixed(buffer.lat_fixed[k], precision);
+            w.EndArray();
+        }
+    }
+}
+
+void WriteCoordinates(converter::JsonWriter& w, const CoordinateDecoder& decoder,
+                      const LineString& line_string, int precision, CoordinateBuffer& buffer)
+{
+    WriteCoordinates(w, decoder, line_string.xy_coords().data(),
+                     static_cast<size_t>(line_string.xy_coords_size()) / 2, precision, buffer);
+}
+
 json ExtractGeometry(
-    const com::here::platform::schema::clientmap::v1::layers::common::LineString& line_string,
+    const LineString& line_string,
     const olp::geo::TileKey& kTileKey,
     uint32_t world_coordinate_bits,
-    json geometry) 
+    int precision) 
 {
-    int level = 14;
-    //json geometry;
+    json geometry;
     geometry["type"] = "LineString";
     geometry["coordinates"] = json::array();
 
-    int num_coords = line_string.xy_coords_size();
-    for (int j = 0; j < num_coords; j += 2) {
-        if (j + 1 >= num_coords) break;
-
-        uint32_t x_coord = line_string.xy_coords(j);
-        uint32_t y_coord = line_string.xy_coords(j + 1);
-
-        uint32_t I_LNG_TILE = kTileKey.Column() << (world_coordinate_bits - level);
-        uint32_t I_LNG = I_LNG_TILE + x_coord;
-        double LNG = (I_LNG * 360.0) / (1 << world_coordinate_bits) - 180.0;
-
-        uint32_t I_LAT_TILE = kTileKey.Row() << (world_coordinate_bits - level);
-        uint32_t I_LAT = I_LAT_TILE + y_coord;
-        double LAT = (I_LAT * 360.0) / (1 << world_coordinate_bits) - 90.0;
-
-        geometry["coordinates"].push_back({ LNG, LAT });
-    }
+    CoordinateBuffer buffer;
+    const CoordinateDecoder decoder(kTileKey, world_coordinate_bits, kRenderingGeometryLevel);
+    AppendCoordinates(geometry["coordinates"], decoder, line_string, precision, buffer);
 
     return geometry;
 }
 
-} // namespace utils
\ No newline at end of file
+} // namespace utils
@@ -1,12 +1,22 @@
 #include "ISADataToGeoJsonConverter.hpp"
 #include "TimeDomainParser.hpp"
 #include "TileIDConverter.hpp"
+#include "TileArena.hpp"
 #include <olp/core/logging/Log.h>
 #include <fstream>
 #include <cmath>
 #include <sstream>
+#include <algorithm>
+#include <iterator>
 #include <LayerFinder.hpp>
 #include "GeometryUtils.hpp" 
+#include "FeatureFilter.hpp"
+#include "SpatialClip.hpp"
+#include "LineSimplifier.hpp"
+#include "GeoJsonWriter.hpp"
+#include "AttributeTables.hpp"
+#include "NodeIndex.hpp"
+#include "IsaTileView.hpp"
 #include "here-devel/com/here/platform/schema/clientmap/v1/layers/SegmentAttributeLayer.pb.h"
 #include "here-devel/com/here/platform/schema/clientmap/v1/layers/common/AccessBitMask.pb.h"
 #include "here-devel/com/here/platform/schema/clientmap/v1/layers/common/SpecialSpeedSituation.pb.h"
@@ -20,7 +30,6 @@
 #include "here-devel/com/here/platform/schema/clientmap/v1/layers/common/SpecialTrafficAreaCategory.pb.h"
 #include "here-devel/com/here/platform/schema/clientmap/v1/layers/common/RoadUsageBitMask.pb.h"
 #include "here-devel/com/here/platform/schema/clientmap/v1/layers/common/TimeDomainDescription.pb.h"
-#include <unordered_map>
 #include "google/protobuf/util/json_util.h" 
 
 // 如果你需要 boost::algorithm::join，取消下面注释并添加到 cmake/link libs
@@ -36,32 +45,12 @@ using json = nlohmann::json;
 using namespace com::here::platform::schema::clientmap::v1::layers::common;
 
 
-struct CoordHash {
-    std::size_t operator()(uint64_t key) const {
-        return std::hash<uint64_t>()(key);
-    }
-};
-
-using CoordKey = uint64_t;
-
-CoordKey makeCoordKey(uint32_t x, uint32_t y) {
-    return (static_cast<uint64_t>(x) << 32) | y;
-}
-
-std::unordered_map<CoordKey, const layers::NodeLayer::Node*> buildNodeMap(
-    const layers::NodeLayer& layer)
+// 线的起点所在 node 中，与 seg 对应的 segment end 的 is_segment_start；-1 表示没有找到
+template <typename Segment>
+int8_t FindSegmentStart(const utils::SegmentStartIndex& nodeIndex,
+                        uint32_t x_coord, uint32_t y_coord, const Segment& seg)
 {
-    std::unordered_map<CoordKey, const layers::NodeLayer::Node*> nodeMap;
-    for (const auto& node : layer.nodes()) {
-        CoordKey key = makeCoordKey(node.x(), node.y());
-        nodeMap[key] = &node;
-        /*
-                std::cout << "Node key: " << key 
-                  << " (x=" << node.x() << ", y=" << node.y() << ")"
-                  << " ptr=" << &node << std::endl;
-                  */
-    }
-    return nodeMap;
+    return nodeIndex.Find(x_coord, y_coord, static_cast<uint64_t>(seg.local_id()), static_cast<uint64_t>(seg.host_tile_id()));
 }
 
 const layers::NodeLayer::Segment* getSegmentByIndex(const layers::NodeLayer& layer, size_t index) {
@@ -71,106 +60,28 @@ const layers::NodeLayer::Segment* getSegmentByIndex(const layers::NodeLayer& lay
     return nullptr;
 }
 
-static constexpr uint32_t LOCAL_ROAD_EMPTY      = 0;
-static constexpr uint32_t FRONTAGE              = 1u << 0; // 1
-static constexpr uint32_t PARKING_LOT_ROAD      = 1u << 1; // 2
-static constexpr uint32_t POI_ACCESS            = 1u << 2; // 4
-
-
-// bitmask -> json
+// bitmask -> json（名称表见 AttributeTables.hpp）
 inline json LocalRoadBitmaskToJson(uint32_t mask) {
-    json j;
-    j["raw"] = mask;
-
-    // active names 数组（便于人读）
-    json active = json::array();
-    if (mask & FRONTAGE) active.push_back("FRONTAGE");
-    if (mask & PARKING_LOT_ROAD) active.push_back("PARKING_LOT_ROAD");
-    if (mask & POI_ACCESS) active.push_back("POI_ACCESS");
-    j["active"] = active;
-
-    // 是否为空（所有位都为 0）
-    j["is_empty"] = (mask == LOCAL_ROAD_EMPTY);
-
-    return j;
+    return converter::LocalRoadFlagNames().ObjectJson(mask);
 }
 
 inline json RoadUsageBitMaskToJson(uint32_t mask) {
-    static const struct { uint32_t bit; const char* name; } kFlags[] = {
-        {1,   "CARPOOL_ROAD"},
-        {2,   "CONTROLLED_ACCESS"},
-        {4,   "EXPRESS_LANE"},
-        {8,   "LIMITED_ACCESS"},
-        {16,  "PRIORITY_ROAD"},
-        {32,  "RAMP"},
-        {64,  "REVERSIBLE"},
-        {128, "TOLLWAY"},
-        {256, "DIMINISHED_PRIORITY"},
-        {512, "PUBLIC_ACCESS"}
-    };
-
-    json j;
-    j["raw"] = mask;
-   // j["flags"] = json::object();
-    json active = json::array();
-
-    for (const auto& f : kFlags) {
-        bool set = (mask & f.bit) != 0;
-       // j["flags"][f.name] = set;
-        if (set) active.push_back(f.name);
-    }
-
-    j["active"] = active;
-    j["is_empty"] = (mask == 0);
-    return j;
+    return converter::RoadUsageFlagNames().ObjectJson(mask);
 }
 
-
 inline json PhysicalBitMaskToJson(uint32_t mask) {
-    static const struct { uint32_t bit; const char* name; } kFlags[] = {
-        {1,  "BOAT_FERRY"},
-        {2,  "BRIDGE"},
-        {4,  "MULTIPLY_DIGITIZED"},
-        {8,  "PAVED"},
-        {16, "PRIVATE"},
-        {32, "RAIL_FERRY"},
-        {64, "TUNNEL"},
-        {128,"DELIVERY_ROAD"},
-        {256,"MOVABLE_BRIDGE"}
-    };
-
-    json j;
-    j["raw"] = mask;
-   // j["flags"] = json::object();
-    json active = json::array();
-
-    for (const auto& f : kFlags) {
-        bool set = (mask & f.bit) != 0;
-       // j["flags"][f.name] = set;
-        if (set) active.push_back(f.name);
-    }
-
-    j["active"] = active;
-    j["is_empty"] = (mask == 0);
-    return j;
+    return converter::PhysicalFlagNames().ObjectJson(mask);
 }
 
 // 小工具：bitmask 转数组
-json bitmaskToJson(uint32_t mask) {
-    json arr = json::array();
-    if (mask & AccessBitMask::AUTOMOBILES) arr.push_back("AUTOMOBILES");
-    if (mask & AccessBitMask::BUSES) arr.push_back("BUSES");
-    if (mask & AccessBitMask::TRUCKS) arr.push_back("TRUCKS");
-    if (mask & AccessBitMask::PEDESTRIANS) arr.push_back("PEDESTRIANS");
-    if (mask & AccessBitMask::MOTORCYCLES) arr.push_back("MOTORCYCLES");
-    // ... 其他 bitmask
-    return arr;
+const json& bitmaskToJson(uint32_t mask) {
+    return converter::AccessFlagNames().Json(mask);
 }
 
 // 转换 TimedAccess
-json convert_timed_access(const TimedAccess& t) {
+json convert_timed_access(const TimedAccess& t, bool raw) {
     json j;
-    j["applies_to"] = bitmaskToJson(t.applies_to());
+    j["applies_to"] = raw ? json(t.applies_to()) : bitmaskToJson(t.applies_to());
 
     // 2. applies_during (直接是 string 列表)
     j["applies_during"] = json::array();
@@ -188,9 +99,10 @@ json convert_timed_access(const TimedAccess& t) {
 }
 
 // 转换 SpecialSpeedSituation
-json convert_special_speed(const SpecialSpeedSituation& s) {
+json convert_special_speed(const SpecialSpeedSituation& s, bool raw) {
     json j;
-    j["special_speed_type"] = SpecialSpeedSituation::SpecialSpeedType_Name(s.special_speed_type());
+    j["special_speed_type"] = raw ? json(s.special_speed_type())
+                                  : json(converter::SpecialSpeedTypeNames().Name(s.special_speed_type()));
     j["special_speed_limit"] = s.special_speed_limit();
     j["applies_during"] = s.applies_during();
     const auto& periods = s.applies_during();
@@ -218,7 +130,8 @@ json convertInternal(
     //const clientmap::decoder::SegmentIdMappingLayer& segIdMapLayer,
     const olp::geo::TileKey& tile_key,
     const std::string& output_path,
-    const uint32_t& world_bits);
+    const uint32_t& world_bits,
+    const converter::ConvertOptions& options);
 
 
 constexpr auto kLogTag = "ISADataToGeoJsonConverter";
@@ -230,58 +143,42 @@ constexpr auto kLogTag = "ISADataToGeoJsonConverter";
 // 辅助函数：将枚举转换为字符串
 
 inline json SpeedLimitRainingBitMaskToJson(uint32_t mask) {
-    // ⚠️ 这里要根据 proto 实际枚举值补全
-    static const struct { uint32_t bit; const char* name; } kFlags[] = {
-        {1, "MAX_SPEED_RAINING_EMPTY"},
-        {2, "MOTORWAYS_AND_CONTROLLED_ACCESS_ROADS_LIMIT_110_KMH"}
-        // ... 继续补充其它枚举值
-    };
-
-    json j;
-    j["raw"] = mask;
-   // j["flags"] = json::object();
-    json active = json::array();
-
-    for (const auto& f : kFlags) {
-        bool set = (mask & f.bit) != 0;
-     //   j["flags"][f.name] = set;
-        if (set) active.push_back(f.name);
-    }
-
-    j["active"] = active;
-    j["is_empty"] = (mask == 0);
-    return j;
+    return converter::SpeedLimitRainingFlagNames().ObjectJson(mask);
 }
 
 // 对应 proto 中的 ParkingSideBitMask
-
 inline json ParkingSideBitMaskToJson(uint32_t mask) {
-    static const struct { uint32_t bit; const char* name; } kFlags[] = {
-        {1, "BOTH_SIDES_ONE_WAY_ROAD"},
-        {2, "OPPOSITE_LANE_TWO_WAY_ROAD"}
-    };
+    return converter::ParkingSideFlagNames().ObjectJson(mask);
+}
 
-    json j;
-    j["raw"] = mask;
-    //j["flags"] = json::object();
-    json active = json::array();
+// valid_at: 在指定时刻不生效的条目不输出；seasonal_applies_during 非空时也须生效
+bool applies_at(const TimeDomainParser::ValidityFilter* validAt, const TimedAccess& t) {
+    return !validAt || (validAt->AppliesAny(t.applies_during()) && validAt->AppliesAny(t.seasonal_applies_during()));
+}
 
-    for (const auto& f : kFlags) {
-        bool set = (mask & f.bit) != 0;
-      //  j["flags"][f.name] = set;
-        if (set) active.push_back(f.name);
-    }
+bool applies_at(const TimeDomainParser::ValidityFilter* validAt, const SpecialSpeedSituation& s) {
+    return !validAt || validAt->AppliesAny(s.applies_during());
+}
 
-    j["active"] = active;
-    j["is_empty"] = (mask == 0);
-    return j;
+bool applies_at(const TimeDomainParser::ValidityFilter* validAt, const UsageFeeRequired& u) {
+    return !validAt || validAt->AppliesAny(u.applies_during());
+}
+
+bool applies_at(const TimeDomainParser::ValidityFilter*, const EnvironmentalZoneCondition&) {
+    return true;
 }
 
-json convert_usage_fee(const UsageFeeRequired& u) {
+json convert_usage_fee(const UsageFeeRequired& u, bool raw) {
     json j;
-    j["toll_feature_type"] = UsageFeeRequired::TollFeatureType_Name(u.toll_feature_type());
-    j["relative_direction"] = RelativeDirection_Name(u.relative_direction());
-    j["applies_to"] = bitmaskToJson(u.applies_to());
+    if (raw) {
+        j["toll_feature_type"] = u.toll_feature_type();
+        j["relative_direction"] = u.relative_direction();
+        j["applies_to"] = u.applies_to();
+    } else {
+        j["toll_feature_type"] = converter::TollFeatureTypeNames().Name(u.toll_feature_type());
+        j["relative_direction"] = converter::RelativeDirectionNames().Name(u.relative_direction());
+        j["applies_to"] = bitmaskToJson(u.applies_to());
+    }
 
     // 时间限制（可能为空）
     json arr = json::array();
@@ -292,146 +189,259 @@ json convert_usage_fee(const UsageFeeRequired& u) {
     return j;
 }
 
-std::string builtUpAreaToString(BuiltUpArea b) {
+const std::string& builtUpAreaToString(BuiltUpArea b) {
+    static const std::string kNames[] = {
+        "BUILT_UP_AREA_UNKNOWN", "BUILT_UP_AREA_YES", "BUILT_UP_AREA_NO",
+        "BUILT_UP_AREA_YES_VERIFIED", "BUILT_UP_AREA_NO_VERIFIED", "UNKNOWN"
+    };
     switch (b) {
-        case BUILT_UP_AREA_UNKNOWN: return "BUILT_UP_AREA_UNKNOWN";
-        case BUILT_UP_AREA_YES: return "BUILT_UP_AREA_YES";
-        case BUILT_UP_AREA_NO: return "BUILT_UP_AREA_NO";
-        case BUILT_UP_AREA_YES_VERIFIED: return "BUILT_UP_AREA_YES_VERIFIED";
-        case BUILT_UP_AREA_NO_VERIFIED: return "BUILT_UP_AREA_NO_VERIFIED";
-        default: return "UNKNOWN";
+        case BUILT_UP_AREA_UNKNOWN: return kNames[0];
+        case BUILT_UP_AREA_YES: return kNames[1];
+        case BUILT_UP_AREA_NO: return kNames[2];
+        case BUILT_UP_AREA_YES_VERIFIED: return kNames[3];
+        case BUILT_UP_AREA_NO_VERIFIED: return kNames[4];
+        default: return kNames[5];
     }
 }
 
-json convert_env_zone(const EnvironmentalZoneCondition& e) {
+json convert_env_zone(const EnvironmentalZoneCondition& e, bool raw) {
     json j;
     j["environmental_zone_id"] = e.environmental_zone_id();
-    j["applies_to"] = bitmaskToJson(e.applies_to());
+    j["applies_to"] = raw ? json(e.applies_to()) : bitmaskToJson(e.applies_to());
     return j;
 }
 
-json ISADataToGeoJsonConverter::convert(const datastore::Response< datastore::TileLoadResult >& response, const olp::geo::TileKey &tile_key, const std::string& outPath)
-{
+// ------------------------- 过滤下推 -------------------------
+// 字段与 convert_attribute / convertInternal 输出中的标量字段一一对应（取最终写入的值）
 
+using AttributeRecord = clientmap::decoder::IsaSegmentAttributeLayer::Attributes;
+using AttributeRecordRange = google::protobuf::RepeatedPtrField<AttributeRecord>;
 
-    const auto& layer_results = response.GetResult().GetLayersResults();
+struct SegmentRecord {
+    uint64_t tile_id;
+    uint64_t local_id;
+    double length;
+    uint64_t host_tile_id;
+};
 
-    ocm::LayerFinder finder(layer_results);
+using feature_filter::ToFieldValue;
 
-    const auto* isaSegmentLayer = finder.TryGetLayer<clientmap::decoder::IsaSegmentLayer>(clientmap::isa::kIsaSegmentLayerName);
-    const auto* isaSegmenAttributetLayer = finder.TryGetLayer<clientmap::decoder::IsaSegmentAttributeLayer>(clientmap::isa::kIsaSegmentAttributeLayerName);
-    const auto* isaGeometryLayer = finder.TryGetLayer<clientmap::decoder::IsaSegmentGeometryLayer>(clientmap::isa::kIsaSegmentGeometryLayerName);
+template <typename Segment>
+SegmentRecord MakeSegmentRecord(uint64_t tile_id, const Segment& seg) {
+    return SegmentRecord{tile_id, static_cast<uint64_t>(seg.local_id()),
+                         static_cast<double>(seg.meter_length()), static_cast<uint64_t>(seg.host_tile_id())};
+}
 
-    const auto* isaForeignSegmentGeometryLayer = finder.TryGetLayer<clientmap::decoder::IsaForeignSegmentGeometryLayer>(clientmap::isa::kIsaForeignSegmentGeometryLayerName);
-    const auto* isaForeignSegmentLayer = finder.TryGetLayer<clientmap::decoder::IsaForeignSegmentLayer>(clientmap::isa::kIsaForeignSegmentLayerName);
-  
-    const auto* isaNodeLayer = finder.TryGetLayer<clientmap::decoder::IsaNodeLayer>(clientmap::isa::kIsaNodeLayerName);
+using IsaFilterPushdown = feature_filter::FilterPushdown<SegmentRecord, AttributeRecord>;
 
-    //const auto* linkIdMapLayer = finder.TryGetLayer<clientmap::decoder::LinkIdMappingLayer>(clientmap::interop::kLinkIdMappingLayerName);
-    //const auto* segIdMapLayer = finder.TryGetLayer<clientmap::decoder::SegmentIdMappingLayer>(clientmap::interop::kSegmentIdMappingLayerName);
+const feature_filter::FieldGetter<SegmentRecord> kSegmentFields[] = {
+    {"tile_id",      [](const SegmentRecord& s) { return ToFieldValue(s.tile_id); }},
+    {"local_id",     [](const SegmentRecord& s) { return ToFieldValue(s.local_id); }},
+    {"length",       [](const SegmentRecord& s) { return ToFieldValue(s.length); }},
+    {"host_tile_id", [](const SegmentRecord& s) { return ToFieldValue(s.host_tile_id); }},
+};
 
-    
+const feature_filter::FieldGetter<AttributeRecord> kAttributeFields[] = {
+    {"start_offset",                      [](const AttributeRecord& a) { return ToFieldValue(a.start_offset()); }},
+    {"forward_speed_limit",               [](const AttributeRecord& a) { return ToFieldValue(a.forward_speed_limit()); }},
+    {"forward_speed_limit_unlimited",     [](const AttributeRecord& a) { return ToFieldValue(a.forward_speed_limit_unlimited()); }},
+    {"backward_speed_limit",              [](const AttributeRecord& a) { return ToFieldValue(a.backward_speed_limit()); }},
+    {"backward_speed_limit_unlimited",    [](const AttributeRecord& a) { return ToFieldValue(a.backward_speed_limit_unlimited()); }},
+    {"forward_free_flow_speed",           [](const AttributeRecord& a) { return ToFieldValue(a.forward_free_flow_speed()); }},
+    {"backward_free_flow_speed",          [](const AttributeRecord& a) { return ToFieldValue(a.backward_free_flow_speed()); }},
+    {"administrative_routing_context_id", [](const AttributeRecord& a) { return ToFieldValue(a.administrative_routing_context_id()); }},
+    {"urban",                             [](const AttributeRecord& a) { return ToFieldValue(a.urban()); }},
+    {"forward_through_lane_count",        [](const AttributeRecord& a) { return ToFieldValue(a.forward_through_lane_count()); }},
+    {"backward_through_lane_count",       [](const AttributeRecord& a) { return ToFieldValue(a.backward_through_lane_count()); }},
+    {"forward_speed_limit_source",        [](const AttributeRecord& a) { return ToFieldValue(a.forward_speed_limit_source()); }},
+    {"backward_speed_limit_source",       [](const AttributeRecord& a) { return ToFieldValue(a.backward_speed_limit_source()); }},
+    {"forward_variable_speed_limit",      [](const AttributeRecord& a) { return ToFieldValue(a.forward_variable_speed_limit()); }},
+    {"backward_variable_speed_limit",     [](const AttributeRecord& a) { return ToFieldValue(a.backward_variable_speed_limit()); }},
+    {"rest_area",                         [](const AttributeRecord& a) { return ToFieldValue(a.rest_area()); }},
+    {"functional_class",                  [](const AttributeRecord& a) { return ToFieldValue(converter::FunctionalClassNames().Name(a.functional_class())); },
+                                          [](const AttributeRecord& a) { return ToFieldValue(a.functional_class()); }},
+    {"travel_direction",                  [](const AttributeRecord& a) { return ToFieldValue(converter::RelativeDirectionNames().Name(a.travel_direction())); },
+                                          [](const AttributeRecord& a) { return ToFieldValue(a.travel_direction()); }},
+    {"speed_category",                    [](const AttributeRecord& a) { return ToFieldValue(converter::SpeedCategoryNames().Name(a.speed_category())); },
+                                          [](const AttributeRecord& a) { return ToFieldValue(a.speed_category()); }},
+    {"intersection_category",             [](const AttributeRecord& a) { return ToFieldValue(converter::IntersectionCategoryNames().Name(a.intersection_category())); },
+                                          [](const AttributeRecord& a) { return ToFieldValue(a.intersection_category()); }},
+    {"road_divider",                      [](const AttributeRecord& a) { return ToFieldValue(converter::RoadDividerNames().Name(a.road_divider())); },
+                                          [](const AttributeRecord& a) { return ToFieldValue(a.road_divider()); }},
+    {"special_traffic_area_category",     [](const AttributeRecord& a) { return ToFieldValue(converter::SpecialTrafficAreaCategoryNames().Name(a.special_traffic_area_category())); },
+                                          [](const AttributeRecord& a) { return ToFieldValue(a.special_traffic_area_category()); }},
+    {"built_up_area",                     [](const AttributeRecord& a) { return ToFieldValue(builtUpAreaToString(a.built_up_area())); },
+                                          [](const AttributeRecord& a) { return ToFieldValue(a.built_up_area()); }},
+    // bitmask 只有 enums:raw 时才是标量
+    {"access",                            nullptr, [](const AttributeRecord& a) { return ToFieldValue(a.access()); }},
+    {"physical",                          nullptr, [](const AttributeRecord& a) { return ToFieldValue(a.physical()); }},
+    {"local_road",                        nullptr, [](const AttributeRecord& a) { return ToFieldValue(a.local_road()); }},
+    {"road_usage",                        nullptr, [](const AttributeRecord& a) { return ToFieldValue(a.road_usage()); }},
+};
 
-    uint32_t world_bits = 24;
-    world_bits = finder.GetWorldCoordinateBits(clientmap::isa::kIsaSegmentGeometryLayerName);
-    if(world_bits == 0)
-        world_bits = finder.GetWorldCoordinateBits(clientmap::isa::kIsaForeignSegmentGeometryLayerName);
-   
-    return convertInternal(isaSegmentLayer, *isaSegmenAttributetLayer, *isaGeometryLayer, 
-        *isaForeignSegmentGeometryLayer, isaForeignSegmentLayer, *isaNodeLayer, 
-        tile_key, outPath, world_bits);
-
-
-}
-
-json convert_attribute(const clientmap::decoder::IsaSegmentAttributeLayer::Attributes& attr) {
-    json a;
-    a["start_offset"] = attr.start_offset();
-    a["access"] = bitmaskToJson(attr.access());
-    a["physical"] = PhysicalBitMaskToJson(attr.physical());
-    a["local_road"] = LocalRoadBitmaskToJson(attr.local_road());
-    a["road_usage"] = RoadUsageBitMaskToJson(attr.road_usage());
-    a["forward_speed_limit"] = attr.forward_speed_limit();
-    a["forward_speed_limit_unlimited"] = attr.forward_speed_limit_unlimited();
-    a["backward_speed_limit"] = attr.backward_speed_limit();
-    a["backward_speed_limit_unlimited"] = attr.backward_speed_limit_unlimited();
-    a["forward_free_flow_speed"] = attr.forward_free_flow_speed();
-    a["backward_free_flow_speed"] = attr.backward_free_flow_speed();
-    a["special_traffic_area_category"] = attr.special_traffic_area_category();
-    a["intersection_category"] = attr.intersection_category();
-    a["administrative_routing_context_id"] = attr.administrative_routing_context_id();
-    a["built_up_area"] = attr.built_up_area();
-    a["urban"] = attr.urban();
-    a["forward_through_lane_count"] = attr.forward_through_lane_count();
-    a["backward_through_lane_count"] = attr.backward_through_lane_count();
-    a["forward_speed_limit_source"] = attr.forward_speed_limit_source();
-    a["backward_speed_limit_source"] = attr.backward_speed_limit_source();
-    a["forward_variable_speed_limit"] = attr.forward_variable_speed_limit();
-    a["backward_variable_speed_limit"] = attr.backward_variable_speed_limit();
-    a["rest_area"] = attr.rest_area();
+// 输出中为数组/对象的字段，filter 对其永远不成立
+const std::initializer_list<const char*> kOpaqueFields = {
+    "attributes", "access", "physical", "local_road", "road_usage",
+    "forward_access_permissions", "backward_access_permissions", "access_restrictions",
+    "construction_statuses", "special_speed_situations", "usage_fee_required",
+    "environmental_zone_conditions"
+};
 
+// ------------------------- 字段投影 -------------------------
+// 下标与 kIsaFieldNames 一一对应；kStartOffset 之后为 attributes 中的字段
+
+enum IsaField : size_t {
+    kTileId, kLocalId, kLength, kHostTileId, kIsSegmentStart,
+    kStartOffset, kAccess, kPhysical, kLocalRoad, kRoadUsage,
+    kForwardSpeedLimit, kForwardSpeedLimitUnlimited, kBackwardSpeedLimit, kBackwardSpeedLimitUnlimited,
+    kForwardFreeFlowSpeed, kBackwardFreeFlowSpeed, kAdministrativeRoutingContextId, kUrban,
+    kForwardThroughLaneCount, kBackwardThroughLaneCount, kForwardSpeedLimitSource, kBackwardSpeedLimitSource,
+    kForwardVariableSpeedLimit, kBackwardVariableSpeedLimit, kRestArea,
+    kFunctionalClass, kTravelDirection, kSpeedCategory, kIntersectionCategory, kRoadDivider,
+    kSpecialTrafficAreaCategory, kBuiltUpArea,
+    kForwardAccessPermissions, kBackwardAccessPermissions, kAccessRestrictions, kConstructionStatuses,
+    kSpecialSpeedSituations, kUsageFeeRequired, kEnvironmentalZoneConditions,
+    kIsaFieldCount
+};
 
-    // 枚举字段
-    a["functional_class"] = FunctionalClass_Name(attr.functional_class());
-    a["travel_direction"] = RelativeDirection_Name(attr.travel_direction());
-    a["speed_category"] = SpeedCategory_Name(attr.speed_category());
-    a["intersection_category"] = IntersectionCategory_Name(attr.intersection_category());
-    a["road_divider"] = RoadDivider_Name(attr.road_divider());
-    //a["route_level"] = RouteLevel_Name(attr.route_levels());
-    a["special_traffic_area_category"] = SpecialTrafficAreaCategory_Name(attr.special_traffic_area_category());
+const char* const kIsaFieldNames[kIsaFieldCount] = {
+    "tile_id", "local_id", "length", "host_tile_id", "is_segment_start",
+    "start_offset", "access", "physical", "local_road", "road_usage",
+    "forward_speed_limit", "forward_speed_limit_unlimited", "backward_speed_limit", "backward_speed_limit_unlimited",
+    "forward_free_flow_speed", "backward_free_flow_speed", "administrative_routing_context_id", "urban",
+    "forward_through_lane_count", "backward_through_lane_count", "forward_speed_limit_source", "backward_speed_limit_source",
+    "forward_variable_speed_limit", "backward_variable_speed_limit", "rest_area",
+    "functional_class", "travel_direction", "speed_category", "intersection_category", "road_divider",
+    "special_traffic_area_category", "built_up_area",
+    "forward_access_permissions", "backward_access_permissions", "access_restrictions", "construction_statuses",
+    "special_speed_situations", "usage_fee_required", "environmental_zone_conditions",
+};
 
-    // repeated TimedAccess
-    json forwardArr = json::array();
-    for (const auto& t : attr.forward_access_permissions()) {
-        forwardArr.push_back(convert_timed_access(t));
-    }
-    a["forward_access_permissions"] = forwardArr;
+using IsaFieldSet = std::bitset<kIsaFieldCount>;
 
-        json backwardArr = json::array();
-    for (const auto& t : attr.backward_access_permissions()) {
-        backwardArr.push_back(convert_timed_access(t));
-    }
-    a["backward_access_permissions"] = backwardArr;
+IsaFieldSet ResolveFields(const converter::ConvertOptions& options) {
+    if (!options.fields) return IsaFieldSet().set();
+    return options.fields->Resolve(kIsaFieldNames, "attributes", kStartOffset);
+}
 
-    json accessRestrictionArr = json::array();
-    for (const auto& t : attr.access_restrictions()) {
-        accessRestrictionArr.push_back(convert_timed_access(t));
-    }
-    a["access_restrictions"] = accessRestrictionArr;
+bool HasAttributeFields(const IsaFieldSet& fields) {
+    return (fields >> kStartOffset).any();
+}
 
+// ConvertOptions::pool 非空时，每块转换的 segment 数（块太小时线程池调度的开销比转换还大）
+constexpr size_t kSegmentsPerChunk = 1024;
 
-    json constructionStatusesAttr = json::array();
-    for (const auto& t : attr.construction_statuses()) {
-        constructionStatusesAttr.push_back(convert_timed_access(t));
+// 转换 segment 时复用的临时缓冲，每个线程一份
+struct SegmentScratch {
+    SegmentScratch(const converter::ConvertOptions& options, const olp::geo::TileKey& tile_key, uint32_t world_bits)
+        : encoder(options.geometry_encoding, world_bits, options.coordinate_precision),
+          simplifier(options.simplify, tile_key, world_bits) {}
+
+    std::vector<utils::WorldPoint> linePoints;
+    utils::CoordinateBuffer coordBuffer;
+    utils::PolylineEncoder encoder;
+    utils::LineSimplifier simplifier;
+    converter::AttributeCache attributes;
+};
+
+json ISADataToGeoJsonConverter::convert(const datastore::Response< datastore::TileLoadResult >& response, const olp::geo::TileKey &tile_key, const std::string& outPath,
+    const converter::ConvertOptions& options)
+{
+    const IsaLayers layers = FindIsaLayers(response);
+   
+    return convertInternal(layers.segments, *layers.attributes, *layers.geometries, 
+        *layers.foreign_geometries, layers.foreign_segments, *layers.nodes, 
+        tile_key, outPath, layers.world_bits, options);
+}
+
+// 只计算 fields 中请求的字段；raw 为 true 时枚举和 bitmask 输出整数；validAt 非空时去掉该时刻不生效的条目
+json convert_attribute(const clientmap::decoder::IsaSegmentAttributeLayer::Attributes& attr,
+                       const IsaFieldSet& fields, bool raw,
+                       const TimeDomainParser::ValidityFilter* validAt) {
+    json a = json::object();
+    if (fields[kStartOffset]) a["start_offset"] = attr.start_offset();
+    if (fields[kAccess]) a["access"] = raw ? json(attr.access()) : bitmaskToJson(attr.access());
+    if (fields[kPhysical]) a["physical"] = raw ? json(attr.physical()) : PhysicalBitMaskToJson(attr.physical());
+    if (fields[kLocalRoad]) a["local_road"] = raw ? json(attr.local_road()) : LocalRoadBitmaskToJson(attr.local_road());
+    if (fields[kRoadUsage]) a["road_usage"] = raw ? json(attr.road_usage()) : RoadUsageBitMaskToJson(attr.road_usage());
+    if (fields[kForwardSpeedLimit]) a["forward_speed_limit"] = attr.forward_speed_limit();
+    if (fields[kForwardSpeedLimitUnlimited]) a["forward_speed_limit_unlimited"] = attr.forward_speed_limit_unlimited();
+    if (fields[kBackwardSpeedLimit]) a["backward_speed_limit"] = attr.backward_speed_limit();
+    if (fields[kBackwardSpeedLimitUnlimited]) a["backward_speed_limit_unlimited"] = attr.backward_speed_limit_unlimited();
+    if (fields[kForwardFreeFlowSpeed]) a["forward_free_flow_speed"] = attr.forward_free_flow_speed();
+    if (fields[kBackwardFreeFlowSpeed]) a["backward_free_flow_speed"] = attr.backward_free_flow_speed();
+    if (fields[kAdministrativeRoutingContextId]) a["administrative_routing_context_id"] = attr.administrative_routing_context_id();
+    if (fields[kUrban]) a["urban"] = attr.urban();
+    if (fields[kForwardThroughLaneCount]) a["forward_through_lane_count"] = attr.forward_through_lane_count();
+    if (fields[kBackwardThroughLaneCount]) a["backward_through_lane_count"] = attr.backward_through_lane_count();
+    if (fields[kForwardSpeedLimitSource]) a["forward_speed_limit_source"] = attr.forward_speed_limit_source();
+    if (fields[kBackwardSpeedLimitSource]) a["backward_speed_limit_source"] = attr.backward_speed_limit_source();
+    if (fields[kForwardVariableSpeedLimit]) a["forward_variable_speed_limit"] = attr.forward_variable_speed_limit();
+    if (fields[kBackwardVariableSpeedLimit]) a["backward_variable_speed_limit"] = attr.backward_variable_speed_limit();
+    if (fields[kRestArea]) a["rest_area"] = attr.rest_area();
+
+    // 枚举字段
+    if (raw) {
+        if (fields[kFunctionalClass]) a["functional_class"] = attr.functional_class();
+        if (fields[kTravelDirection]) a["travel_direction"] = attr.travel_direction();
+        if (fields[kSpeedCategory]) a["speed_category"] = attr.speed_category();
+        if (fields[kIntersectionCategory]) a["intersection_category"] = attr.intersection_category();
+        if (fields[kRoadDivider]) a["road_divider"] = attr.road_divider();
+        if (fields[kSpecialTrafficAreaCategory]) a["special_traffic_area_category"] = attr.special_traffic_area_category();
+        if (fields[kBuiltUpArea]) a["built_up_area"] = attr.built_up_area();
+    } else {
+        if (fields[kFunctionalClass]) a["functional_class"] = converter::FunctionalClassNames().Name(attr.functional_class());
+        if (fields[kTravelDirection]) a["travel_direction"] = converter::RelativeDirectionNames().Name(attr.travel_direction());
+        if (fields[kSpeedCategory]) a["speed_category"] = converter::SpeedCategoryNames().Name(attr.speed_category());
+        if (fields[kIntersectionCategory]) a["intersection_category"] = converter::IntersectionCategoryNames().Name(attr.intersection_category());
+        if (fields[kRoadDivider]) a["road_divider"] = converter::RoadDividerNames().Name(attr.road_divider());
+        //a["route_level"] = RouteLevel_Name(attr.route_levels());
+        if (fields[kSpecialTrafficAreaCategory]) a["special_traffic_area_category"] = converter::SpecialTrafficAreaCategoryNames().Name(attr.special_traffic_area_category());
+        if (fields[kBuiltUpArea]) a["built_up_area"] = builtUpAreaToString(attr.built_up_area());
     }
-    a["construction_statuses"] = constructionStatusesAttr;
+
+    // repeated TimedAccess
+    auto timedAccessArray = [raw, validAt](const google::protobuf::RepeatedPtrField<TimedAccess>& items) {
+        json arr = json::array();
+        for (const auto& t : items) {
+            if (applies_at(validAt, t)) arr.push_back(convert_timed_access(t, raw));
+        }
+        return arr;
+    };
+    if (fields[kForwardAccessPermissions]) a["forward_access_permissions"] = timedAccessArray(attr.forward_access_permissions());
+    if (fields[kBackwardAccessPermissions]) a["backward_access_permissions"] = timedAccessArray(attr.backward_access_permissions());
+    if (fields[kAccessRestrictions]) a["access_restrictions"] = timedAccessArray(attr.access_restrictions());
+    if (fields[kConstructionStatuses]) a["construction_statuses"] = timedAccessArray(attr.construction_statuses());
 
     // repeated SpecialSpeedSituation
-    json speedArr = json::array();
-    for (const auto& s : attr.special_speed_situations()) {
-        speedArr.push_back(convert_special_speed(s));
+    if (fields[kSpecialSpeedSituations]) {
+        json speedArr = json::array();
+        for (const auto& s : attr.special_speed_situations()) {
+            if (applies_at(validAt, s)) speedArr.push_back(convert_special_speed(s, raw));
+        }
+        a["special_speed_situations"] = speedArr;
     }
-    a["special_speed_situations"] = speedArr;
 
     // UsageFeeRequired
-    json usageArr = json::array();
-    for (const auto& u : attr.usage_fee_required()) {
-        usageArr.push_back(convert_usage_fee(u));
+    if (fields[kUsageFeeRequired]) {
+        json usageArr = json::array();
+        for (const auto& u : attr.usage_fee_required()) {
+            if (applies_at(validAt, u)) usageArr.push_back(convert_usage_fee(u, raw));
+        }
+        a["usage_fee_required"] = usageArr;
     }
-    a["usage_fee_required"] = usageArr;
 
     // EnvironmentalZoneCondition
-    json envArr = json::array();
-    for (const auto& e : attr.environmental_zone()) {
-        envArr.push_back(convert_env_zone(e));
+    if (fields[kEnvironmentalZoneConditions]) {
+        json envArr = json::array();
+        for (const auto& e : attr.environmental_zone()) {
+            envArr.push_back(convert_env_zone(e, raw));
+        }
+        a["environmental_zone_conditions"] = envArr;
     }
-    a["environmental_zone_conditions"] = envArr;
-
-    // BuiltUpArea
-    a["built_up_area"] = builtUpAreaToString(attr.built_up_area());
 
-        return a;
-    }
+    return a;
+}
 
 
 std::string joinLinkIds(const layers::LinkIdMappingLayer::Segment& segment) {
@@ -456,174 +466,224 @@ json convertInternal(
     //const clientmap::decoder::SegmentIdMappingLayer& segIdMapLayer,
     const olp::geo::TileKey& tile_key,
     const std::string& output_path,
-    const uint32_t& world_bits )
+    const uint32_t& world_bits,
+    const converter::ConvertOptions& options)
 {
+    // 本瓦片的临时结构（nodeIndex、各块的 attributes 缓存）从当前线程的 arena 分配，转换结束时整体回收
+    ocm::TileArena::Scope arenaScope;
+    const utils::SegmentStartIndex nodeIndex(nodeLayer);
+
+    IsaFilterPushdown pushdown(options.filter, kSegmentFields, kAttributeFields, kOpaqueFields, options.raw_enums);
+    if (options.filter && !options.filter->empty() && !pushdown.active()) {
+        OLP_SDK_LOG_INFO_F(kLogTag, "Filter key '%s' can not be pushed down, filter on output instead",
+                           pushdown.unresolved_key().c_str());
+    }
+
+    const IsaFieldSet fields = ResolveFields(options);
+    const bool withAttributes = HasAttributeFields(fields);
 
-    auto nodeMap = buildNodeMap(nodeLayer);
+    // clip: 在解码出的整数坐标上判断，区域外的要素不再构造
+    const utils::TileClipper clipper(options.clip_area, options.clip_mode, tile_key, world_bits);
+
+    const utils::CoordinateDecoder decoder(tile_key, world_bits);
+    const int precision = options.coordinate_precision;
+
+    const uint64_t tileID = TileIDConverter::XYtoTileId(tile_key.Column(), tile_key.Row(), tile_key.Level());
 
     json feature_collection;
     feature_collection["type"] = "FeatureCollection";
-    feature_collection["features"] = json::array();
 
+    // 转换 [begin, end) 中的 segment，先 foreign segment 再 segment（两者连续编号）
+    const size_t numForeign = foreignSegLayer ? foreignSegLayer->segments_size() : 0;
+    const size_t numSegments = segLayer ? segLayer->segments_size() : 0;
+    auto convertRange = [&](size_t begin, size_t end) {
+        ocm::TileArena::Scope arenaScope;   // 分块在线程池中转换时使用工作线程的 arena
+        json::array_t features;
+        SegmentScratch scratch(options, tile_key, world_bits);
+        std::vector<utils::WorldPoint>& linePoints = scratch.linePoints;
+        utils::CoordinateBuffer& coordBuffer = scratch.coordBuffer;
+        utils::PolylineEncoder& encoder = scratch.encoder;
+        utils::LineSimplifier& simplifier = scratch.simplifier;
+
+        auto classifyGeometry = [&](const auto& geom) {
+            linePoints.clear();
+            for (const auto& part : geom.parts()) {
+                clipper.AppendLine(part.geometry(), linePoints);
+            }
+            return clipper.Classify(linePoints);
+        };
 
-    if(foreignSegLayer)
-    {
-        int foreinSegmentSize = foreignSegLayer->segments_size();
-        for(int i = 0; i<foreinSegmentSize; ++i)
+        if(foreignSegLayer)
         {
-            const auto& seg = foreignSegLayer->segments(i);
-            const auto& geom = foreignGeomLayer.segments(i);
-            const auto& tileID = TileIDConverter::XYtoTileId(tile_key.Column(), tile_key.Row(), tile_key.Level());
-            json properties;
-            properties["tile_id"] = tileID;
-            properties["local_id"] = seg.local_id();
-            properties["length"]   = seg.meter_length();
-            properties["host_tile_id"] = seg.host_tile_id();
-
-            json geometry;
-            geometry["type"] = "LineString";
-            geometry["coordinates"] = json::array();
-                    // === geometry ===
-            json coordinates = json::array();
-            for (const auto& part : geom.parts()) {
-                const auto& line_string = part.geometry();  // <-- 这里需要 LineString.proto 的定义
-
-                int num_coords = line_string.xy_coords_size();
-                for (int j = 0; j < num_coords; j += 2) {
-                        if (j + 1 >= num_coords) break;
-
-                        uint32_t x_coord = line_string.xy_coords(j);
-                        uint32_t y_coord = line_string.xy_coords(j + 1);
-                        if(j==0)
-                        {
-                            auto it = nodeMap.find(makeCoordKey(x_coord, y_coord));
-                            const auto* node = (it != nodeMap.end()) ? it->second : nullptr;
-
-                            if (node) {
-                            int connectedSegSize = node->connected_segments_size();
-                                for(int i = 0; i < connectedSegSize; i++)
-                                {
-                                    const auto& segmentEnd = node->connected_segments(i);
-                                    auto segmentIndex = segmentEnd.segment_index();
-                                    const auto& segment = nodeLayer.segments(segmentIndex);
-                                    if(segment.local_id()==seg.local_id() && segment.host_tile_id() == seg.host_tile_id())
-                                    {
-                                        properties["is_segment_start"] = segmentEnd.is_segment_start();
-                                    }
-                                }
-                            } 
-
-                        }
-
-                        uint32_t I_LNG_TILE = tile_key.Column() << (world_bits - tile_key.Level());
-                        uint32_t I_LNG = I_LNG_TILE + x_coord;
-                        double LNG = (I_LNG * 360.0) / (1 << world_bits) - 180.0;
-
-                        uint32_t I_LAT_TILE = tile_key.Row() << (world_bits - tile_key.Level());
-                        uint32_t I_LAT = I_LAT_TILE + y_coord;
-                        double LAT = (I_LAT * 360.0) / (1 << world_bits) - 90.0;
-
-                        geometry["coordinates"].push_back({ LNG, LAT });
+            for(size_t i = begin; i < std::min(end, numForeign); ++i)
+            {
+                const auto& seg = foreignSegLayer->segments(i);
+                // foreign segment 没有 attributes
+                if (pushdown.active() &&
+                    !pushdown.Matches(MakeSegmentRecord(tileID, seg))) {
+                    continue;
+                }
+                const auto& geom = foreignGeomLayer.segments(i);
+                bool cutGeometry = false;
+                if (clipper.active()) {
+                    const utils::ClipResult where = classifyGeometry(geom);
+                    if (where == utils::ClipResult::kOutside) continue;
+                    cutGeometry = (where == utils::ClipResult::kPartial && clipper.mode() == utils::ClipMode::kCut);
+                }
+                json properties = json::object();
+                if (fields[kTileId]) properties["tile_id"] = tileID;
+                if (fields[kLocalId]) properties["local_id"] = seg.local_id();
+                if (fields[kLength]) properties["length"]   = seg.meter_length();
+                if (fields[kHostTileId]) properties["host_tile_id"] = seg.host_tile_id();
+
+                json geometry;
+                geometry["type"] = "LineString";
+                geometry["coordinates"] = json::array();
+                        // === geometry ===
+                json coordinates = json::array();
+                encoder.Clear();
+                for (const auto& part : geom.parts()) {
+                    const auto& line_string = part.geometry();  // <-- 这里需要 LineString.proto 的定义
+
+                    if (fields[kIsSegmentStart] && line_string.xy_coords_size() >= 2) {
+                        const int8_t found = FindSegmentStart(nodeIndex, line_string.xy_coords(0), line_string.xy_coords(1), seg);
+                        if (found >= 0) properties["is_segment_start"] = (found == 1);
+                    }
+
+                    if (cutGeometry) continue;   // 裁剪后的几何在循环外生成
+
+                    const auto points = simplifier.Points(line_string);
+                    if (encoder.active()) encoder.AddLine(points.first, points.second, decoder);
+                    else utils::AppendCoordinates(geometry["coordinates"], decoder, points.first, points.second, precision, coordBuffer);
+                }
+                if (cutGeometry) {
+                    if (simplifier.active()) simplifier.Simplify(linePoints);
+                    const auto pieces = clipper.Cut(linePoints);
+                    if (pieces.empty()) continue;   // 只擦过区域边界，没有剩下的片段
+                    geometry = encoder.active() ? encoder.ToGeometry(pieces) : clipper.ToGeometry(pieces, precision);
+                } else if (encoder.active()) {
+                    geometry = encoder.ToGeometry();
                 }
-            }
         
-            // === feature ===
-            json feature;
-            feature["type"] = "Feature";
-            feature["geometry"] = geometry;
-            feature["properties"] = properties;
-
+                // === feature ===
+                json feature;
+                feature["type"] = "Feature";
+                feature["geometry"] = geometry;
+                feature["properties"] = properties;
+
+                if (options.dedup) {
+                    // 只有确实输出的副本参与去重：被裁剪或被过滤掉的副本不能占用键，否则其它副本也会被跳过
+                    if (options.filter && !options.filter->Match(feature)) continue;
+                    const auto copy = options.dedup->CheckForeign(static_cast<uint64_t>(seg.host_tile_id()),
+                                                                  static_cast<uint64_t>(seg.local_id()));
+                    if (copy == converter::SegmentDedup::ForeignCopy::kSkip) continue;
+                    if (copy == converter::SegmentDedup::ForeignCopy::kDefer) {
+                        converter::FeatureChunk chunk = options.dedup->NewChunk();
+                        chunk.BeginFeature().Value(feature);
+                        options.dedup->Defer(static_cast<uint64_t>(seg.host_tile_id()), static_cast<uint64_t>(seg.local_id()), std::move(chunk));
+                        continue;
+                    }
+                }
 
-            feature_collection["features"].push_back(feature);
+                features.push_back(std::move(feature));
+            }
         }
-    }
-    if(segLayer)
-    {
-        int n = segLayer->segments_size();
-        for (int i = 0; i < n; ++i) {
-            const auto& seg = segLayer->segments(i);
-            const auto& geom = geomLayer.segments(i);
-            const auto& attr = attrLayer.segments(i);
-        // const auto& linkIds = linkIdMapLayer.segments(i);
-         //   const auto& hmcIdSeg =  segIdMapLayer.segments(i);
+        if(segLayer)
+        {
+            for (size_t i = std::max(begin, numForeign) - numForeign; i < end - std::min(end, numForeign); ++i) {
+                const auto& seg = segLayer->segments(i);
+                const auto& attr = attrLayer.segments(i);
+                if (pushdown.active() &&
+                    !pushdown.Matches(MakeSegmentRecord(tileID, seg), &attr.attributes())) {
+                    continue;
+                }
+                const auto& geom = geomLayer.segments(i);
+                bool cutGeometry = false;
+                if (clipper.active()) {
+                    const utils::ClipResult where = classifyGeometry(geom);
+                    if (where == utils::ClipResult::kOutside) continue;
+                    cutGeometry = (where == utils::ClipResult::kPartial && clipper.mode() == utils::ClipMode::kCut);
+                }
+            // const auto& linkIds = linkIdMapLayer.segments(i);
+             //   const auto& hmcIdSeg =  segIdMapLayer.segments(i);
             
 
-        // auto linkIdStr = joinLinkIds(linkIds);
-
-
-            // === properties ===
-            const auto& tileID = TileIDConverter::XYtoTileId(tile_key.Column(), tile_key.Row(), tile_key.Level());
-            json properties;
-            properties["tile_id"] = tileID;
-            properties["local_id"] = seg.local_id();
-            properties["length"]   = seg.meter_length();
-            properties["host_tile_id"] = seg.host_tile_id();
-        // properties["road_link_ids"] = linkIdStr;
-         //   properties["hmc_id"] = hmcIdSeg.hmc_id();
-        // properties["part_number"] = 
-            json attributes = json::array();
-            for (const auto& attr : attr.attributes()) {
-                attributes.push_back(convert_attribute(attr));
-            }
-            properties["attributes"] = attributes;
+            // auto linkIdStr = joinLinkIds(linkIds);
+
+
+                // === properties ===
+                json properties = json::object();
+                if (fields[kTileId]) properties["tile_id"] = tileID;
+                if (fields[kLocalId]) properties["local_id"] = seg.local_id();
+                if (fields[kLength]) properties["length"]   = seg.meter_length();
+                if (fields[kHostTileId]) properties["host_tile_id"] = seg.host_tile_id();
+            // properties["road_link_ids"] = linkIdStr;
+             //   properties["hmc_id"] = hmcIdSeg.hmc_id();
+            // properties["part_number"] = 
+                if (withAttributes) {
+                    json attributes = json::array();
+                    for (const auto& attr : attr.attributes()) {
+                        attributes.push_back(scratch.attributes.Get(attr, [&](const AttributeRecord& record) {
+                            return convert_attribute(record, fields, options.raw_enums, options.valid_at);
+                        }));
+                    }
+                    properties["attributes"] = attributes;
+                }
 
-            json geometry;
-            geometry["type"] = "LineString";
-            geometry["coordinates"] = json::array();
-                    // === geometry ===
-            json coordinates = json::array();
-            for (const auto& part : geom.parts()) {
-                const auto& line_string = part.geometry();  // <-- 这里需要 LineString.proto 的定义
-
-                int num_coords = line_string.xy_coords_size();
-                for (int j = 0; j < num_coords; j += 2) {
-                        if (j + 1 >= num_coords) break;
-
-                        uint32_t x_coord = line_string.xy_coords(j);
-                        uint32_t y_coord = line_string.xy_coords(j + 1);
-
-                        if(j==0)
-                        {
-                            auto it = nodeMap.find(makeCoordKey(x_coord, y_coord));
-                            const auto* node = (it != nodeMap.end()) ? it->second : nullptr;
-
-                            if (node) {
-                            int connectedSegSize = node->connected_segments_size();
-                                for(int i = 0; i < connectedSegSize; i++)
-                                {
-                                    const auto& segmentEnd = node->connected_segments(i);
-                                    auto segmentIndex = segmentEnd.segment_index();
-                                    const auto& segment = nodeLayer.segments(segmentIndex);
-                                    if(segment.local_id()==seg.local_id() && segment.host_tile_id() == seg.host_tile_id())
-                                    {
-                                        properties["is_segment_start"] = segmentEnd.is_segment_start();
-                                    }
-                                }
-                            } 
-                        }
-
-                        uint32_t I_LNG_TILE = tile_key.Column() << (world_bits - tile_key.Level());
-                        uint32_t I_LNG = I_LNG_TILE + x_coord;
-                        double LNG = (I_LNG * 360.0) / (1 << world_bits) - 180.0;
-
-                        uint32_t I_LAT_TILE = tile_key.Row() << (world_bits - tile_key.Level());
-                        uint32_t I_LAT = I_LAT_TILE + y_coord;
-                        double LAT = (I_LAT * 360.0) / (1 << world_bits) - 90.0;
-
-                        geometry["coordinates"].push_back({ LNG, LAT });
+                json geometry;
+                geometry["type"] = "LineString";
+                geometry["coordinates"] = json::array();
+                        // === geometry ===
+                json coordinates = json::array();
+                encoder.Clear();
+                for (const auto& part : geom.parts()) {
+                    const auto& line_string = part.geometry();  // <-- 这里需要 LineString.proto 的定义
+
+                    if (fields[kIsSegmentStart] && line_string.xy_coords_size() >= 2) {
+                        const int8_t found = FindSegmentStart(nodeIndex, line_string.xy_coords(0), line_string.xy_coords(1), seg);
+                        if (found >= 0) properties["is_segment_start"] = (found == 1);
+                    }
+
+                    if (cutGeometry) continue;   // 裁剪后的几何在循环外生成
+
+                    const auto points = simplifier.Points(line_string);
+                    if (encoder.active()) encoder.AddLine(points.first, points.second, decoder);
+                    else utils::AppendCoordinates(geometry["coordinates"], decoder, points.first, points.second, precision, coordBuffer);
+                }
+                if (cutGeometry) {
+                    if (simplifier.active()) simplifier.Simplify(linePoints);
+                    const auto pieces = clipper.Cut(linePoints);
+                    if (pieces.empty()) continue;   // 只擦过区域边界，没有剩下的片段
+                    geometry = encoder.active() ? encoder.ToGeometry(pieces) : clipper.ToGeometry(pieces, precision);
+                } else if (encoder.active()) {
+                    geometry = encoder.ToGeometry();
                 }
-            }
         
-            // === feature ===
-            json feature;
-            feature["type"] = "Feature";
-            feature["geometry"] = geometry;
+                // === feature ===
+                json feature;
+                feature["type"] = "Feature";
+                feature["geometry"] = geometry;
+
 
+                feature["properties"] = properties;
 
-            feature["properties"] = properties;
+                features.push_back(std::move(feature));
+            }
+        }
+        return features;
+    };
 
-            feature_collection["features"].push_back(feature);
+    const size_t total = numForeign + numSegments;
+    if (!options.pool || total < 2 * kSegmentsPerChunk) {
+        feature_collection["features"] = convertRange(0, total);
+    } else {
+        auto chunks = ocm::RunChunked(*options.pool, total, kSegmentsPerChunk, convertRange);
+        json::array_t features;
+        features.reserve(total);
+        for (auto& chunk : chunks) {
+            std::move(chunk.begin(), chunk.end(), std::back_inserter(features));
         }
+        feature_collection["features"] = std::move(features);
     }
         OLP_SDK_LOG_INFO(kLogTag, "完成转换 GeoJson...");
         return feature_collection;
@@ -633,6 +693,372 @@ json convertInternal(
 
 
 
+// ------------------------- 流式输出 -------------------------
+// 与 convert_attribute / convertInternal 生成的 JSON 逐字节一致：
+// nlohmann::json 的对象按键名排序输出，所以这里所有的键都按字典序写入。
+
+using converter::JsonWriter;
+namespace keys = converter::attribute_keys;
+
+void write_access(JsonWriter& w, uint32_t mask, bool raw) {
+    if (raw) w.Value(mask);
+    else converter::AccessFlagNames().Write(w, mask);
+}
+
+// 枚举：raw 时为整数，否则为名称
+void write_enum(JsonWriter& w, const converter::JsonKey& key, int value, bool raw,
+                const converter::EnumNameTable& names) {
+    w.Key(key);
+    if (raw) w.Value(value);
+    else names.Write(w, value);
+}
+
+// bitmask：raw 时为整数，否则为 {"active": [...], "is_empty": ..., "raw": ...}
+void write_flags(JsonWriter& w, const converter::JsonKey& key, uint32_t mask, bool raw,
+                 const converter::FlagNameTable& names) {
+    w.Key(key);
+    if (raw) w.Value(mask);
+    else names.WriteObject(w, mask);
+}
+
+void write_timed_access(JsonWriter& w, const TimedAccess& t, bool raw) {
+    w.BeginObject();
+    w.Key(keys::kAppliesDuring);
+    w.StringArray(t.applies_during());
+    w.Key(keys::kAppliesTo);
+    write_access(w, t.applies_to(), raw);
+    w.Key(keys::kSeasonalAppliesDuring);
+    w.StringArray(t.seasonal_applies_during());
+    w.EndObject();
+}
+
+void write_special_speed(JsonWriter& w, const SpecialSpeedSituation& s, bool raw) {
+    w.BeginObject();
+    w.Key(keys::kAppliesDuring);
+    w.StringArray(s.applies_during());
+    w.Key(keys::kAppliesDuringReadable);
+    w.BeginArray();
+    for (const auto& p : s.applies_during()) {
+        w.Value(TimeDomainParser::TimeDomainToReadable(p));
+    }
+    w.EndArray();
+    w.Field(keys::kSpecialSpeedLimit, s.special_speed_limit());
+    write_enum(w, keys::kSpecialSpeedType, s.special_speed_type(), raw, converter::SpecialSpeedTypeNames());
+    w.EndObject();
+}
+
+void write_usage_fee(JsonWriter& w, const UsageFeeRequired& u, bool raw) {
+    w.BeginObject();
+    w.Key(keys::kAppliesDuring);
+    w.StringArray(u.applies_during());
+    w.Key(keys::kAppliesTo);
+    write_access(w, u.applies_to(), raw);
+    write_enum(w, keys::kRelativeDirection, u.relative_direction(), raw, converter::RelativeDirectionNames());
+    write_enum(w, keys::kTollFeatureType, u.toll_feature_type(), raw, converter::TollFeatureTypeNames());
+    w.Field(keys::kTollSystemId, u.toll_system_id());
+    w.EndObject();
+}
+
+void write_env_zone(JsonWriter& w, const EnvironmentalZoneCondition& e, bool raw) {
+    w.BeginObject();
+    w.Key(keys::kAppliesTo);
+    write_access(w, e.applies_to(), raw);
+    w.Field(keys::kEnvironmentalZoneId, e.environmental_zone_id());
+    w.EndObject();
+}
+
+template <typename Range, typename WriteFn>
+void WriteArray(JsonWriter& w, const converter::JsonKey& key, const Range& items, bool raw,
+                const TimeDomainParser::ValidityFilter* validAt, WriteFn write) {
+    w.Key(key);
+    w.BeginArray();
+    for (const auto& item : items) {
+        if (applies_at(validAt, item)) write(w, item, raw);
+    }
+    w.EndArray();
+}
+
+void write_attribute(JsonWriter& w, const AttributeRecord& attr, const IsaFieldSet& fields, bool raw,
+                     const TimeDomainParser::ValidityFilter* validAt) {
+    w.BeginObject();
+    if (fields[kAccess]) {
+        w.Key(keys::kAccess);
+        write_access(w, attr.access(), raw);
+    }
+    if (fields[kAccessRestrictions]) WriteArray(w, keys::kAccessRestrictions, attr.access_restrictions(), raw, validAt, write_timed_access);
+    if (fields[kAdministrativeRoutingContextId]) w.Field(keys::kAdministrativeRoutingContextId, attr.administrative_routing_context_id());
+    if (fields[kBackwardAccessPermissions]) WriteArray(w, keys::kBackwardAccessPermissions, attr.backward_access_permissions(), raw, validAt, write_timed_access);
+    if (fields[kBackwardFreeFlowSpeed]) w.Field(keys::kBackwardFreeFlowSpeed, attr.backward_free_flow_speed());
+    if (fields[kBackwardSpeedLimit]) w.Field(keys::kBackwardSpeedLimit, attr.backward_speed_limit());
+    if (fields[kBackwardSpeedLimitSource]) w.Field(keys::kBackwardSpeedLimitSource, attr.backward_speed_limit_source());
+    if (fields[kBackwardSpeedLimitUnlimited]) w.Field(keys::kBackwardSpeedLimitUnlimited, attr.backward_speed_limit_unlimited());
+    if (fields[kBackwardThroughLaneCount]) w.Field(keys::kBackwardThroughLaneCount, attr.backward_through_lane_count());
+    if (fields[kBackwardVariableSpeedLimit]) w.Field(keys::kBackwardVariableSpeedLimit, attr.backward_variable_speed_limit());
+    if (fields[kBuiltUpArea]) {
+        if (raw) w.Field(keys::kBuiltUpArea, attr.built_up_area());
+        else w.Field(keys::kBuiltUpArea, builtUpAreaToString(attr.built_up_area()));
+    }
+    if (fields[kConstructionStatuses]) WriteArray(w, keys::kConstructionStatuses, attr.construction_statuses(), raw, validAt, write_timed_access);
+    if (fields[kEnvironmentalZoneConditions]) WriteArray(w, keys::kEnvironmentalZoneConditions, attr.environmental_zone(), raw, validAt, write_env_zone);
+    if (fields[kForwardAccessPermissions]) WriteArray(w, keys::kForwardAccessPermissions, attr.forward_access_permissions(), raw, validAt, write_timed_access);
+    if (fields[kForwardFreeFlowSpeed]) w.Field(keys::kForwardFreeFlowSpeed, attr.forward_free_flow_speed());
+    if (fields[kForwardSpeedLimit]) w.Field(keys::kForwardSpeedLimit, attr.forward_speed_limit());
+    if (fields[kForwardSpeedLimitSource]) w.Field(keys::kForwardSpeedLimitSource, attr.forward_speed_limit_source());
+    if (fields[kForwardSpeedLimitUnlimited]) w.Field(keys::kForwardSpeedLimitUnlimited, attr.forward_speed_limit_unlimited());
+    if (fields[kForwardThroughLaneCount]) w.Field(keys::kForwardThroughLaneCount, attr.forward_through_lane_count());
+    if (fields[kForwardVariableSpeedLimit]) w.Field(keys::kForwardVariableSpeedLimit, attr.forward_variable_speed_limit());
+    if (fields[kFunctionalClass]) write_enum(w, keys::kFunctionalClass, attr.functional_class(), raw, converter::FunctionalClassNames());
+    if (fields[kIntersectionCategory]) write_enum(w, keys::kIntersectionCategory, attr.intersection_category(), raw, converter::IntersectionCategoryNames());
+    if (fields[kLocalRoad]) write_flags(w, keys::kLocalRoad, attr.local_road(), raw, converter::LocalRoadFlagNames());
+    if (fields[kPhysical]) write_flags(w, keys::kPhysical, attr.physical(), raw, converter::PhysicalFlagNames());
+    if (fields[kRestArea]) w.Field(keys::kRestArea, attr.rest_area());
+    if (fields[kRoadDivider]) write_enum(w, keys::kRoadDivider, attr.road_divider(), raw, converter::RoadDividerNames());
+    if (fields[kRoadUsage]) write_flags(w, keys::kRoadUsage, attr.road_usage(), raw, converter::RoadUsageFlagNames());
+    if (fields[kSpecialSpeedSituations]) WriteArray(w, keys::kSpecialSpeedSituations, attr.special_speed_situations(), raw, validAt, write_special_speed);
+    if (fields[kSpecialTrafficAreaCategory]) write_enum(w, keys::kSpecialTrafficAreaCategory, attr.special_traffic_area_category(), raw, converter::SpecialTrafficAreaCategoryNames());
+    if (fields[kSpeedCategory]) write_enum(w, keys::kSpeedCategory, attr.speed_category(), raw, converter::SpeedCategoryNames());
+    if (fields[kStartOffset]) w.Field(keys::kStartOffset, attr.start_offset());
+    if (fields[kTravelDirection]) write_enum(w, keys::kTravelDirection, attr.travel_direction(), raw, converter::RelativeDirectionNames());
+    if (fields[kUrban]) w.Field(keys::kUrban, attr.urban());
+    if (fields[kUsageFeeRequired]) WriteArray(w, keys::kUsageFeeRequired, attr.usage_fee_required(), raw, validAt, write_usage_fee);
+    w.EndObject();
+}
+
+bool streamInternal(
+    const IsaLayers& layers,
+    const olp::geo::TileKey& tile_key,
+    const converter::ConvertOptions& options,
+    converter::FeatureCollectionWriter& out)
+{
+    IsaFilterPushdown pushdown(options.filter, kSegmentFields, kAttributeFields, kOpaqueFields, options.raw_enums);
+    if (options.filter && !options.filter->empty() && !pushdown.active()) {
+        return false;   // 由调用方改走 convert() + 输出端过滤
+    }
+
+    // 同 convertInternal：本瓦片的临时结构从当前线程的 arena 分配
+    ocm::TileArena::Scope arenaScope;
+    const utils::SegmentStartIndex nodeIndex(*layers.nodes);
+    const IsaFieldSet fields = ResolveFields(options);
+    const bool withAttributes = HasAttributeFields(fields);
+    const bool raw = options.raw_enums;
+    const uint32_t world_bits = layers.world_bits;
+    const uint64_t tileID = TileIDConverter::XYtoTileId(tile_key.Column(), tile_key.Row(), tile_key.Level());
+
+    const utils::TileClipper clipper(options.clip_area, options.clip_mode, tile_key, world_bits);
+    const utils::CoordinateDecoder decoder(tile_key, world_bits);
+    const int precision = options.coordinate_precision;
+
+    auto writeAttribute = [&](JsonWriter& w, const AttributeRecord& attr) {
+        write_attribute(w, attr, fields, raw, options.valid_at);
+    };
+
+    // segment 的 properties 对象；attributes 为空表示 foreign segment
+    auto writeProperties = [&](JsonWriter& w, SegmentScratch& scratch, const auto& seg,
+                               const AttributeRecordRange* attributes, int8_t segmentStart) {
+        w.BeginObject();
+        if (attributes && withAttributes && options.attribute_dictionary) {
+            w.Key("attribute_refs");
+            w.BeginArray();
+            for (const auto& attr : *attributes) {
+                w.Uint(options.attribute_dictionary->Index(attr, writeAttribute));
+            }
+            w.EndArray();
+        } else if (attributes && withAttributes) {
+            w.Key("attributes");
+            w.BeginArray();
+            for (const auto& attr : *attributes) {
+                scratch.attributes.Write(w, attr, writeAttribute);
+            }
+            w.EndArray();
+        }
+        if (fields[kHostTileId]) w.Field("host_tile_id", seg.host_tile_id());
+        if (segmentStart >= 0) w.Field("is_segment_start", segmentStart == 1);
+        if (fields[kLength]) w.Field("length", seg.meter_length());
+        if (fields[kLocalId]) w.Field("local_id", seg.local_id());
+        if (fields[kTileId]) w.Field("tile_id", tileID);
+        w.EndObject();
+    };
+
+    // stitch:on：几何转为世界坐标片段，properties 先序列化，交给 SegmentStitcher 合并后输出
+    auto stitchSegment = [&](SegmentScratch& scratch, const auto& seg, const auto& geom,
+                             const AttributeRecordRange* attributes) {
+        converter::SegmentStitcher::Fragment fragment;
+        // host segment 的 host_tile_id 可能为 0，此时就是当前瓦片
+        fragment.host_tile_id = seg.host_tile_id() != 0 ? static_cast<uint64_t>(seg.host_tile_id()) : tileID;
+        fragment.local_id = static_cast<uint64_t>(seg.local_id());
+        fragment.tile_id = tileID;
+        fragment.world_bits = world_bits;
+
+        int8_t segmentStart = -1;
+        for (const auto& part : geom.parts()) {
+            const auto& line_string = part.geometry();
+            if (fields[kIsSegmentStart] && line_string.xy_coords_size() >= 2) {
+                const int8_t found = FindSegmentStart(nodeIndex, line_string.xy_coords(0), line_string.xy_coords(1), seg);
+                if (found >= 0) segmentStart = found;
+            }
+            const auto points = scratch.simplifier.Points(line_string);
+            for (size_t k = 0; k < points.second; ++k) {
+                fragment.points.push_back({static_cast<int64_t>(decoder.world_origin_x() + points.first[2 * k]),
+                                           static_cast<int64_t>(decoder.world_origin_y() + points.first[2 * k + 1])});
+            }
+        }
+
+        JsonWriter properties = options.stitcher->PropertiesWriter();
+        writeProperties(properties, scratch, seg, attributes, segmentStart);
+        fragment.properties = std::move(properties.buffer());
+        options.stitcher->Add(std::move(fragment));
+    };
+
+    // clip: 判断 segment 与区域的关系，需要裁剪时生成 pieces；返回 false 表示不输出
+    auto clipSegment = [&](SegmentScratch& scratch, const auto& geom, bool& cutGeometry,
+                           std::vector<std::vector<utils::WorldPoint>>& pieces) {
+        cutGeometry = false;
+        if (!clipper.active()) return true;
+        std::vector<utils::WorldPoint>& linePoints = scratch.linePoints;
+        linePoints.clear();
+        for (const auto& part : geom.parts()) {
+            clipper.AppendLine(part.geometry(), linePoints);
+        }
+        const utils::ClipResult where = clipper.Classify(linePoints);
+        if (where == utils::ClipResult::kOutside) return false;
+        cutGeometry = (where == utils::ClipResult::kPartial && clipper.mode() == utils::ClipMode::kCut);
+        if (cutGeometry) {
+            if (scratch.simplifier.active()) scratch.simplifier.Simplify(linePoints);
+            pieces = clipper.Cut(linePoints);
+            if (pieces.empty()) return false;   // 只擦过区域边界，没有剩下的片段
+        }
+        return true;
+    };
+
+    // 输出 clipSegment() 之后的 segment；attributes 为空表示 foreign segment。out 为 FeatureCollectionWriter 或 FeatureChunk
+    auto emitSegment = [&](auto& out, SegmentScratch& scratch, const auto& seg, const auto& geom,
+                           const AttributeRecordRange* attributes, bool cutGeometry,
+                           const std::vector<std::vector<utils::WorldPoint>>& pieces) {
+        utils::PolylineEncoder& encoder = scratch.encoder;
+        utils::LineSimplifier& simplifier = scratch.simplifier;
+        // clip:cut 裁剪后的几何可能分为多段，不参与拼接
+        if (options.stitcher && !cutGeometry) {
+            stitchSegment(scratch, seg, geom, attributes);
+            return;
+        }
+
+        JsonWriter& w = out.BeginFeature();
+        w.BeginObject();
+
+        // === geometry ===
+        int8_t segmentStart = -1;
+        const bool coordinates = !cutGeometry && !encoder.active();
+        w.Key("geometry");
+        if (coordinates) {
+            w.BeginObject();
+            w.Key("coordinates");
+            w.BeginArray();
+        }
+        encoder.Clear();
+        for (const auto& part : geom.parts()) {
+            const auto& line_string = part.geometry();
+            if (fields[kIsSegmentStart] && line_string.xy_coords_size() >= 2) {
+                const int8_t found = FindSegmentStart(nodeIndex, line_string.xy_coords(0), line_string.xy_coords(1), seg);
+                if (found >= 0) segmentStart = found;
+            }
+            if (cutGeometry) continue;
+
+            const auto points = simplifier.Points(line_string);
+            if (encoder.active()) encoder.AddLine(points.first, points.second, decoder);
+            else utils::WriteCoordinates(w, decoder, points.first, points.second, precision, scratch.coordBuffer);
+        }
+        if (coordinates) {
+            w.EndArray();
+            w.Field("type", "LineString");
+            w.EndObject();
+        } else if (!cutGeometry) {
+            encoder.WriteGeometry(w);
+        } else if (encoder.active()) {
+            encoder.WriteGeometry(w, pieces);
+        } else {
+            w.Value(clipper.ToGeometry(pieces, precision));
+        }
+
+        // === properties ===
+        w.Key("properties");
+        writeProperties(w, scratch, seg, attributes, segmentStart);
+
+        w.Field("type", "Feature");
+        w.EndObject();
+        out.EndFeature();
+    };
+
+    auto writeSegment = [&](auto& out, SegmentScratch& scratch, const auto& seg, const auto& geom,
+                            const AttributeRecordRange* attributes) {
+        bool cutGeometry = false;
+        std::vector<std::vector<utils::WorldPoint>> pieces;
+        if (!clipSegment(scratch, geom, cutGeometry, pieces)) return;
+        emitSegment(out, scratch, seg, geom, attributes, cutGeometry, pieces);
+    };
+
+    // 先 foreign segment 再 segment；[begin, end) 为两者连续编号后的区间
+    const size_t numForeign = layers.foreign_segments ? layers.foreign_segments->segments_size() : 0;
+    const size_t numSegments = layers.segments ? layers.segments->segments_size() : 0;
+    auto writeRange = [&](auto& out, size_t begin, size_t end) {
+        ocm::TileArena::Scope arenaScope;
+        SegmentScratch scratch(options, tile_key, world_bits);
+        for (size_t i = begin; i < std::min(end, numForeign); ++i) {
+            const auto& seg = layers.foreign_segments->segments(i);
+            if (pushdown.active() && !pushdown.Matches(MakeSegmentRecord(tileID, seg))) {
+                continue;
+            }
+            const auto& geom = layers.foreign_geometries->segments(i);
+            // stitch:on 时重复的片段由拼接器合并，不在这里去重
+            if (!options.dedup || options.stitcher) {
+                writeSegment(out, scratch, seg, geom, nullptr);
+                continue;
+            }
+            // 先裁剪再去重：被裁掉的副本不能占用键（filter 已全部下推，在上面判断过）
+            bool cutGeometry = false;
+            std::vector<std::vector<utils::WorldPoint>> pieces;
+            if (!clipSegment(scratch, geom, cutGeometry, pieces)) continue;
+            const auto copy = options.dedup->CheckForeign(static_cast<uint64_t>(seg.host_tile_id()),
+                                                          static_cast<uint64_t>(seg.local_id()));
+            if (copy == converter::SegmentDedup::ForeignCopy::kSkip) continue;
+            if (copy == converter::SegmentDedup::ForeignCopy::kDefer) {
+                converter::FeatureChunk chunk = options.dedup->NewChunk();
+                emitSegment(chunk, scratch, seg, geom, nullptr, cutGeometry, pieces);
+                options.dedup->Defer(static_cast<uint64_t>(seg.host_tile_id()), static_cast<uint64_t>(seg.local_id()), std::move(chunk));
+                continue;
+            }
+            emitSegment(out, scratch, seg, geom, nullptr, cutGeometry, pieces);
+        }
+        for (size_t i = std::max(begin, numForeign) - numForeign; i < end - std::min(end, numForeign); ++i) {
+            const auto& seg = layers.segments->segments(i);
+            const auto& attr = layers.attributes->segments(i);
+            if (pushdown.active() && !pushdown.Matches(MakeSegmentRecord(tileID, seg), &attr.attributes())) {
+                continue;
+            }
+            writeSegment(out, scratch, seg, layers.geometries->segments(i), &attr.attributes());
+        }
+    };
+
+    // attribute_dictionary 的编号按写出顺序分配，分块并行时顺序不确定
+    const size_t total = numForeign + numSegments;
+    if (!options.pool || options.attribute_dictionary || total < 2 * kSegmentsPerChunk) {
+        writeRange(out, 0, total);
+        return true;
+    }
+    const auto chunks = ocm::RunChunked(*options.pool, total, kSegmentsPerChunk, [&](size_t begin, size_t end) {
+        converter::FeatureChunk chunk(out.indent());
+        writeRange(chunk, begin, end);
+        return chunk;
+    });
+    for (const auto& chunk : chunks) out.AppendChunk(chunk);
+    return true;
+}
+
+bool ISADataToGeoJsonConverter::stream(const datastore::Response< datastore::TileLoadResult >& response, const olp::geo::TileKey &tile_key,
+    const converter::ConvertOptions& options, converter::FeatureCollectionWriter& out)
+{
+    return streamInternal(FindIsaLayers(response), tile_key, options, out);
+}
+
 json convertInternalForAdminRoutingContext(
     const clientmap::decoder::AdministrativeRoutingContextLayer& admin_routing_context_layer
     
@@ -0,0 +1,158 @@
+#include "IsaTileView.hpp"
+#include <LayerFinder.hpp>
+#include "TileIDConverter.hpp"
+
+namespace isa_converter {
+
+namespace ocm = ning::maps::ocm;
+
+IsaLayers FindIsaLayers(const datastore::Response< datastore::TileLoadResult >& response)
+{
+    const auto& layer_results = response.GetResult().GetLayersResults();
+
+    ocm::LayerFinder finder(layer_results);
+
+    IsaLayers layers;
+    layers.segments = finder.TryGetLayer<clientmap::decoder::IsaSegmentLayer>(clientmap::isa::kIsaSegmentLayerName);
+    layers.attributes = finder.TryGetLayer<clientmap::decoder::IsaSegmentAttributeLayer>(clientmap::isa::kIsaSegmentAttributeLayerName);
+    layers.geometries = finder.TryGetLayer<clientmap::decoder::IsaSegmentGeometryLayer>(clientmap::isa::kIsaSegmentGeometryLayerName);
+
+    layers.foreign_geometries = finder.TryGetLayer<clientmap::decoder::IsaForeignSegmentGeometryLayer>(clientmap::isa::kIsaForeignSegmentGeometryLayerName);
+    layers.foreign_segments = finder.TryGetLayer<clientmap::decoder::IsaForeignSegmentLayer>(clientmap::isa::kIsaForeignSegmentLayerName);
+
+    layers.nodes = finder.TryGetLayer<clientmap::decoder::IsaNodeLayer>(clientmap::isa::kIsaNodeLayerName);
+
+    //const auto* linkIdMapLayer = finder.TryGetLayer<clientmap::decoder::LinkIdMappingLayer>(clientmap::interop::kLinkIdMappingLayerName);
+    //const auto* segIdMapLayer = finder.TryGetLayer<clientmap::decoder::SegmentIdMappingLayer>(clientmap::interop::kSegmentIdMappingLayerName);
+
+    layers.world_bits = finder.GetWorldCoordinateBits(clientmap::isa::kIsaSegmentGeometryLayerName);
+    if(layers.world_bits == 0)
+        layers.world_bits = finder.GetWorldCoordinateBits(clientmap::isa::kIsaForeignSegmentGeometryLayerName);
+    return layers;
+}
+
+IsaTileView::IsaTileView(const datastore::Response< datastore::TileLoadResult >& response, const olp::geo::TileKey& tile_key)
+    : IsaTileView(FindIsaLayers(response), tile_key) {}
+
+IsaTileView::IsaTileView(const IsaLayers& layers, const olp::geo::TileKey& tile_key)
+    : layers_(layers),
+      tile_key_(tile_key),
+      tile_id_(TileIDConverter::XYtoTileId(tile_key.Column(), tile_key.Row(), tile_key.Level())),
+      decoder_(tile_key, layers.world_bits),
+      num_foreign_(layers.foreign_segments ? layers.foreign_segments->segments_size() : 0),
+      num_own_(layers.segments ? layers.segments->segments_size() : 0) {}
+
+IsaTileView::~IsaTileView() = default;
+
+const utils::SegmentStartIndex* IsaTileView::NodeIndex() const {
+    if (!layers_.nodes) return nullptr;
+    // 与转换器不同，view 的生命周期与 TileArena::Scope 无关，表固定用 new/delete 分配
+    std::call_once(node_index_once_, [this] {
+        node_index_.reset(new utils::SegmentStartIndex(*layers_.nodes, nullptr));
+    });
+    return node_index_.get();
+}
+
+namespace {
+
+// 按 SegmentRef 的下标分派到 foreign / 本瓦片的 segment 和几何，f(seg, geom)，geom 可能为 nullptr
+template <typename F>
+decltype(auto) VisitSegment(const IsaLayers& layers, size_t num_foreign, size_t index, F&& f)
+{
+    if (index < num_foreign) {
+        const int i = static_cast<int>(index);
+        const auto* geometries = layers.foreign_geometries;
+        return f(layers.foreign_segments->segments(i),
+                 geometries && i < geometries->segments_size() ? &geometries->segments(i) : nullptr);
+    }
+    const int i = static_cast<int>(index - num_foreign);
+    const auto* geometries = layers.geometries;
+    return f(layers.segments->segments(i),
+             geometries && i < geometries->segments_size() ? &geometries->segments(i) : nullptr);
+}
+
+} // namespace
+
+uint64_t SegmentRef::tile_id() const {
+    return view_->tile_id_;
+}
+
+uint64_t SegmentRef::local_id() const {
+    return VisitSegment(view_->layers_, view_->num_foreign_, index_, [](const auto& seg, const auto*) {
+        return static_cast<uint64_t>(seg.local_id());
+    });
+}
+
+uint64_t SegmentRef::host_tile_id() const {
+    return VisitSegment(view_->layers_, view_->num_foreign_, index_, [](const auto& seg, const auto*) {
+        return static_cast<uint64_t>(seg.host_tile_id());
+    });
+}
+
+double SegmentRef::length() const {
+    return VisitSegment(view_->layers_, view_->num_foreign_, index_, [](const auto& seg, const auto*) {
+        return static_cast<double>(seg.meter_length());
+    });
+}
+
+bool SegmentRef::foreign() const {
+    return index_ < view_->num_foreign_;
+}
+
+size_t SegmentRef::part_count() const {
+    return VisitSegment(view_->layers_, view_->num_foreign_, index_, [](const auto&, const auto* geom) {
+        return geom ? static_cast<size_t>(geom->parts_size()) : size_t{0};
+    });
+}
+
+const utils::LineString& SegmentRef::part(size_t k) const {
+    return VisitSegment(view_->layers_, view_->num_foreign_, index_,
+                        [k](const auto&, const auto* geom) -> const utils::LineString& {
+        return geom->parts(static_cast<int>(k)).geometry();
+    });
+}
+
+void SegmentRef::Coordinates(std::vector<double>& lng, std::vector<double>& lat) const {
+    lng.clear();
+    lat.clear();
+    const utils::CoordinateDecoder& decoder = view_->decoder_;
+    VisitSegment(view_->layers_, view_->num_foreign_, index_, [&](const auto&, const auto* geom) {
+        if (!geom) return;
+        for (const auto& part : geom->parts()) {
+            const auto& line_string = part.geometry();
+            const size_t count = static_cast<size_t>(line_string.xy_coords_size()) / 2;
+            if (count == 0) continue;
+            const size_t offset = lng.size();
+            lng.resize(offset + count);
+            lat.resize(offset + count);
+            decoder.Decode(line_string.xy_coords().data(), count, lng.data() + offset, lat.data() + offset);
+        }
+    });
+}
+
+const SegmentRef::AttributeRange* SegmentRef::attributes() const {
+    const auto* layer = view_->layers_.attributes;
+    if (foreign() || !layer) return nullptr;
+    const int i = static_cast<int>(index_ - view_->num_foreign_);
+    return i < layer->segments_size() ? &layer->segments(i).attributes() : nullptr;
+}
+
+int8_t SegmentRef::is_segment_start() const {
+    const utils::SegmentStartIndex* nodeIndex = view_->NodeIndex();
+    if (!nodeIndex) return -1;
+    return VisitSegment(view_->layers_, view_->num_foreign_, index_, [nodeIndex](const auto& seg, const auto* geom) {
+        int8_t result = -1;
+        if (!geom) return result;
+        for (const auto& part : geom->parts()) {
+            const auto& line_string = part.geometry();
+            if (line_string.xy_coords_size() < 2) continue;
+            const int8_t found = nodeIndex->Find(line_string.xy_coords(0), line_string.xy_coords(1),
+                                                 static_cast<uint64_t>(seg.local_id()),
+                                                 static_cast<uint64_t>(seg.host_tile_id()));
+            if (found >= 0) result = found;
+        }
+        return result;
+    });
+}
+
+} // namespace isa_converter
@@ -0,0 +1,152 @@
+// LineSimplifier.cpp
+#include "LineSimplifier.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+
+namespace utils {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// WGS84 赤道上 1 度的长度（米）
+constexpr double kMetersPerDegree = 6378137.0 * kPi / 180.0;
+
+// 256 像素瓦片的 0 级地图在赤道上每像素的地面距离（米）
+constexpr double kMetersPerPixelZoom0 = 2.0 * kPi * 6378137.0 / 256.0;
+
+// 高纬度 cos 接近 0 时的下限，避免 x 方向的距离被压缩为 0
+constexpr double kMinCosLatitude = 0.01;
+
+} // namespace
+
+SimplifyTolerance ParseSimplifyTolerance(const std::string& value) {
+    SimplifyTolerance tolerance;
+    if (value.empty() || value == "none") return tolerance;
+
+    if (value[0] == 'z' || value[0] == 'Z') {
+        const std::string digits = value.substr(1);
+        const bool numeric = std::all_of(digits.begin(), digits.end(),
+                                         [](unsigned char c) { return std::isdigit(c) != 0; });
+        if (digits.empty() || digits.size() > 2 || !numeric) {
+            throw std::invalid_argument("Invalid simplify zoom: " + value);
+        }
+        tolerance.zoom = std::stoi(digits);
+        if (tolerance.zoom > kMaxSimplifyZoom) {
+            throw std::invalid_argument("Simplify zoom out of range: " + value);
+        }
+        return tolerance;
+    }
+
+    std::string number = value;
+    if (number.back() == 'm') number.pop_back();
+    size_t used = 0;
+    double meters = 0.0;
+    try {
+        meters = std::stod(number, &used);
+    } catch (const std::exception&) {
+        throw std::invalid_argument("Invalid simplify tolerance: " + value);
+    }
+    if (used != number.size() || !std::isfinite(meters) || meters < 0.0) {
+        throw std::invalid_argument("Invalid simplify tolerance: " + value);
+    }
+    tolerance.meters = meters;
+    return tolerance;
+}
+
+LineSimplifier::LineSimplifier(const SimplifyTolerance& tolerance, const olp::geo::TileKey& tile_key, uint32_t world_bits) {
+    if (!tolerance.active()) return;
+
+    // 瓦片中心纬度：LAT = Row * 360 / 2^level - 90
+    const double lat = std::ldexp((tile_key.Row() + 0.5) * 360.0, -static_cast<int>(tile_key.Level())) - 90.0;
+    const double cos_lat = std::max(std::cos(lat * kPi / 180.0), kMinCosLatitude);
+
+    scale_y_ = std::ldexp(360.0, -static_cast<int>(world_bits)) * kMetersPerDegree;
+    scale_x_ = scale_y_ * cos_lat;
+
+    const double meters = tolerance.zoom >= 0
+        ? std::ldexp(kMetersPerPixelZoom0 * cos_lat, -tolerance.zoom)
+        : tolerance.meters;
+    tolerance_sq_ = meters * meters;
+}
+
+double LineSimplifier::tolerance_meters() const {
+    return std::sqrt(tolerance_sq_);
+}
+
+template <typename Point>
+void LineSimplifier::Mark(size_t count, Point point) {
+    keep_.assign(count, 0);
+    keep_.front() = 1;
+    keep_.back() = 1;
+
+    stack_.clear();
+    stack_.emplace_back(0, count - 1);
+    while (!stack_.empty()) {
+        const size_t first = stack_.back().first;
+        const size_t last = stack_.back().second;
+        stack_.pop_back();
+        if (last - first < 2) continue;
+
+        const auto a = point(first);
+        const auto b = point(last);
+        const double ax = static_cast<double>(a.first) * scale_x_;
+        const double ay = static_cast<double>(a.second) * scale_y_;
+        const double dx = static_cast<double>(b.first) * scale_x_ - ax;
+        const double dy = static_cast<double>(b.second) * scale_y_ - ay;
+        const double length_sq = dx * dx + dy * dy;
+
+        double max_sq = -1.0;
+        size_t farthest = first;
+        for (size_t i = first + 1; i < last; ++i) {
+            const auto p = point(i);
+            double px = static_cast<double>(p.first) * scale_x_ - ax;
+            double py = static_cast<double>(p.second) * scale_y_ - ay;
+            // 点到线段 ab 的距离：投影参数截断到 [0, 1]；a、b 重合（环线）时为到 a 的距离
+            if (length_sq > 0.0) {
+                const double t = std::min(1.0, std::max(0.0, (px * dx + py * dy) / length_sq));
+                px -= t * dx;
+                py -= t * dy;
+            }
+            const double d_sq = px * px + py * py;
+            if (d_sq > max_sq) {
+                max_sq = d_sq;
+                farthest = i;
+            }
+        }
+        if (max_sq > tolerance_sq_) {
+            keep_[farthest] = 1;
+            stack_.emplace_back(first, farthest);
+            stack_.emplace_back(farthest, last);
+        }
+    }
+}
+
+const std::vector<uint32_t>& LineSimplifier::Simplify(const uint32_t* xy, size_t count) {
+    out_.clear();
+    if (count <= 2) {
+        out_.assign(xy, xy + 2 * count);
+        return out_;
+    }
+    Mark(count, [xy](size_t i) { return std::make_pair(xy[2 * i], xy[2 * i + 1]); });
+    for (size_t i = 0; i < count; ++i) {
+        if (!keep_[i]) continue;
+        out_.push_back(xy[2 * i]);
+        out_.push_back(xy[2 * i + 1]);
+    }
+    return out_;
+}
+
+void LineSimplifier::Simplify(std::vector<WorldPoint>& line) {
+    if (line.size() <= 2) return;
+    Mark(line.size(), [&line](size_t i) { return std::make_pair(line[i].x, line[i].y); });
+    size_t kept = 0;
+    for (size_t i = 0; i < line.size(); ++i) {
+        if (keep_[i]) line[kept++] = line[i];
+    }
+    line.resize(kept);
+}
+
+} // namespace utils
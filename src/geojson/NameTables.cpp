@@ -0,0 +1,119 @@
+#include "NameTables.hpp"
+#include <cstring>
+#include <stdexcept>
+
+namespace converter {
+
+using json = nlohmann::json;
+
+FlagNameTable::FlagNameTable(const BitFlag* flags, size_t count) {
+    std::vector<const char*> names;
+    for (size_t i = 0; i < count; ++i) {
+        if (flags[i].bit == 0) continue;
+        if (bits_.size() == kMaxFlags) {
+            throw std::invalid_argument("Too many flags in bitmask name table");
+        }
+        if (flags[i].bit != (uint32_t{1} << bits_.size())) direct_ = false;
+        bits_.push_back(flags[i].bit);
+        names.push_back(flags[i].name);
+        quoted_.push_back(JsonWriter::Quote(flags[i].name, std::strlen(flags[i].name)));
+        all_bits_ |= flags[i].bit;
+    }
+
+    const size_t entries = size_t{1} << bits_.size();
+    arrays_.reserve(entries);
+    joined_.reserve(entries);
+    for (size_t index = 0; index < entries; ++index) {
+        json active = json::array();
+        std::string joined;
+        for (size_t i = 0; i < names.size(); ++i) {
+            if (!(index & (size_t{1} << i))) continue;
+            active.push_back(names[i]);
+            if (!joined.empty()) joined += ", ";
+            joined += names[i];
+        }
+        arrays_.push_back(std::move(active));
+        joined_.push_back(std::move(joined));
+    }
+}
+
+void FlagNameTable::Write(JsonWriter& w, uint32_t mask) const {
+    w.BeginArray();
+    for (size_t index = Index(mask), i = 0; index != 0; index >>= 1, ++i) {
+        if (index & 1) w.RawValue(quoted_[i]);
+    }
+    w.EndArray();
+}
+
+void FlagNameTable::WriteObject(JsonWriter& w, uint32_t mask) const {
+    w.BeginObject();
+    w.Key("active");
+    Write(w, mask);
+    w.Field("is_empty", mask == 0);
+    w.Field("raw", mask);
+    w.EndObject();
+}
+
+json FlagNameTable::ObjectJson(uint32_t mask) const {
+    json j;
+    j["raw"] = mask;
+    j["active"] = Json(mask);
+    j["is_empty"] = (mask == 0);
+    return j;
+}
+
+namespace {
+
+// 值的范围不超过此大小时直接寻址
+constexpr int64_t kMaxDenseRange = 4096;
+
+} // namespace
+
+EnumNameTable::EnumNameTable(const google::protobuf::EnumDescriptor* descriptor) {
+    const int count = descriptor->value_count();
+    int64_t min = 0;
+    int64_t max = -1;
+    for (int i = 0; i < count; ++i) {
+        const int64_t number = descriptor->value(i)->number();
+        if (i == 0 || number < min) min = number;
+        if (i == 0 || number > max) max = number;
+    }
+
+    if (max - min + 1 <= kMaxDenseRange) {
+        min_ = static_cast<int>(min);
+        dense_ = static_cast<size_t>(max - min + 1);
+        names_.resize(dense_ + 1);
+        std::vector<bool> assigned(dense_, false);
+        for (int i = 0; i < count; ++i) {
+            const auto* value = descriptor->value(i);
+            const size_t slot = static_cast<size_t>(value->number() - min_);
+            if (assigned[slot]) continue;   // 别名：保留第一个名称
+            assigned[slot] = true;
+            names_[slot] = value->name();
+        }
+    } else {
+        for (int i = 0; i < count; ++i) {
+            const auto* value = descriptor->value(i);
+            if (sparse_.emplace(value->number(), names_.size()).second) names_.push_back(value->name());
+        }
+        names_.emplace_back();
+    }
+
+    quoted_.reserve(names_.size());
+    for (const auto& name : names_) quoted_.push_back(JsonWriter::Quote(name));
+}
+
+size_t EnumNameTable::Slot(int value) const {
+    if (dense_ != 0 || sparse_.empty()) {
+        const int64_t offset = static_cast<int64_t>(value) - min_;
+        return offset >= 0 && offset < static_cast<int64_t>(dense_) ? static_cast<size_t>(offset) : dense_;
+    }
+    const auto it = sparse_.find(value);
+    return it != sparse_.end() ? it->second : names_.size() - 1;
+}
+
+const std::string& EnumNameTable::Name(int value) const {
+    return names_[Slot(value)];
+}
+
+} // namespace converter
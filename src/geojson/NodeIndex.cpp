@@ -0,0 +1,84 @@
+// NodeIndex.cpp
+#include "NodeIndex.hpp"
+
+namespace utils {
+
+namespace {
+
+uint64_t MakeCoordKey(uint32_t x, uint32_t y) {
+    return (static_cast<uint64_t>(x) << 32) | y;
+}
+
+// Fibonacci 散列：乘法后取高位
+uint64_t Mix(uint64_t h) {
+    h ^= h >> 32;
+    return h * 0x9e3779b97f4a7c15ull;
+}
+
+} // namespace
+
+constexpr uint32_t SegmentStartIndex::kEmpty;
+
+SegmentStartIndex::SegmentStartIndex(const NodeLayer& layer)
+    : SegmentStartIndex(layer, ning::maps::ocm::TileArena::Active()) {}
+
+SegmentStartIndex::SegmentStartIndex(const NodeLayer& layer, ning::maps::ocm::TileArena* arena)
+    : slots_(ning::maps::ocm::ArenaAllocator<Slot>(arena)),
+      ends_(ning::maps::ocm::ArenaAllocator<SegmentEnd>(arena)) {
+    size_t capacity = 16;
+    while (capacity < 2 * static_cast<size_t>(layer.nodes_size())) capacity <<= 1;
+    slots_.assign(capacity, Slot{0, kEmpty, kEmpty});
+    mask_ = capacity - 1;
+    shift_ = 64;
+    for (size_t c = capacity; c > 1; c >>= 1) --shift_;
+
+    size_t numEnds = 0;
+    for (const auto& node : layer.nodes()) {
+        numEnds += static_cast<size_t>(node.connected_segments_size());
+    }
+    ends_.reserve(numEnds);
+
+    const int numSegments = layer.segments_size();
+    for (const auto& node : layer.nodes()) {
+        const uint32_t begin = static_cast<uint32_t>(ends_.size());
+        for (const auto& segmentEnd : node.connected_segments()) {
+            const int index = static_cast<int>(segmentEnd.segment_index());
+            if (index < 0 || index >= numSegments) continue;
+            const auto& segment = layer.segments(index);
+            ends_.push_back({static_cast<uint64_t>(segment.local_id()),
+                             static_cast<uint64_t>(segment.host_tile_id()),
+                             static_cast<int8_t>(segmentEnd.is_segment_start() ? 1 : 0)});
+        }
+
+        const uint64_t coord = MakeCoordKey(node.x(), node.y());
+        Slot& slot = slots_[Probe(coord)];
+        if (slot.begin == kEmpty) ++nodes_;
+        slot.coord = coord;
+        slot.begin = begin;
+        slot.end = static_cast<uint32_t>(ends_.size());
+    }
+}
+
+size_t SegmentStartIndex::Probe(uint64_t coord) const {
+    size_t i = static_cast<size_t>(Mix(coord) >> shift_);
+    while (slots_[i].begin != kEmpty && slots_[i].coord != coord) {
+        i = (i + 1) & mask_;
+    }
+    return i;
+}
+
+int8_t SegmentStartIndex::Find(uint32_t x, uint32_t y, uint64_t local_id, uint64_t host_tile_id) const {
+    const Slot& slot = slots_[Probe(MakeCoordKey(x, y))];
+    if (slot.begin == kEmpty) return -1;
+
+    int8_t result = -1;
+    for (uint32_t i = slot.begin; i < slot.end; ++i) {
+        const SegmentEnd& end = ends_[i];
+        if (end.local_id == local_id && end.host_tile_id == host_tile_id) {
+            result = end.is_start;
+        }
+    }
+    return result;
+}
+
+} // namespace utils
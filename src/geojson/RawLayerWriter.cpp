@@ -0,0 +1,246 @@
+#include "RawLayerWriter.hpp"
+#include <stdexcept>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/util/json_util.h>
+#include <nlohmann/json.hpp>
+
+namespace common_converter {
+
+namespace {
+
+std::string Quote(const std::string& s) {
+    return nlohmann::json(s).dump();
+}
+
+const char kPbMagic[] = "OCMRAWPB";
+constexpr size_t kPbMagicSize = 8;
+constexpr uint64_t kPbVersion = 1;
+
+void AppendVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+void AppendBytes(std::string& out, const std::string& bytes) {
+    AppendVarint(out, bytes.size());
+    out += bytes;
+}
+
+// 文件正好在记录边界结束时 eof_ok 为 true，返回 false；其余情况下读不到数据视为截断
+bool ReadVarint(std::istream& in, uint64_t& value, bool eof_ok = false) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        const int c = in.get();
+        if (c == std::char_traits<char>::eof()) {
+            if (eof_ok && shift == 0) return false;
+            throw std::runtime_error("Truncated raw layer file");
+        }
+        value |= static_cast<uint64_t>(c & 0x7F) << shift;
+        if ((c & 0x80) == 0) return true;
+    }
+    throw std::runtime_error("Malformed varint in raw layer file");
+}
+
+void ReadBytes(std::istream& in, std::string& bytes) {
+    uint64_t size = 0;
+    ReadVarint(in, size);
+    bytes.resize(static_cast<size_t>(size));
+    if (size > 0 && !in.read(&bytes[0], static_cast<std::streamsize>(size))) {
+        throw std::runtime_error("Truncated raw layer file");
+    }
+}
+
+} // namespace
+
+RawDumpFormat ParseRawDumpFormat(const std::string& name) {
+    if (name.empty() || name == "none") return RawDumpFormat::kNone;
+    if (name == "json") return RawDumpFormat::kJson;
+    if (name == "pb") return RawDumpFormat::kProtobuf;
+    throw std::invalid_argument("Unknown raw dump format: " + name);
+}
+
+const char* RawDumpExtension(RawDumpFormat format) {
+    switch (format) {
+    case RawDumpFormat::kJson: return ".json";
+    case RawDumpFormat::kProtobuf: return ".pb";
+    default: return "";
+    }
+}
+
+RawLayerWriter::RawLayerWriter(const std::string& path, const std::string& tile_key, size_t layer_count)
+    : path_(path), tile_key_(tile_key), layer_count_(layer_count)
+{
+}
+
+RawLayerWriter::RawLayerWriter(std::ostream& out, const std::string& tile_key, size_t layer_count)
+    : out_(&out), tile_key_(tile_key), layer_count_(layer_count)
+{
+}
+
+RawLayerWriter::~RawLayerWriter() {
+    try {
+        Close();
+    } catch (...) {
+    }
+}
+
+void RawLayerWriter::Write(const char* data, size_t size) {
+    out_->write(data, static_cast<std::streamsize>(size));
+    if (!out_->good()) {
+        throw std::runtime_error("Failed to write raw layer JSON");
+    }
+    bytes_written_ += size;
+}
+
+bool RawLayerWriter::WriteLayer(const google::protobuf::Message& msg, const std::string& layer_name, size_t layer_index) {
+    if (!Serialize(msg, buffer_)) return false;
+    WriteSerialized(buffer_, layer_name, layer_index);
+    return true;
+}
+
+bool RawLayerWriter::Serialize(const google::protobuf::Message& msg, std::string& json) {
+    google::protobuf::util::JsonPrintOptions print_options;
+    print_options.add_whitespace = true;   // 保留缩进，便于阅读
+
+    json.clear();
+    const auto status = google::protobuf::util::MessageToJsonString(msg, &json, print_options);
+    if (!status.ok()) return false;
+
+    // 空消息序列化为 "{}"（可能带换行），与原来跳过空 JSON 的处理一致
+    const size_t open = json.find('{');
+    if (open == std::string::npos) return false;
+    const size_t first = json.find_first_not_of(" \n", open + 1);
+    return first != std::string::npos && json[first] != '}';
+}
+
+void RawLayerWriter::WriteSerialized(const std::string& json, const std::string& layer_name, size_t layer_index) {
+    const size_t open = json.find('{');
+    const size_t first = json.find_first_not_of(" \n", open + 1);
+    const size_t close = json.find_last_of('}');
+
+    if (!out_) {
+        file_.open(path_, std::ios::out | std::ios::trunc | std::ios::binary);
+        if (!file_.is_open()) {
+            throw std::runtime_error("Failed to open output file: " + path_);
+        }
+        out_ = &file_;
+    }
+    if (layers_ == 0) Write("{\n    \"features\": [\n");
+    else Write(",\n");
+
+    // layer_meta 沿用 protobuf 输出中第一个字段前的换行和缩进
+    Write("{" + json.substr(open + 1, first - open - 1) + "\"layer_meta\": {\"layer_index\": " + std::to_string(layer_index) +
+          ", \"layer_name\": " + Quote(layer_name) + ", \"tile_key\": " + Quote(tile_key_) + "},");
+    Write(json.data() + open + 1, close - open);
+    ++layers_;
+}
+
+void RawLayerWriter::Close() {
+    if (closed_) return;
+    closed_ = true;
+    if (layers_ == 0) return;
+
+    // 键按字典序，与原来 nlohmann::json 输出的顺序相同
+    Write("\n    ],\n    \"layer_count\": " + std::to_string(layer_count_) +
+          ",\n    \"tile_key\": " + Quote(tile_key_) +
+          ",\n    \"type\": \"FeatureCollection\"\n}\n");
+    out_->flush();
+    if (!out_->good()) {
+        throw std::runtime_error("Failed to write raw layer JSON");
+    }
+}
+
+// ------------------------- RawLayerPbWriter -------------------------
+
+RawLayerPbWriter::RawLayerPbWriter(const std::string& path, const std::string& tile_key)
+    : path_(path), tile_key_(tile_key)
+{
+}
+
+RawLayerPbWriter::RawLayerPbWriter(std::ostream& out, const std::string& tile_key)
+    : out_(&out), tile_key_(tile_key)
+{
+}
+
+RawLayerPbWriter::~RawLayerPbWriter() {
+    try {
+        Close();
+    } catch (...) {
+    }
+}
+
+void RawLayerPbWriter::Write(const std::string& data) {
+    out_->write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!out_->good()) {
+        throw std::runtime_error("Failed to write raw layer protobuf");
+    }
+    bytes_written_ += data.size();
+}
+
+bool RawLayerPbWriter::WriteLayer(const google::protobuf::Message& msg, const std::string& layer_name, size_t layer_index) {
+    if (!msg.SerializeToString(&payload_)) return false;
+
+    header_.clear();
+    if (!out_) {
+        file_.open(path_, std::ios::out | std::ios::trunc | std::ios::binary);
+        if (!file_.is_open()) {
+            throw std::runtime_error("Failed to open output file: " + path_);
+        }
+        out_ = &file_;
+    }
+    if (layers_ == 0) {
+        header_.append(kPbMagic, kPbMagicSize);
+        AppendVarint(header_, kPbVersion);
+        AppendBytes(header_, tile_key_);
+    }
+    AppendVarint(header_, layer_index);
+    AppendBytes(header_, layer_name);
+    AppendBytes(header_, msg.GetDescriptor()->full_name());
+    AppendVarint(header_, payload_.size());
+    Write(header_);
+    Write(payload_);
+    ++layers_;
+    return true;
+}
+
+void RawLayerPbWriter::Close() {
+    if (closed_) return;
+    closed_ = true;
+    if (layers_ == 0) return;
+    out_->flush();
+    if (!out_->good()) {
+        throw std::runtime_error("Failed to write raw layer protobuf");
+    }
+}
+
+// ------------------------- RawLayerPbReader -------------------------
+
+RawLayerPbReader::RawLayerPbReader(std::istream& in)
+    : in_(in)
+{
+    char magic[kPbMagicSize];
+    if (!in_.read(magic, kPbMagicSize) || std::string(magic, kPbMagicSize) != std::string(kPbMagic, kPbMagicSize)) {
+        throw std::runtime_error("Not a raw layer protobuf file");
+    }
+    uint64_t version = 0;
+    ReadVarint(in_, version);
+    if (version != kPbVersion) {
+        throw std::runtime_error("Unsupported raw layer file version: " + std::to_string(version));
+    }
+    ReadBytes(in_, tile_key_);
+}
+
+bool RawLayerPbReader::Next(RawLayerRecord& record) {
+    uint64_t index = 0;
+    if (!ReadVarint(in_, index, true)) return false;
+    record.layer_index = static_cast<uint32_t>(index);
+    ReadBytes(in_, record.layer_name);
+    ReadBytes(in_, record.type_name);
+    ReadBytes(in_, record.payload);
+    return true;
+}
+
+} // namespace common_converter
@@ -1,4 +1,11 @@
 #include "RoadDataToGeoJsonConverter.hpp"
+#include "FeatureFilter.hpp"
+#include "SpatialClip.hpp"
+#include "LineSimplifier.hpp"
+#include "GeoJsonWriter.hpp"
+#include "AttributeTables.hpp"
+#include "TileArena.hpp"
+#include "GeometryUtils.hpp"
 #include <olp/core/logging/Log.h>
 #include <fstream>
 #include <cmath>
@@ -48,138 +55,51 @@ void validate_layer_sizes(
     }
 }
 json extract_geometry(
-    const com::here::platform::schema::clientmap::v1::layers::common::LineString& line_string, 
+    const utils::LineString& line_string, 
     const olp::geo::TileKey& kTileKey,
-    uint32_t world_coordinate_bits) 
+    uint32_t world_coordinate_bits,
+    int precision,
+    utils::PolylineEncoder& encoder,
+    utils::LineSimplifier& simplifier) 
 {
-    int level = 14;
+    if (!encoder.active() && !simplifier.active()) {
+        return utils::ExtractGeometry(line_string, kTileKey, world_coordinate_bits, precision);
+    }
+
+    const utils::CoordinateDecoder decoder(kTileKey, world_coordinate_bits, utils::kRenderingGeometryLevel);
+    const auto points = simplifier.Points(line_string);
+    if (encoder.active()) {
+        encoder.Clear();
+        encoder.AddLine(points.first, points.second, decoder);
+        return encoder.ToGeometry();
+    }
     json geometry;
     geometry["type"] = "LineString";
     geometry["coordinates"] = json::array();
-
-    int num_coords = line_string.xy_coords_size();
-    // 格式化 xy_coords 为 (Latitude, Longitude), (Latitude, Longitude),... 的字符串
-    std::stringstream coords_stream;
-    for (int j = 0; j < num_coords; j += 2) {  // 每次处理两个坐标（经度和纬度）
-        // 检查是否越界（避免 j+1 超过数组范围）
-        if (j + 1 >= num_coords) break;
-
-        // 获取当前点的经度（x）和纬度（y）的坐标值（uint32）
-        uint32_t x_coord = line_string.xy_coords(j);   // 经度（第 j 个元素）
-        uint32_t y_coord = line_string.xy_coords(j + 1); // 纬度（第 j+1 个元素）
-
-        // 计算经度（LNG）的实际值（度）
-        uint32_t I_LNG_TILE = kTileKey.Column() << (world_coordinate_bits - level);
-        uint32_t I_LNG = I_LNG_TILE + x_coord;
-        double LNG = (I_LNG * 360.0) / (1 << world_coordinate_bits) - 180.0;
-
-        // 计算纬度（LAT）的实际值（度）
-        uint32_t I_LAT_TILE = kTileKey.Row() << (world_coordinate_bits - level);
-        uint32_t I_LAT = I_LAT_TILE + y_coord;
-        double LAT = (I_LAT * 360.0) / (1 << world_coordinate_bits) - 90.0;
-
-
-        geometry["coordinates"].push_back({ LNG, LAT });
-    }
-
+    utils::CoordinateBuffer buffer;
+    utils::AppendCoordinates(geometry["coordinates"], decoder, points.first, points.second, precision, buffer);
     return geometry;
 }
-json convert_local_road_bitmask(uint32_t bitmask) {
-    json j = json::array();
-
-    if (bitmask & LOCAL_ROAD_EMPTY)       j.push_back("LOCAL_ROAD_EMPTY");
-    if (bitmask & FRONTAGE)               j.push_back("FRONTAGE");
-    if (bitmask & PARKING_LOT_ROAD)       j.push_back("PARKING_LOT_ROAD");
-    if (bitmask & POI_ACCESS)             j.push_back("POI_ACCESS");
-
-    return j;
-}
-// 将 bitmask 转为 JSON 数组，列出所有 active 的标记名称
-json convert_road_usage_bitmask(uint32_t bitmask) {
-    json j = json::array();
-
-    if (bitmask & ROAD_USAGE_EMPTY)        j.push_back("ROAD_USAGE_EMPTY");
-    if (bitmask & CARPOOL_ROAD)           j.push_back("CARPOOL_ROAD");
-    if (bitmask & CONTROLLED_ACCESS)      j.push_back("CONTROLLED_ACCESS");
-    if (bitmask & EXPRESS_LANE)           j.push_back("EXPRESS_LANE");
-    if (bitmask & LIMITED_ACCESS)         j.push_back("LIMITED_ACCESS");
-    if (bitmask & PRIORITY_ROAD)          j.push_back("PRIORITY_ROAD");
-    if (bitmask & RAMP)                   j.push_back("RAMP");
-    if (bitmask & REVERSIBLE)             j.push_back("REVERSIBLE");
-    if (bitmask & TOLLWAY)                j.push_back("TOLLWAY");
-    if (bitmask & DIMINISHED_PRIORITY)    j.push_back("DIMINISHED_PRIORITY");
-    if (bitmask & PUBLIC_ACCESS)          j.push_back("PUBLIC_ACCESS");
-
-    return j;
+// bitmask -> json（名称表见 AttributeTables.hpp）
+const json& convert_local_road_bitmask(uint32_t bitmask) {
+    return converter::LocalRoadFlagNames().Json(bitmask);
 }
-enum PhysicalBitMask {
-    PHYSICAL_EMPTY = 0,
-    BOAT_FERRY = 1 << 0, // 1
-    BRIDGE = 1 << 1, //2
-    MULTIPLY_DIGITIZED = 1 << 2, // 3
-    PAVED = 1 << 3, // 4
-    PRIVATE = 1 << 4, // 5
-    RAIL_FERRY = 1 << 5, // 6
-    TUNNEL = 1 << 6, // 7
-    DELIVERY_ROAD = 1 << 7, // 8
-    MOVABLE_BRIDGE = 1 << 8 //9
-};
-
-// Bitmask 转字符串函数
-std::string PhisicalBitmaskToString(uint32_t bitmask) {
-    if (bitmask == PHYSICAL_EMPTY) {
-        return "PHYSICAL_EMPTY";
-    }
 
-    std::vector<std::string> parts;
-
-    if (bitmask & BOAT_FERRY) {
-        parts.emplace_back("BOAT_FERRY");
-    }
-    if (bitmask & BRIDGE) {
-        parts.emplace_back("BRIDGE");
-    }
-        if (bitmask & MULTIPLY_DIGITIZED) {
-        parts.emplace_back("MULTIPLY_DIGITIZED");
-    }
-    if (bitmask & PAVED) {
-        parts.emplace_back("PAVED");
-    }
+const json& convert_road_usage_bitmask(uint32_t bitmask) {
+    return converter::RoadUsageFlagNames().Json(bitmask);
+}
 
-    if (bitmask & PRIVATE) {
-        parts.emplace_back("PRIVATE");
-    }
-    if (bitmask & RAIL_FERRY) {
-        parts.emplace_back("RAIL_FERRY");
-    }
-        if (bitmask & TUNNEL) {
-        parts.emplace_back("TUNNEL");
-    }
-    if (bitmask & DELIVERY_ROAD) {
-        parts.emplace_back("DELIVERY_ROAD");
+// Bitmask 转字符串函数：逗号分隔的标记名称
+const std::string& PhisicalBitmaskToString(uint32_t bitmask) {
+    static const std::string kEmpty = "PHYSICAL_EMPTY";
+    if (bitmask == 0) {
+        return kEmpty;
     }
-        if (bitmask & MOVABLE_BRIDGE) {
-        parts.emplace_back("MOVABLE_BRIDGE");
-    }
-    // 拼接成逗号分隔的字符串
-    std::ostringstream oss;
-    for (size_t i = 0; i < parts.size(); ++i) {
-        if (i > 0) oss << ", ";
-        oss << parts[i];
-    }
-    std::string ossstr = oss.str();
-    return ossstr;
+    return converter::PhysicalFlagNames().Joined(bitmask);
 }
 
-json bitmaskToJson(uint32_t mask) {
-    json arr = json::array();
-    if (mask & AccessBitMask::AUTOMOBILES) arr.push_back("AUTOMOBILES");
-    if (mask & AccessBitMask::BUSES) arr.push_back("BUSES");
-    if (mask & AccessBitMask::TRUCKS) arr.push_back("TRUCKS");
-    if (mask & AccessBitMask::PEDESTRIANS) arr.push_back("PEDESTRIANS");
-    if (mask & AccessBitMask::MOTORCYCLES) arr.push_back("MOTORCYCLES");
-    // ... 其他 bitmask
-    return arr;
+const json& bitmaskToJson(uint32_t mask) {
+    return converter::AccessFlagNames().Json(mask);
 }
 
 static uint32_t GetWorldCoordinateBits(const datastore::LayerLoadResult &layer_result)
@@ -193,45 +113,110 @@ static uint32_t GetWorldCoordinateBits(const datastore::LayerLoadResult &layer_r
     }
     return 0;
 }
-json convert_attribute(const clientmap::decoder::RoadAttributeLayer::Attributes& attr) {
-    json a;
-    // 下面按存在的方法调用：如果你的 proto 生成类方法名不同，请按实际修改
+// ------------------------- 过滤下推 -------------------------
+// 字段与 convert_attribute / convertInternal 输出中的标量字段一一对应（取最终写入的值）
+
+using AttributeRecord = clientmap::decoder::RoadAttributeLayer::Attributes;
+
+struct SegmentRecord {
+    uint64_t local_id;
+};
+
+using feature_filter::ToFieldValue;
+using RoadFilterPushdown = feature_filter::FilterPushdown<SegmentRecord, AttributeRecord>;
+
+const feature_filter::FieldGetter<SegmentRecord> kSegmentFields[] = {
+    {"local_id", [](const SegmentRecord& s) { return ToFieldValue(s.local_id); }},
+};
+
+const feature_filter::FieldGetter<AttributeRecord> kAttributeFields[] = {
+    {"functional_class",               [](const AttributeRecord& a) { return ToFieldValue(converter::FunctionalClassNames().Name(a.functional_class())); },
+                                       [](const AttributeRecord& a) { return ToFieldValue(a.functional_class()); }},
+    {"travel_direction",               [](const AttributeRecord& a) { return ToFieldValue(converter::RelativeDirectionNames().Name(a.travel_direction())); },
+                                       [](const AttributeRecord& a) { return ToFieldValue(a.travel_direction()); }},
+    {"physical",                       [](const AttributeRecord& a) { return ToFieldValue(PhisicalBitmaskToString(a.physical())); },
+                                       [](const AttributeRecord& a) { return ToFieldValue(a.physical()); }},
+    {"under_construction",             [](const AttributeRecord& a) { return ToFieldValue(a.under_construction()); }},
+    {"z_level",                        [](const AttributeRecord& a) { return ToFieldValue(a.z_level()); }},
+    {"state_code",                     [](const AttributeRecord& a) { return ToFieldValue(a.state_code()); }},
+    {"has_polygonal_geometry",         [](const AttributeRecord& a) { return ToFieldValue(a.has_polygonal_geometry()); }},
+    {"truck_toll",                     [](const AttributeRecord& a) { return ToFieldValue(a.truck_toll()); }},
+    {"min_zoom_level",                 [](const AttributeRecord& a) { return ToFieldValue(a.min_zoom_level()); }},
+    {"administrative_road_context_id", [](const AttributeRecord& a) { return ToFieldValue(a.administrative_road_context_id()); }},
+    // bitmask 只有 enums:raw 时才是标量
+    {"access",                         nullptr, [](const AttributeRecord& a) { return ToFieldValue(a.access()); }},
+    {"road_usage",                     nullptr, [](const AttributeRecord& a) { return ToFieldValue(a.road_usage()); }},
+    {"local_road",                     nullptr, [](const AttributeRecord& a) { return ToFieldValue(a.local_road()); }},
+};
+
+// 输出中为数组/对象的字段，filter 对其永远不成立
+const std::initializer_list<const char*> kOpaqueFields = {
+    "attributes", "start_offset", "access", "road_usage", "local_road", "street_names", "route_numbers"
+};
+
+// ------------------------- 字段投影 -------------------------
+// 下标与 kRoadFieldNames 一一对应；kStartOffset 之后为 attributes 中的字段
 
-    // 如果 PolylineOffset 有 value() 或者 to_string，这里需要调整
-    if (attr.has_start_offset())
+enum RoadField : size_t {
+    kLocalId, kStreetNames, kRouteNumbers,
+    kStartOffset, kAccess, kFunctionalClass, kTravelDirection, kPhysical, kRoadUsage,
+    kUnderConstruction, kZLevel, kStateCode, kHasPolygonalGeometry, kLocalRoad,
+    kTruckToll, kMinZoomLevel, kAdministrativeRoadContextId,
+    kRoadFieldCount
+};
+
+const char* const kRoadFieldNames[kRoadFieldCount] = {
+    "local_id", "street_names", "route_numbers",
+    "start_offset", "access", "functional_class", "travel_direction", "physical", "road_usage",
+    "under_construction", "z_level", "state_code", "has_polygonal_geometry", "local_road",
+    "truck_toll", "min_zoom_level", "administrative_road_context_id",
+};
+
+using RoadFieldSet = std::bitset<kRoadFieldCount>;
+
+RoadFieldSet ResolveFields(const converter::ConvertOptions& options) {
+    if (!options.fields) return RoadFieldSet().set();
+    return options.fields->Resolve(kRoadFieldNames, "attributes", kStartOffset);
+}
+
+// 只计算 fields 中请求的字段；raw 为 true 时枚举和 bitmask 输出整数
+json convert_attribute(const clientmap::decoder::RoadAttributeLayer::Attributes& attr,
+                       const RoadFieldSet& fields, bool raw) {
+    json a = json::object();
+
+    if (fields[kStartOffset] && attr.has_start_offset())
     {
         const auto& polyline_offset = attr.start_offset();
-        uint32_t index = polyline_offset.shape_point_index();
-        uint32_t ratio = polyline_offset.shape_point_ratio();
-            json start_offset_json;
-        start_offset_json["shape_point_index"] = index;
-        start_offset_json["shape_point_ratio"] = ratio;
+        json start_offset_json;
+        start_offset_json["shape_point_index"] = polyline_offset.shape_point_index();
+        start_offset_json["shape_point_ratio"] = polyline_offset.shape_point_ratio();
         a["start_offset"] = start_offset_json;
     }
 
-    //if (attr.has_start_offset()) a["start_offset"] = attr.start_offset().SerializeAsString();
-
-    // travel_direction 可能是枚举
-    a["access"] = bitmaskToJson(attr.access());
-    a["functional_class"] = FunctionalClass_Name(attr.functional_class());
-    a["travel_direction"] = RelativeDirection_Name(attr.travel_direction());
-    a["physical"] = PhisicalBitmaskToString(attr.physical());
-    a["road_usage"] = convert_road_usage_bitmask(attr.road_usage());
-    a["under_construction"] = attr.under_construction();
-    // a["country_code"] = attr.country_code().code(); // 若存在
-    a["z_level"] = attr.z_level();
-    a["state_code"] = attr.state_code();
-    a["has_polygonal_geometry"] = attr.has_polygonal_geometry();
-    a["local_road"] = convert_local_road_bitmask(attr.local_road());
-    // 出于稳定性考虑，如果 originating_road_attributes 是 message，则序列化为 string
-    if (attr.has_originating_road_attributes()) {
-        std::string tmp;
-       // attr.originating_road_attributes().SerializeToString(&tmp);
-       // a["originating_road_attributes"] = tmp;
+    if (raw) {
+        if (fields[kAccess]) a["access"] = attr.access();
+        if (fields[kFunctionalClass]) a["functional_class"] = attr.functional_class();
+        if (fields[kTravelDirection]) a["travel_direction"] = attr.travel_direction();
+        if (fields[kPhysical]) a["physical"] = attr.physical();
+        if (fields[kRoadUsage]) a["road_usage"] = attr.road_usage();
+        if (fields[kLocalRoad]) a["local_road"] = attr.local_road();
+    } else {
+        if (fields[kAccess]) a["access"] = bitmaskToJson(attr.access());
+        if (fields[kFunctionalClass]) a["functional_class"] = converter::FunctionalClassNames().Name(attr.functional_class());
+        if (fields[kTravelDirection]) a["travel_direction"] = converter::RelativeDirectionNames().Name(attr.travel_direction());
+        if (fields[kPhysical]) a["physical"] = PhisicalBitmaskToString(attr.physical());
+        if (fields[kRoadUsage]) a["road_usage"] = convert_road_usage_bitmask(attr.road_usage());
+        if (fields[kLocalRoad]) a["local_road"] = convert_local_road_bitmask(attr.local_road());
     }
-    a["truck_toll"] = attr.truck_toll();
-    a["min_zoom_level"] = attr.min_zoom_level();
-    a["administrative_road_context_id"] = attr.administrative_road_context_id();
+    if (fields[kUnderConstruction]) a["under_construction"] = attr.under_construction();
+    // a["country_code"] = attr.country_code().code(); // 若存在
+    if (fields[kZLevel]) a["z_level"] = attr.z_level();
+    if (fields[kStateCode]) a["state_code"] = attr.state_code();
+    if (fields[kHasPolygonalGeometry]) a["has_polygonal_geometry"] = attr.has_polygonal_geometry();
+    // originating_road_attributes 为 message，暂不输出
+    if (fields[kTruckToll]) a["truck_toll"] = attr.truck_toll();
+    if (fields[kMinZoomLevel]) a["min_zoom_level"] = attr.min_zoom_level();
+    if (fields[kAdministrativeRoadContextId]) a["administrative_road_context_id"] = attr.administrative_road_context_id();
     return a;
 }
 
@@ -242,11 +227,28 @@ json convertInternal(
     const clientmap::decoder::RoadAttributeLayer& road_attr_layer,
     const olp::geo::TileKey& tile_key,
     const std::string& output_path,
-    uint32_t world_coordinate_bits)
+    uint32_t world_coordinate_bits,
+    const converter::ConvertOptions& options)
 {
     // 校验
     validate_layer_sizes(road_layer, road_name_layer, road_geom_layer, road_attr_layer);
 
+    RoadFilterPushdown pushdown(options.filter, kSegmentFields, kAttributeFields, kOpaqueFields, options.raw_enums);
+    if (options.filter && !options.filter->empty() && !pushdown.active()) {
+        OLP_SDK_LOG_INFO_F(kLogTag, "Filter key '%s' can not be pushed down, filter on output instead",
+                           pushdown.unresolved_key().c_str());
+    }
+
+    const RoadFieldSet fields = ResolveFields(options);
+    const bool withAttributes = (fields >> kStartOffset).any();
+
+    // clip: 在解码出的整数坐标上判断，区域外的道路不再构造
+    const utils::TileClipper clipper(options.clip_area, options.clip_mode, tile_key, world_coordinate_bits);
+    std::vector<utils::WorldPoint> linePoints;
+    utils::PolylineEncoder encoder(options.geometry_encoding, world_coordinate_bits, options.coordinate_precision);
+    utils::LineSimplifier simplifier(options.simplify, tile_key, world_coordinate_bits);
+    converter::AttributeCache attributeCache;
+
     OLP_SDK_LOG_INFO(kLogTag, "开始转换 GeoJson...");
 
     json feature_collection;
@@ -262,39 +264,67 @@ json convertInternal(
         const auto& geom_road = road_geom_layer.roads(static_cast<int>(i));
         const auto& attr_road = road_attr_layer.roads(static_cast<int>(i));
 
-        json properties;
-        properties["local_id"] = road_proto.local_id();
+        // 过滤下推：不满足条件的道路不构造 JSON
+        if (!pushdown.Matches(SegmentRecord{static_cast<uint64_t>(road_proto.local_id())}, &attr_road.attributes())) {
+            continue;
+        }
+
+        bool cutGeometry = false;
+        if (clipper.active()) {
+            linePoints.clear();
+            clipper.AppendLine(geom_road.geometry(), linePoints);
+            const utils::ClipResult where = clipper.Classify(linePoints);
+            if (where == utils::ClipResult::kOutside) continue;
+            cutGeometry = (where == utils::ClipResult::kPartial && clipper.mode() == utils::ClipMode::kCut);
+        }
+        std::vector<std::vector<utils::WorldPoint>> pieces;
+        if (cutGeometry) {
+            if (simplifier.active()) simplifier.Simplify(linePoints);
+            pieces = clipper.Cut(linePoints);
+            if (pieces.empty()) continue;   // 只擦过区域边界，没有剩下的片段
+        }
+
+        json properties = json::object();
+        if (fields[kLocalId]) properties["local_id"] = road_proto.local_id();
 
         // 街道名称
-        json street_names = json::array();
-        for (const auto& street_name : name_road.street_names()) {
-            json sn;
-            // 有些生成的类里可能没有 language()/full_name()，按实际调整
-            sn["language"]  = street_name.language();
-            sn["full_name"] = street_name.full_name();
-            // 可以添加 splitting 信息等
-            street_names.push_back(sn);
+        if (fields[kStreetNames]) {
+            json street_names = json::array();
+            for (const auto& street_name : name_road.street_names()) {
+                json sn;
+                // 有些生成的类里可能没有 language()/full_name()，按实际调整
+                sn["language"]  = street_name.language();
+                sn["full_name"] = street_name.full_name();
+                // 可以添加 splitting 信息等
+                street_names.push_back(sn);
+            }
+            properties["street_names"] = street_names;
         }
-        properties["street_names"] = street_names;
 
         // 路线编号
-        json route_numbers = json::array();
-        for (const auto& route_num : name_road.route_numbers()) {
-            json rn;
-            rn["language"] = route_num.language();
-            rn["number"] = route_num.number();
-           // if (route_num.has_shield_text()) rn["shield_text"] = route_num.shield_text();
-            // 如果需要级别转字符串，可在此处添加
-            //route_numbers.push_back(rn);
+        if (fields[kRouteNumbers]) {
+            json route_numbers = json::array();
+            for (const auto& route_num : name_road.route_numbers()) {
+                json rn;
+                rn["language"] = route_num.language();
+                rn["number"] = route_num.number();
+               // if (route_num.has_shield_text()) rn["shield_text"] = route_num.shield_text();
+                // 如果需要级别转字符串，可在此处添加
+                //route_numbers.push_back(rn);
+            }
+            properties["route_numbers"] = route_numbers;
         }
-        properties["route_numbers"] = route_numbers;
 
         // 道路属性
-        json attributes = json::array();
-        for (const auto& attr : attr_road.attributes()) {
-            attributes.push_back(convert_attribute(attr));
+        if (withAttributes) {
+            json attributes = json::array();
+            for (const auto& attr : attr_road.attributes()) {
+                attributes.push_back(attributeCache.Get(attr, [&](const AttributeRecord& record) {
+                    return convert_attribute(record, fields, options.raw_enums);
+                }));
+            }
+            properties["attributes"] = attributes;
         }
-        properties["attributes"] = attributes;
 
         // 构建 Feature
         json feature;
@@ -302,7 +332,13 @@ json convertInternal(
 
         // geometry: 使用 geom_road.geometry()
         // 这里假设 geom_road.geometry() 返回 com::here::platform::schema::clientmap::v1::layers::common::LineString
-        feature["geometry"] = extract_geometry(geom_road.geometry(), tile_key, world_coordinate_bits);
+        if (cutGeometry) {
+            feature["geometry"] = encoder.active() ? encoder.ToGeometry(pieces)
+                                                   : clipper.ToGeometry(pieces, options.coordinate_precision);
+        } else {
+            feature["geometry"] = extract_geometry(geom_road.geometry(), tile_key, world_coordinate_bits,
+                                                   options.coordinate_precision, encoder, simplifier);
+        }
         feature["properties"] = properties;
 
         feature_collection["features"].push_back(feature);
@@ -313,7 +349,16 @@ json convertInternal(
 
 }
 
-json RoadDataToGeoJsonConverter::convert(const datastore::Response< datastore::TileLoadResult >& response, const olp::geo::TileKey &tile_key, const std::string& outPath)
+// convert() 和 stream() 共用的图层查找
+struct RoadLayers {
+    const clientmap::decoder::RoadLayer* roads = nullptr;
+    const clientmap::decoder::RoadAttributeLayer* attributes = nullptr;
+    const clientmap::decoder::RoadGeometryLayer* geometries = nullptr;
+    const clientmap::decoder::RoadNameLayer* names = nullptr;
+    uint32_t world_bits = 0;
+};
+
+RoadLayers FindRoadLayers(const datastore::Response< datastore::TileLoadResult >& response)
 {
     const auto& layer_results = response.GetResult().GetLayersResults();
 
@@ -334,20 +379,216 @@ json RoadDataToGeoJsonConverter::convert(const datastore::Response< datastore::T
     const datastore::LayerLoadResult &road_name_layer_result = find_layer_result(clientmap::rendering::kRoadNameLayerName);
 
     // 将 LayerLoadResult 转换为 decoder 类型指针
-    const clientmap::decoder::RoadLayer* road_layer_data = road_layer_result.Cast<clientmap::decoder::RoadLayer>();
-    const clientmap::decoder::RoadAttributeLayer* road_attribute_layer_data = road_attribute_layer_result.Cast<clientmap::decoder::RoadAttributeLayer>();
-    const clientmap::decoder::RoadGeometryLayer* road_geometry_layer_data = road_geometry_layer_result.Cast<clientmap::decoder::RoadGeometryLayer>();
-    const clientmap::decoder::RoadNameLayer* road_name_layer_data = road_name_layer_result.Cast<clientmap::decoder::RoadNameLayer>();
+    RoadLayers layers;
+    layers.roads = road_layer_result.Cast<clientmap::decoder::RoadLayer>();
+    layers.attributes = road_attribute_layer_result.Cast<clientmap::decoder::RoadAttributeLayer>();
+    layers.geometries = road_geometry_layer_result.Cast<clientmap::decoder::RoadGeometryLayer>();
+    layers.names = road_name_layer_result.Cast<clientmap::decoder::RoadNameLayer>();
 
-    if (!road_layer_data || !road_attribute_layer_data || !road_geometry_layer_data || !road_name_layer_data) {
+    if (!layers.roads || !layers.attributes || !layers.geometries || !layers.names) {
         throw std::runtime_error("Failed to cast one or more layer data pointers.");
     }
 
-    uint32_t world_coordinate_bits = GetWorldCoordinateBits(road_geometry_layer_result);
+    layers.world_bits = GetWorldCoordinateBits(road_geometry_layer_result);
+    return layers;
+}
+
+json RoadDataToGeoJsonConverter::convert(const datastore::Response< datastore::TileLoadResult >& response, const olp::geo::TileKey &tile_key, const std::string& outPath,
+    const converter::ConvertOptions& options)
+{
+    const RoadLayers layers = FindRoadLayers(response);
 
     // 调用内部转换
-    return convertInternal(*road_layer_data, *road_name_layer_data, *road_geometry_layer_data, *road_attribute_layer_data, 
-        tile_key, outPath, world_coordinate_bits);
+    return convertInternal(*layers.roads, *layers.names, *layers.geometries, *layers.attributes,
+        tile_key, outPath, layers.world_bits, options);
+}
+
+// ------------------------- 流式输出 -------------------------
+// 与 convert_attribute / convertInternal 生成的 JSON 逐字节一致：
+// nlohmann::json 的对象按键名排序输出，所以这里所有的键都按字典序写入。
+
+using converter::JsonWriter;
+
+namespace keys = converter::attribute_keys;
+
+// 枚举：raw 时为整数，否则为名称
+void write_enum(JsonWriter& w, const converter::JsonKey& key, int value, bool raw,
+                const converter::EnumNameTable& names) {
+    w.Key(key);
+    if (raw) w.Value(value);
+    else names.Write(w, value);
+}
+
+// bitmask：raw 时为整数，否则为名称数组
+void write_flags(JsonWriter& w, const converter::JsonKey& key, uint32_t mask, bool raw,
+                 const converter::FlagNameTable& names) {
+    w.Key(key);
+    if (raw) w.Value(mask);
+    else names.Write(w, mask);
+}
+
+void write_attribute(JsonWriter& w, const AttributeRecord& attr, const RoadFieldSet& fields, bool raw) {
+    w.BeginObject();
+    if (fields[kAccess]) write_flags(w, keys::kAccess, attr.access(), raw, converter::AccessFlagNames());
+    if (fields[kAdministrativeRoadContextId]) w.Field(keys::kAdministrativeRoadContextId, attr.administrative_road_context_id());
+    if (fields[kFunctionalClass]) write_enum(w, keys::kFunctionalClass, attr.functional_class(), raw, converter::FunctionalClassNames());
+    if (fields[kHasPolygonalGeometry]) w.Field(keys::kHasPolygonalGeometry, attr.has_polygonal_geometry());
+    if (fields[kLocalRoad]) write_flags(w, keys::kLocalRoad, attr.local_road(), raw, converter::LocalRoadFlagNames());
+    if (fields[kMinZoomLevel]) w.Field(keys::kMinZoomLevel, attr.min_zoom_level());
+    if (fields[kPhysical]) {
+        if (raw) w.Field(keys::kPhysical, attr.physical());
+        else w.Field(keys::kPhysical, PhisicalBitmaskToString(attr.physical()));
+    }
+    if (fields[kRoadUsage]) write_flags(w, keys::kRoadUsage, attr.road_usage(), raw, converter::RoadUsageFlagNames());
+    if (fields[kStartOffset] && attr.has_start_offset()) {
+        const auto& polyline_offset = attr.start_offset();
+        w.Key(keys::kStartOffset);
+        w.BeginObject();
+        w.Field(keys::kShapePointIndex, polyline_offset.shape_point_index());
+        w.Field(keys::kShapePointRatio, polyline_offset.shape_point_ratio());
+        w.EndObject();
+    }
+    if (fields[kStateCode]) w.Field(keys::kStateCode, attr.state_code());
+    if (fields[kTravelDirection]) write_enum(w, keys::kTravelDirection, attr.travel_direction(), raw, converter::RelativeDirectionNames());
+    if (fields[kTruckToll]) w.Field(keys::kTruckToll, attr.truck_toll());
+    if (fields[kUnderConstruction]) w.Field(keys::kUnderConstruction, attr.under_construction());
+    if (fields[kZLevel]) w.Field(keys::kZLevel, attr.z_level());
+    w.EndObject();
+}
+
+// 与 extract_geometry 相同（包括固定的 level 14）
+void write_geometry(JsonWriter& w,
+                    const utils::LineString& line_string,
+                    const olp::geo::TileKey& kTileKey,
+                    uint32_t world_coordinate_bits,
+                    int precision,
+                    utils::CoordinateBuffer& buffer,
+                    utils::PolylineEncoder& encoder,
+                    utils::LineSimplifier& simplifier)
+{
+    const utils::CoordinateDecoder decoder(kTileKey, world_coordinate_bits, utils::kRenderingGeometryLevel);
+    const auto points = simplifier.Points(line_string);
+    if (encoder.active()) {
+        encoder.Clear();
+        encoder.AddLine(points.first, points.second, decoder);
+        encoder.WriteGeometry(w);
+        return;
+    }
+
+    w.BeginObject();
+    w.Key("coordinates");
+    w.BeginArray();
+    utils::WriteCoordinates(w, decoder, points.first, points.second, precision, buffer);
+    w.EndArray();
+    w.Field("type", "LineString");
+    w.EndObject();
+}
+
+bool RoadDataToGeoJsonConverter::stream(const datastore::Response< datastore::TileLoadResult >& response, const olp::geo::TileKey &tile_key,
+    const converter::ConvertOptions& options, converter::FeatureCollectionWriter& out)
+{
+    const RoadLayers layers = FindRoadLayers(response);
+    validate_layer_sizes(*layers.roads, *layers.names, *layers.geometries, *layers.attributes);
+
+    RoadFilterPushdown pushdown(options.filter, kSegmentFields, kAttributeFields, kOpaqueFields, options.raw_enums);
+    if (options.filter && !options.filter->empty() && !pushdown.active()) {
+        return false;   // 由调用方改走 convert() + 输出端过滤
+    }
+
+    const RoadFieldSet fields = ResolveFields(options);
+    const bool withAttributes = (fields >> kStartOffset).any();
+    const bool raw = options.raw_enums;
+
+    const utils::TileClipper clipper(options.clip_area, options.clip_mode, tile_key, layers.world_bits);
+    // attributes 缓存的条目从当前线程的 arena 分配，本瓦片结束时整体回收
+    ocm::TileArena::Scope arenaScope;
+    std::vector<utils::WorldPoint> linePoints;
+    utils::CoordinateBuffer coordBuffer;
+    utils::PolylineEncoder encoder(options.geometry_encoding, layers.world_bits, options.coordinate_precision);
+    utils::LineSimplifier simplifier(options.simplify, tile_key, layers.world_bits);
+    converter::AttributeCache attributeCache;
+    auto writeAttribute = [&](JsonWriter& w, const AttributeRecord& attr) { write_attribute(w, attr, fields, raw); };
+
+    const int num_roads = layers.roads->roads_size();
+    for (int i = 0; i < num_roads; ++i) {
+        const auto& road_proto = layers.roads->roads(i);
+        const auto& name_road = layers.names->roads(i);
+        const auto& geom_road = layers.geometries->roads(i);
+        const auto& attr_road = layers.attributes->roads(i);
+
+        if (!pushdown.Matches(SegmentRecord{static_cast<uint64_t>(road_proto.local_id())}, &attr_road.attributes())) {
+            continue;
+        }
+
+        bool cutGeometry = false;
+        if (clipper.active()) {
+            linePoints.clear();
+            clipper.AppendLine(geom_road.geometry(), linePoints);
+            const utils::ClipResult where = clipper.Classify(linePoints);
+            if (where == utils::ClipResult::kOutside) continue;
+            cutGeometry = (where == utils::ClipResult::kPartial && clipper.mode() == utils::ClipMode::kCut);
+        }
+        std::vector<std::vector<utils::WorldPoint>> pieces;
+        if (cutGeometry) {
+            if (simplifier.active()) simplifier.Simplify(linePoints);
+            pieces = clipper.Cut(linePoints);
+            if (pieces.empty()) continue;   // 只擦过区域边界，没有剩下的片段
+        }
+
+        JsonWriter& w = out.BeginFeature();
+        w.BeginObject();
+
+        w.Key("geometry");
+        if (!cutGeometry) {
+            write_geometry(w, geom_road.geometry(), tile_key, layers.world_bits, options.coordinate_precision, coordBuffer, encoder, simplifier);
+        } else if (encoder.active()) {
+            encoder.WriteGeometry(w, pieces);
+        } else {
+            w.Value(clipper.ToGeometry(pieces, options.coordinate_precision));
+        }
+
+        w.Key("properties");
+        w.BeginObject();
+        if (withAttributes && options.attribute_dictionary) {
+            w.Key("attribute_refs");
+            w.BeginArray();
+            for (const auto& attr : attr_road.attributes()) {
+                w.Uint(options.attribute_dictionary->Index(attr, writeAttribute));
+            }
+            w.EndArray();
+        } else if (withAttributes) {
+            w.Key("attributes");
+            w.BeginArray();
+            for (const auto& attr : attr_road.attributes()) {
+                attributeCache.Write(w, attr, writeAttribute);
+            }
+            w.EndArray();
+        }
+        if (fields[kLocalId]) w.Field("local_id", road_proto.local_id());
+        if (fields[kRouteNumbers]) {
+            // 与 convertInternal 一致，路线编号暂不输出
+            w.Key("route_numbers");
+            w.BeginArray();
+            w.EndArray();
+        }
+        if (fields[kStreetNames]) {
+            w.Key("street_names");
+            w.BeginArray();
+            for (const auto& street_name : name_road.street_names()) {
+                w.BeginObject();
+                w.Field("full_name", street_name.full_name());
+                w.Field("language", street_name.language());
+                w.EndObject();
+            }
+            w.EndArray();
+        }
+        w.EndObject();
+
+        w.Field("type", "Feature");
+        w.EndObject();
+        out.EndFeature();
+    }
+    return true;
 }
 
 
@@ -7,6 +7,7 @@
 #include <sstream>
 #include <LayerFinder.hpp>
 #include "GeometryUtils.hpp" 
+#include "AttributeTables.hpp"
 #include "here-devel/com/here/platform/schema/clientmap/v1/layers/SegmentAttributeLayer.pb.h"
 #include "here-devel/com/here/platform/schema/clientmap/v1/layers/common/AccessBitMask.pb.h"
 #include "here-devel/com/here/platform/schema/clientmap/v1/layers/common/SpecialSpeedSituation.pb.h"
@@ -20,7 +21,6 @@
 #include "here-devel/com/here/platform/schema/clientmap/v1/layers/common/SpecialTrafficAreaCategory.pb.h"
 #include "here-devel/com/here/platform/schema/clientmap/v1/layers/common/RoadUsageBitMask.pb.h"
 #include "here-devel/com/here/platform/schema/clientmap/v1/layers/common/TimeDomainDescription.pb.h"
-#include <unordered_map>
 
  #include <boost/algorithm/string/join.hpp>
 
@@ -34,34 +34,6 @@ using json = nlohmann::json;
 using namespace com::here::platform::schema::clientmap::v1::layers::common;
 
 
-struct CoordHash {
-    std::size_t operator()(uint64_t key) const {
-        return std::hash<uint64_t>()(key);
-    }
-};
-
-using CoordKey = uint64_t;
-
-CoordKey makeCoordKey(uint32_t x, uint32_t y) {
-    return (static_cast<uint64_t>(x) << 32) | y;
-}
-
-std::unordered_map<CoordKey, const layers::NodeLayer::Node*> buildNodeMap(
-    const layers::NodeLayer& layer)
-{
-    std::unordered_map<CoordKey, const layers::NodeLayer::Node*> nodeMap;
-    for (const auto& node : layer.nodes()) {
-        CoordKey key = makeCoordKey(node.x(), node.y());
-        nodeMap[key] = &node;
-        /*
-                std::cout << "Node key: " << key 
-                  << " (x=" << node.x() << ", y=" << node.y() << ")"
-                  << " ptr=" << &node << std::endl;
-                  */
-    }
-    return nodeMap;
-}
-
 const layers::NodeLayer::Segment* getSegmentByIndex(const layers::NodeLayer& layer, size_t index) {
     if (index < layer.segments_size()) {
         return &layer.segments(index);
@@ -69,100 +41,22 @@ const layers::NodeLayer::Segment* getSegmentByIndex(const layers::NodeLayer& lay
     return nullptr;
 }
 
-static constexpr uint32_t LOCAL_ROAD_EMPTY      = 0;
-static constexpr uint32_t FRONTAGE              = 1u << 0; // 1
-static constexpr uint32_t PARKING_LOT_ROAD      = 1u << 1; // 2
-static constexpr uint32_t POI_ACCESS            = 1u << 2; // 4
-
-
-// bitmask -> json
+// bitmask -> json（名称表见 AttributeTables.hpp）
 inline json LocalRoadBitmaskToJson(uint32_t mask) {
-    json j;
-    j["raw"] = mask;
-
-    // active names 数组（便于人读）
-    json active = json::array();
-    if (mask & FRONTAGE) active.push_back("FRONTAGE");
-    if (mask & PARKING_LOT_ROAD) active.push_back("PARKING_LOT_ROAD");
-    if (mask & POI_ACCESS) active.push_back("POI_ACCESS");
-    j["active"] = active;
-
-    // 是否为空（所有位都为 0）
-    j["is_empty"] = (mask == LOCAL_ROAD_EMPTY);
-
-    return j;
+    return converter::LocalRoadFlagNames().ObjectJson(mask);
 }
 
 inline json RoadUsageBitMaskToJson(uint32_t mask) {
-    static const struct { uint32_t bit; const char* name; } kFlags[] = {
-        {1,   "CARPOOL_ROAD"},
-        {2,   "CONTROLLED_ACCESS"},
-        {4,   "EXPRESS_LANE"},
-        {8,   "LIMITED_ACCESS"},
-        {16,  "PRIORITY_ROAD"},
-        {32,  "RAMP"},
-        {64,  "REVERSIBLE"},
-        {128, "TOLLWAY"},
-        {256, "DIMINISHED_PRIORITY"},
-        {512, "PUBLIC_ACCESS"}
-    };
-
-    json j;
-    j["raw"] = mask;
-   // j["flags"] = json::object();
-    json active = json::array();
-
-    for (const auto& f : kFlags) {
-        bool set = (mask & f.bit) != 0;
-       // j["flags"][f.name] = set;
-        if (set) active.push_back(f.name);
-    }
-
-    j["active"] = active;
-    j["is_empty"] = (mask == 0);
-    return j;
+    return converter::RoadUsageFlagNames().ObjectJson(mask);
 }
 
-
 inline json PhysicalBitMaskToJson(uint32_t mask) {
-    static const struct { uint32_t bit; const char* name; } kFlags[] = {
-        {1,  "BOAT_FERRY"},
-        {2,  "BRIDGE"},
-        {4,  "MULTIPLY_DIGITIZED"},
-        {8,  "PAVED"},
-        {16, "PRIVATE"},
-        {32, "RAIL_FERRY"},
-        {64, "TUNNEL"},
-        {128,"DELIVERY_ROAD"},
-        {256,"MOVABLE_BRIDGE"}
-    };
-
-    json j;
-    j["raw"] = mask;
-   // j["flags"] = json::object();
-    json active = json::array();
-
-    for (const auto& f : kFlags) {
-        bool set = (mask & f.bit) != 0;
-       // j["flags"][f.name] = set;
-        if (set) active.push_back(f.name);
-    }
-
-    j["active"] = active;
-    j["is_empty"] = (mask == 0);
-    return j;
+    return converter::PhysicalFlagNames().ObjectJson(mask);
 }
 
 // 小工具：bitmask 转数组
-json bitmaskToJson(uint32_t mask) {
-    json arr = json::array();
-    if (mask & AccessBitMask::AUTOMOBILES) arr.push_back("AUTOMOBILES");
-    if (mask & AccessBitMask::BUSES) arr.push_back("BUSES");
-    if (mask & AccessBitMask::TRUCKS) arr.push_back("TRUCKS");
-    if (mask & AccessBitMask::PEDESTRIANS) arr.push_back("PEDESTRIANS");
-    if (mask & AccessBitMask::MOTORCYCLES) arr.push_back("MOTORCYCLES");
-    // ... 其他 bitmask
-    return arr;
+const json& bitmaskToJson(uint32_t mask) {
+    return converter::AccessFlagNames().Json(mask);
 }
 
 // 转换 TimedAccess
@@ -188,14 +82,14 @@ json convert_timed_access(const TimedAccess& t) {
 // 转换 SpecialSpeedSituation
 json convert_special_speed(const SpecialSpeedSituation& s) {
     json j;
-    j["special_speed_type"] = SpecialSpeedSituation::SpecialSpeedType_Name(s.special_speed_type());
+    j["special_speed_type"] = converter::SpecialSpeedTypeNames().Name(s.special_speed_type());
     j["special_speed_limit"] = s.special_speed_limit();
     j["applies_during"] = s.applies_during();
     const auto& periods = s.applies_during();
     /* Human readable TimeDomain (If needed, remove comment)
     json active = json::array();
     for (const auto& p : periods) {
-        active.push_back(TimeDomainParser::Parser::TimeDomainToReadable(p));
+        active.push_back(TimeDomainParser::TimeDomainToReadable(p));
     }
 
     j["applies_during_readable"] = active;
@@ -223,57 +117,18 @@ constexpr auto kLogTag = "RoutingDataToGeoJsonConverter";
 // 辅助函数：将枚举转换为字符串
 
 inline json SpeedLimitRainingBitMaskToJson(uint32_t mask) {
-    // ⚠️ 这里要根据 proto 实际枚举值补全
-    static const struct { uint32_t bit; const char* name; } kFlags[] = {
-        {1, "MAX_SPEED_RAINING_EMPTY"},
-        {2, "MOTORWAYS_AND_CONTROLLED_ACCESS_ROADS_LIMIT_110_KMH"}
-        // ... 继续补充其它枚举值
-    };
-
-    json j;
-    j["raw"] = mask;
-   // j["flags"] = json::object();
-    json active = json::array();
-
-    for (const auto& f : kFlags) {
-        bool set = (mask & f.bit) != 0;
-     //   j["flags"][f.name] = set;
-        if (set) active.push_back(f.name);
-    }
-
-    j["active"] = active;
-    j["is_empty"] = (mask == 0);
-    return j;
+    return converter::SpeedLimitRainingFlagNames().ObjectJson(mask);
 }
 
 // 对应 proto 中的 ParkingSideBitMask
-
 inline json ParkingSideBitMaskToJson(uint32_t mask) {
-    static const struct { uint32_t bit; const char* name; } kFlags[] = {
-        {1, "BOTH_SIDES_ONE_WAY_ROAD"},
-        {2, "OPPOSITE_LANE_TWO_WAY_ROAD"}
-    };
-
-    json j;
-    j["raw"] = mask;
-    //j["flags"] = json::object();
-    json active = json::array();
-
-    for (const auto& f : kFlags) {
-        bool set = (mask & f.bit) != 0;
-      //  j["flags"][f.name] = set;
-        if (set) active.push_back(f.name);
-    }
-
-    j["active"] = active;
-    j["is_empty"] = (mask == 0);
-    return j;
+    return converter::ParkingSideFlagNames().ObjectJson(mask);
 }
 
 json convert_usage_fee(const UsageFeeRequired& u) {
     json j;
-    j["toll_feature_type"] = UsageFeeRequired::TollFeatureType_Name(u.toll_feature_type());
-    j["relative_direction"] = RelativeDirection_Name(u.relative_direction());
+    j["toll_feature_type"] = converter::TollFeatureTypeNames().Name(u.toll_feature_type());
+    j["relative_direction"] = converter::RelativeDirectionNames().Name(u.relative_direction());
     j["applies_to"] = bitmaskToJson(u.applies_to());
 
     // 时间限制（可能为空）
@@ -350,15 +205,15 @@ json convert_attribute(const clientmap::decoder::SegmentAttributeLayer::Attribut
 */
 
     // 枚举字段
-    a["functional_class"] = FunctionalClass_Name(attr.functional_class());
+    a["functional_class"] = converter::FunctionalClassNames().Name(attr.functional_class());
 
     /*
-    a["travel_direction"] = RelativeDirection_Name(attr.travel_direction());
-    a["speed_category"] = SpeedCategory_Name(attr.speed_category());
-    a["intersection_category"] = IntersectionCategory_Name(attr.intersection_category());
-    a["road_divider"] = RoadDivider_Name(attr.road_divider());
+    a["travel_direction"] = converter::RelativeDirectionNames().Name(attr.travel_direction());
+    a["speed_category"] = converter::SpeedCategoryNames().Name(attr.speed_category());
+    a["intersection_category"] = converter::IntersectionCategoryNames().Name(attr.intersection_category());
+    a["road_divider"] = converter::RoadDividerNames().Name(attr.road_divider());
     //a["route_level"] = RouteLevel_Name(attr.route_levels());
-    a["special_traffic_area_category"] = SpecialTrafficAreaCategory_Name(attr.special_traffic_area_category());
+    a["special_traffic_area_category"] = converter::SpecialTrafficAreaCategoryNames().Name(attr.special_traffic_area_category());
 
     // repeated TimedAccess
     json forwardArr = json::array();
@@ -441,6 +296,8 @@ json convertInternal(
     feature_collection["features"] = json::array();
 
 
+    const uint64_t tileID = TileIDConverter::XYtoTileId(tile_key.Column(), tile_key.Row(), tile_key.Level());
+
     int m = segIdMapLayer.segments_size();
 
     int n = segLayer.segments_size();
@@ -453,7 +310,6 @@ json convertInternal(
         const auto& hmcIdSeg =  segIdMapLayer.segments(i);
 
         // === properties ===
-        const auto& tileID = TileIDConverter::XYtoTileId(tile_key.Column(), tile_key.Row(), tile_key.Level());
         json properties;
         properties["tile_id"] = tileID;
         properties["local_id"] = seg.local_id();
@@ -486,4 +342,54 @@ json convertInternal(
 
 
 
+// ------------------------- 流式输出 -------------------------
+// 与 convertInternal 的输出逐字节一致，键按字典序写入（nlohmann::json 对象按键名排序）
+
+bool RoutingDataToGeoJsonConverter::stream(const datastore::Response< datastore::TileLoadResult >& response, const olp::geo::TileKey &tile_key,
+    converter::FeatureCollectionWriter& out)
+{
+    const auto& layer_results = response.GetResult().GetLayersResults();
+
+    ocm::LayerFinder finder(layer_results);
+
+    const auto& segLayer = finder.GetRequiredLayer<clientmap::decoder::SegmentLayer>(clientmap::routing::kSegmentLayerName);
+    const auto* attrLayer = finder.TryGetLayer<clientmap::decoder::SegmentAttributeLayer>(clientmap::routing::kSegmentAttributeLayerName);
+    const auto* segIdMapLayer = finder.TryGetLayer<clientmap::decoder::SegmentIdMappingLayer>(clientmap::interop::kSegmentIdMappingLayerName);
+
+    const uint64_t tileID = TileIDConverter::XYtoTileId(tile_key.Column(), tile_key.Row(), tile_key.Level());
+
+    const int n = segLayer.segments_size();
+    for (int i = 0; i < n; ++i) {
+        const auto& seg = segLayer.segments(i);
+        const auto& attr = attrLayer->segments(i);
+        const auto& hmcIdSeg = segIdMapLayer->segments(i);
+
+        converter::JsonWriter& w = out.BeginFeature();
+        w.BeginObject();
+        w.Key("properties");
+        w.BeginObject();
+        w.Key("attributes");
+        w.BeginArray();
+        for (const auto& a : attr.attributes()) {
+            w.BeginObject();
+            w.Key(converter::attribute_keys::kFunctionalClass);
+            converter::FunctionalClassNames().Write(w, a.functional_class());
+            w.Field(converter::attribute_keys::kStartOffset, a.start_offset());
+            w.EndObject();
+        }
+        w.EndArray();
+        w.Field("hmc_id", hmcIdSeg.hmc_id());
+        w.Field("host_tile_id", seg.host_tile_id());
+        w.Field("length", seg.meter_length());
+        w.Field("local_id", seg.local_id());
+        w.Field("tile_id", tileID);
+        w.EndObject();
+        w.Field("type", "Feature");
+        w.EndObject();
+        out.EndFeature();
+    }
+    return true;
+}
+
+
 } // namespace road_converter
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "SegmentDedup.hpp"
+#include "SegmentKeyHash.hpp"
+
+namespace converter {
+
+SegmentDedup::SegmentDedup(const std::vector<uint64_t>& tile_ids, int indent)
+    : indent_(indent),
+      tiles_(tile_ids.begin(), tile_ids.end())
+{
+}
+
+size_t SegmentDedup::KeyHash::operator()(const Key& key) const {
+    return HashSegmentKey(key.host_tile_id, key.local_id);
+}
+
+SegmentDedup::ForeignCopy SegmentDedup::CheckForeign(uint64_t host_tile_id, uint64_t local_id) {
+    if (committed_.count(host_tile_id) == 0) {
+        const Key key{host_tile_id, local_id};
+        // 分片用哈希的高位，分片内的 unordered_set 用低位
+        Shard& shard = shards_[KeyHash()(key) >> (sizeof(size_t) * 8 - kShardBits)];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.keys.count(key) == 0 && shard.staged.insert(key).second) {
+            return tiles_.count(host_tile_id) != 0 ? ForeignCopy::kDefer : ForeignCopy::kWrite;
+        }
+    }
+    skipped_.fetch_add(1, std::memory_order_relaxed);
+    return ForeignCopy::kSkip;
+}
+
+void SegmentDedup::Defer(uint64_t host_tile_id, uint64_t local_id, FeatureChunk&& chunk) {
+    if (chunk.feature_count() == 0) return;
+    std::lock_guard<std::mutex> lock(deferred_mutex_);
+    staged_deferred_.emplace_back(Key{host_tile_id, local_id}, std::move(chunk));
+}
+
+void SegmentDedup::CommitTile(uint64_t tile_id) {
+    for (Shard& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.keys.insert(shard.staged.begin(), shard.staged.end());
+        shard.staged.clear();
+    }
+
+    std::lock_guard<std::mutex> lock(deferred_mutex_);
+    for (auto& entry : staged_deferred_) {
+        deferred_.emplace(entry.first, std::move(entry.second));
+    }
+    staged_deferred_.clear();
+
+    // 该瓦片作为 host 已输出自己的 segment，暂存的副本不再需要
+    committed_.insert(tile_id);
+    auto it = deferred_.lower_bound(Key{tile_id, 0});
+    while (it != deferred_.end() && it->first.host_tile_id == tile_id) {
+        it = deferred_.erase(it);
+        skipped_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void SegmentDedup::RollbackTile() {
+    for (Shard& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.staged.clear();
+    }
+    std::lock_guard<std::mutex> lock(deferred_mutex_);
+    staged_deferred_.clear();
+}
+
+void SegmentDedup::Close(FeatureCollectionWriter& out) {
+    std::lock_guard<std::mutex> lock(deferred_mutex_);
+    for (const auto& entry : deferred_) {
+        out.AppendChunk(entry.second);
+        ++recovered_;
+    }
+    deferred_.clear();
+}
+
+} // namespace converter
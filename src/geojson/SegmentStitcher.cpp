@@ -0,0 +1,342 @@
+#include "SegmentStitcher.hpp"
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <utility>
+#include "CoordinateDecoder.hpp"
+#include "SegmentKeyHash.hpp"
+#include "TileIDConverter.hpp"
+
+namespace converter {
+
+using utils::WorldPoint;
+
+namespace {
+
+bool Near(const WorldPoint& a, const WorldPoint& b) {
+    return std::abs(a.x - b.x) <= SegmentStitcher::kSnapUnits && std::abs(a.y - b.y) <= SegmentStitcher::kSnapUnits;
+}
+
+// properties 的来源优先级：host 瓦片中的片段（带 attributes）优先，其次 tile_id 小的
+std::pair<bool, uint64_t> PropertiesRank(uint64_t tile_id, uint64_t host_tile_id) {
+    return {tile_id != host_tile_id, tile_id};
+}
+
+} // namespace
+
+SegmentStitcher::SegmentStitcher(const std::vector<olp::geo::TileKey>& tiles, int precision,
+                                 utils::GeometryEncoding encoding, int indent)
+    : precision_(precision),
+      encoding_(encoding),
+      indent_(indent)
+{
+    if (!tiles.empty()) level_ = tiles.front().Level();
+    for (const auto& key : tiles) {
+        tiles_.insert(TileIDConverter::XYtoTileId(key.Column(), key.Row(), key.Level()));
+    }
+    pending_ = tiles_;
+}
+
+size_t SegmentStitcher::KeyHash::operator()(const SegmentKey& key) const {
+    return HashSegmentKey(key.host_tile_id, key.local_id);
+}
+
+size_t SegmentStitcher::KeyHash::operator()(const EndpointKey& key) const {
+    uint64_t h = (*this)(key.segment);
+    h ^= static_cast<uint64_t>(key.qx) * 0x9E3779B97F4A7C15ull;
+    h = (h ^ (h >> 29)) * 0xBF58476D1CE4E5B9ull;
+    h ^= static_cast<uint64_t>(key.qy) * 0x94D049BB133111EBull;
+    return static_cast<size_t>(h ^ (h >> 32));
+}
+
+void SegmentStitcher::Add(Fragment&& fragment) {
+    if (fragment.points.size() < 2) return;
+    std::lock_guard<std::mutex> lock(staged_mutex_);
+    staged_.push_back(std::move(fragment));
+}
+
+void SegmentStitcher::DiscardTile() {
+    std::lock_guard<std::mutex> lock(staged_mutex_);
+    staged_.clear();
+}
+
+void SegmentStitcher::FinishTile(const olp::geo::TileKey& tile, FeatureCollectionWriter& out) {
+    const uint64_t tile_id = TileIDConverter::XYtoTileId(tile.Column(), tile.Row(), tile.Level());
+    pending_.erase(tile_id);
+
+    std::vector<Fragment> staged;
+    {
+        std::lock_guard<std::mutex> lock(staged_mutex_);
+        staged.swap(staged_);
+    }
+    // 并行转换时片段的到达顺序不固定，排序后合并，输出与单线程相同
+    std::sort(staged.begin(), staged.end(), [](const Fragment& a, const Fragment& b) {
+        return std::tie(a.host_tile_id, a.local_id, a.tile_id, a.points.front().x, a.points.front().y) <
+               std::tie(b.host_tile_id, b.local_id, b.tile_id, b.points.front().x, b.points.front().y);
+    });
+
+    std::vector<size_t> candidates;
+    for (auto& fragment : staged) {
+        ++fragments_;
+        Merge(fragment, candidates);
+    }
+    const auto waiting = waiting_.find(tile_id);
+    if (waiting != waiting_.end()) {
+        candidates.insert(candidates.end(), waiting->second.begin(), waiting->second.end());
+        waiting_.erase(waiting);
+    }
+
+    // 合并后已不存在的折线跳过；按 segment 排序，输出顺序确定
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                    [this](size_t id) { return chains_.count(id) == 0; }),
+                     candidates.end());
+    std::sort(candidates.begin(), candidates.end(), [this](size_t a, size_t b) {
+        const Chain& ca = chains_.at(a);
+        const Chain& cb = chains_.at(b);
+        if (!(ca.key == cb.key)) return ca.key < cb.key;
+        return a < b;
+    });
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    std::vector<uint64_t> blockers;
+    for (const size_t id : candidates) {
+        const Chain& chain = chains_.at(id);
+        Blockers(chain, blockers);
+        if (!blockers.empty()) {
+            for (const uint64_t blocker : blockers) waiting_[blocker].push_back(id);
+            continue;
+        }
+        Write(chain, out);
+        Unindex(id);
+        chains_.erase(id);
+    }
+}
+
+void SegmentStitcher::Close(FeatureCollectionWriter& out) {
+    DiscardTile();
+    std::vector<size_t> ids;
+    ids.reserve(chains_.size());
+    for (const auto& entry : chains_) ids.push_back(entry.first);
+    std::sort(ids.begin(), ids.end(), [this](size_t a, size_t b) {
+        const Chain& ca = chains_.at(a);
+        const Chain& cb = chains_.at(b);
+        if (!(ca.key == cb.key)) return ca.key < cb.key;
+        return a < b;
+    });
+    for (const size_t id : ids) Write(chains_.at(id), out);
+    chains_.clear();
+    starts_.clear();
+    ends_.clear();
+    waiting_.clear();
+}
+
+void SegmentStitcher::TakeProperties(Chain& chain, Fragment& fragment) {
+    if (chain.properties.empty() ||
+        PropertiesRank(fragment.tile_id, chain.key.host_tile_id) < PropertiesRank(chain.properties_tile, chain.key.host_tile_id)) {
+        chain.properties.swap(fragment.properties);
+        chain.properties_tile = fragment.tile_id;
+    }
+}
+
+void SegmentStitcher::Merge(Fragment& fragment, std::vector<size_t>& touched) {
+    const SegmentKey key{fragment.host_tile_id, fragment.local_id};
+    const WorldPoint& first = fragment.points.front();
+    const WorldPoint& last = fragment.points.back();
+
+    // 已经写出的 segment：首尾相同的副本丢弃，其余（不相连的片段）作为新的折线
+    const auto emitted = emitted_.find(key);
+    if (emitted != emitted_.end()) {
+        const WorldPoint& a = emitted->second.first;
+        const WorldPoint& b = emitted->second.second;
+        if ((Near(a, first) && Near(b, last)) || (Near(a, last) && Near(b, first))) {
+            ++duplicates_;
+            return;
+        }
+    }
+
+    // 首尾都与已有折线重合：重复副本，只取更合适的 properties
+    const auto same = Find(starts_, key, first, true);
+    if (same != starts_.end() && Near(chains_.at(same->second).points.back(), last)) {
+        ++duplicates_;
+        TakeProperties(chains_.at(same->second), fragment);
+        return;
+    }
+
+    const auto before = Find(ends_, key, first, false);   // 终点接在片段起点上的折线
+    const auto after = Find(starts_, key, last, true);    // 起点接在片段终点上的折线
+    const size_t a = before != ends_.end() ? before->second : SIZE_MAX;
+    const size_t b = after != starts_.end() ? after->second : SIZE_MAX;
+
+    if (a == SIZE_MAX && b == SIZE_MAX) {
+        const size_t id = next_chain_++;
+        Chain& chain = chains_[id];
+        chain.key = key;
+        chain.world_bits = fragment.world_bits;
+        chain.points.swap(fragment.points);
+        TakeProperties(chain, fragment);
+        Index(id);
+        touched.push_back(id);
+        return;
+    }
+
+    if (a != SIZE_MAX) {
+        // 接在 a 之后（片段起点与 a 的终点重合，不重复输出）
+        Chain& chain = chains_.at(a);
+        Unindex(a);
+        chain.points.insert(chain.points.end(), fragment.points.begin() + 1, fragment.points.end());
+        TakeProperties(chain, fragment);
+        if (b != SIZE_MAX && b != a) {
+            Chain& next = chains_.at(b);
+            Unindex(b);
+            chain.points.insert(chain.points.end(), next.points.begin() + 1, next.points.end());
+            std::pair<bool, uint64_t> rank = PropertiesRank(next.properties_tile, key.host_tile_id);
+            if (rank < PropertiesRank(chain.properties_tile, key.host_tile_id)) {
+                chain.properties.swap(next.properties);
+                chain.properties_tile = next.properties_tile;
+            }
+            chains_.erase(b);
+        }
+        Index(a);
+        touched.push_back(a);
+        return;
+    }
+
+    // 接在 b 之前
+    Chain& chain = chains_.at(b);
+    Unindex(b);
+    fragment.points.insert(fragment.points.end(), chain.points.begin() + 1, chain.points.end());
+    chain.points.swap(fragment.points);
+    TakeProperties(chain, fragment);
+    Index(b);
+    touched.push_back(b);
+}
+
+SegmentStitcher::EndpointIndex::const_iterator SegmentStitcher::Find(
+    const EndpointIndex& index, const SegmentKey& key, const WorldPoint& p, bool at_start) const
+{
+    // 容差内的点可能落在相邻的量化格中，检查周围 3x3 格
+    const int64_t qx = p.x >> kSnapBits;
+    const int64_t qy = p.y >> kSnapBits;
+    for (int64_t dy = -1; dy <= 1; ++dy) {
+        for (int64_t dx = -1; dx <= 1; ++dx) {
+            const auto it = index.find(EndpointKey{key, qx + dx, qy + dy});
+            if (it == index.end()) continue;
+            const Chain& chain = chains_.at(it->second);
+            if (Near(at_start ? chain.points.front() : chain.points.back(), p)) return it;
+        }
+    }
+    return index.end();
+}
+
+void SegmentStitcher::Index(size_t id) {
+    const Chain& chain = chains_.at(id);
+    const WorldPoint& first = chain.points.front();
+    const WorldPoint& last = chain.points.back();
+    starts_[EndpointKey{chain.key, first.x >> kSnapBits, first.y >> kSnapBits}] = id;
+    ends_[EndpointKey{chain.key, last.x >> kSnapBits, last.y >> kSnapBits}] = id;
+}
+
+void SegmentStitcher::Unindex(size_t id) {
+    const Chain& chain = chains_.at(id);
+    const WorldPoint& first = chain.points.front();
+    const WorldPoint& last = chain.points.back();
+    const auto start = starts_.find(EndpointKey{chain.key, first.x >> kSnapBits, first.y >> kSnapBits});
+    if (start != starts_.end() && start->second == id) starts_.erase(start);
+    const auto end = ends_.find(EndpointKey{chain.key, last.x >> kSnapBits, last.y >> kSnapBits});
+    if (end != ends_.end() && end->second == id) ends_.erase(end);
+}
+
+uint64_t SegmentStitcher::TileIdAt(int64_t column, int64_t row) const {
+    const int64_t limit = int64_t{1} << level_;
+    if (column < 0 || row < 0 || column >= limit || row >= limit) return 0;
+    return TileIDConverter::XYtoTileId(static_cast<uint32_t>(column), static_cast<uint32_t>(row), level_);
+}
+
+void SegmentStitcher::Blockers(const Chain& chain, std::vector<uint64_t>& blockers) const {
+    blockers.clear();
+    if (pending_.empty()) return;
+
+    // 端点在瓦片边界附近（kSnapUnits 以内）时，相邻瓦片中可能还有这条 segment 的片段
+    const int shift = static_cast<int>(chain.world_bits) - static_cast<int>(level_);
+    const int64_t size = int64_t{1} << shift;
+    auto around = [&](int64_t v, int64_t* cells) {
+        const int64_t cell = v >> shift;
+        const int64_t offset = v & (size - 1);
+        int n = 0;
+        cells[n++] = cell;
+        if (offset <= kSnapUnits) cells[n++] = cell - 1;
+        if (size - offset <= kSnapUnits) cells[n++] = cell + 1;
+        return n;
+    };
+    for (const WorldPoint* p : {&chain.points.front(), &chain.points.back()}) {
+        int64_t columns[3];
+        int64_t rows[3];
+        const int nc = around(p->x, columns);
+        const int nr = around(p->y, rows);
+        for (int i = 0; i < nc; ++i) {
+            for (int j = 0; j < nr; ++j) {
+                const uint64_t id = TileIdAt(columns[i], rows[j]);
+                if (id != 0 && pending_.count(id)) blockers.push_back(id);
+            }
+        }
+    }
+    // host 瓦片尚未处理时等待它的片段（带 attributes）
+    if (pending_.count(chain.key.host_tile_id)) blockers.push_back(chain.key.host_tile_id);
+
+    std::sort(blockers.begin(), blockers.end());
+    blockers.erase(std::unique(blockers.begin(), blockers.end()), blockers.end());
+}
+
+void SegmentStitcher::Write(const Chain& chain, FeatureCollectionWriter& out) {
+    JsonWriter& w = out.BeginFeature();
+    w.BeginObject();
+    w.Key("geometry");
+    WriteGeometry(w, chain);
+    w.Key("properties");
+    w.RawValue(chain.properties);
+    w.Field("type", "Feature");
+    w.EndObject();
+    out.EndFeature();
+
+    emitted_[chain.key] = std::make_pair(chain.points.front(), chain.points.back());
+    ++features_written_;
+}
+
+void SegmentStitcher::WriteGeometry(JsonWriter& w, const Chain& chain) {
+    if (encoding_ != utils::GeometryEncoding::kGeoJson) {
+        auto encoder = encoders_.find(chain.world_bits);
+        if (encoder == encoders_.end()) {
+            encoder = encoders_.emplace(chain.world_bits, utils::PolylineEncoder(encoding_, chain.world_bits, precision_)).first;
+        }
+        encoder->second.Clear();
+        for (const auto& p : chain.points) {
+            encoder->second.Add(static_cast<uint64_t>(p.x), static_cast<uint64_t>(p.y));
+        }
+        encoder->second.WriteGeometry(w);
+        return;
+    }
+
+    // 与 TileClipper::ToGeometry 相同的换算，precision >= 0 时与 CoordinateDecoder::DecodeFixed 的整数舍入一致
+    const int bits = static_cast<int>(chain.world_bits);
+    const int64_t lng0 = precision_ >= 0 ? 180 * static_cast<int64_t>(utils::Pow10(precision_)) : 0;
+    const int64_t lat0 = precision_ >= 0 ? 90 * static_cast<int64_t>(utils::Pow10(precision_)) : 0;
+    w.BeginObject();
+    w.Key("coordinates");
+    w.BeginArray();
+    for (const auto& p : chain.points) {
+        w.BeginArray();
+        if (precision_ >= 0) {
+            w.Fixed(utils::WorldToFixed(static_cast<uint64_t>(std::max<int64_t>(p.x, 0)), chain.world_bits, precision_) - lng0, precision_);
+            w.Fixed(utils::WorldToFixed(static_cast<uint64_t>(std::max<int64_t>(p.y, 0)), chain.world_bits, precision_) - lat0, precision_);
+        } else {
+            w.Double(std::ldexp(static_cast<double>(p.x) * 360.0, -bits) - 180.0);
+            w.Double(std::ldexp(static_cast<double>(p.y) * 360.0, -bits) - 90.0);
+        }
+        w.EndArray();
+    }
+    w.EndArray();
+    w.Field("type", "LineString");
+    w.EndObject();
+}
+
+} // namespace converter
@@ -0,0 +1,298 @@
+// SpatialClip.cpp
+#include "SpatialClip.hpp"
+#include "CoordinateDecoder.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace utils {
+
+using json = nlohmann::json;
+
+namespace {
+
+constexpr int kLeft = 1;
+constexpr int kRight = 2;
+constexpr int kBottom = 4;
+constexpr int kTop = 8;
+
+// 经纬度 -> 世界坐标（不取整），与 LNG = I * 360 / 2^bits - 180 互逆
+double LngToWorld(double lng, uint32_t world_bits) {
+    return std::ldexp((lng + 180.0) / 360.0, static_cast<int>(world_bits));
+}
+
+double LatToWorld(double lat, uint32_t world_bits) {
+    return std::ldexp((lat + 90.0) / 360.0, static_cast<int>(world_bits));
+}
+
+WorldPoint Lerp(const WorldPoint& p, const WorldPoint& q, double t) {
+    if (t <= 0.0) return p;
+    if (t >= 1.0) return q;
+    return {p.x + std::llround(t * static_cast<double>(q.x - p.x)),
+            p.y + std::llround(t * static_cast<double>(q.y - p.y))};
+}
+
+// Liang–Barsky 的单边更新：p * t <= q
+bool ClipTest(double p, double q, double& t0, double& t1) {
+    if (p == 0.0) return q >= 0.0;
+    const double r = q / p;
+    if (p < 0.0) {
+        if (r > t1) return false;
+        if (r > t0) t0 = r;
+    } else {
+        if (r < t0) return false;
+        if (r < t1) t1 = r;
+    }
+    return true;
+}
+
+} // namespace
+
+ClipMode ParseClipMode(const std::string& name) {
+    if (name.empty() || name == "none") return ClipMode::kNone;
+    if (name == "drop") return ClipMode::kDrop;
+    if (name == "cut") return ClipMode::kCut;
+    throw std::invalid_argument("Unknown clip mode: " + name);
+}
+
+ClipArea ClipArea::FromBBox(double min_lng, double min_lat, double max_lng, double max_lat) {
+    ClipArea area;
+    area.min_lng_ = std::min(min_lng, max_lng);
+    area.max_lng_ = std::max(min_lng, max_lng);
+    area.min_lat_ = std::min(min_lat, max_lat);
+    area.max_lat_ = std::max(min_lat, max_lat);
+    return area;
+}
+
+ClipArea ClipArea::FromPolygon(const std::vector<double>& lng_lat) {
+    if (lng_lat.size() < 6) {
+        throw std::invalid_argument("Polygon needs at least 3 points");
+    }
+    ClipArea area;
+    for (size_t i = 0; i + 1 < lng_lat.size(); i += 2) {
+        area.ring_.emplace_back(lng_lat[i], lng_lat[i + 1]);
+    }
+    // 首尾重复的闭合点去掉
+    if (area.ring_.size() > 3 && area.ring_.front() == area.ring_.back()) {
+        area.ring_.pop_back();
+    }
+
+    area.min_lng_ = area.max_lng_ = area.ring_.front().first;
+    area.min_lat_ = area.max_lat_ = area.ring_.front().second;
+    for (const auto& v : area.ring_) {
+        area.min_lng_ = std::min(area.min_lng_, v.first);
+        area.max_lng_ = std::max(area.max_lng_, v.first);
+        area.min_lat_ = std::min(area.min_lat_, v.second);
+        area.max_lat_ = std::max(area.max_lat_, v.second);
+    }
+    return area;
+}
+
+TileClipper::TileClipper(const ClipArea* area, ClipMode mode, const olp::geo::TileKey& tile_key, uint32_t world_bits)
+    : mode_(area ? mode : ClipMode::kNone),
+      world_bits_(world_bits)
+{
+    if (!active()) return;
+
+    const uint32_t shift = world_bits - tile_key.Level();
+    origin_x_ = static_cast<int64_t>(tile_key.Column()) << shift;
+    origin_y_ = static_cast<int64_t>(tile_key.Row()) << shift;
+
+    min_x_ = static_cast<int64_t>(std::floor(LngToWorld(area->min_lng(), world_bits)));
+    max_x_ = static_cast<int64_t>(std::ceil(LngToWorld(area->max_lng(), world_bits)));
+    min_y_ = static_cast<int64_t>(std::floor(LatToWorld(area->min_lat(), world_bits)));
+    max_y_ = static_cast<int64_t>(std::ceil(LatToWorld(area->max_lat(), world_bits)));
+
+    polygon_.reserve(area->ring().size());
+    for (const auto& v : area->ring()) {
+        polygon_.emplace_back(LngToWorld(v.first, world_bits), LatToWorld(v.second, world_bits));
+    }
+}
+
+int TileClipper::OutCode(const WorldPoint& p) const {
+    int code = 0;
+    if (p.x < min_x_) code |= kLeft;
+    else if (p.x > max_x_) code |= kRight;
+    if (p.y < min_y_) code |= kBottom;
+    else if (p.y > max_y_) code |= kTop;
+    return code;
+}
+
+bool TileClipper::RectContains(const WorldPoint& p) const {
+    return OutCode(p) == 0;
+}
+
+bool TileClipper::PolygonContains(double x, double y) const {
+    bool inside = false;
+    const size_t n = polygon_.size();
+    for (size_t i = 0, j = n - 1; i < n; j = i++) {
+        const double xi = polygon_[i].first, yi = polygon_[i].second;
+        const double xj = polygon_[j].first, yj = polygon_[j].second;
+        if ((yi > y) != (yj > y) && x < (xj - xi) * (y - yi) / (yj - yi) + xi) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+void TileClipper::SegmentIntervals(const WorldPoint& p, const WorldPoint& q, std::vector<Interval>& out) const {
+    // 外接矩形：Cohen–Sutherland 区域码
+    const int cp = OutCode(p);
+    const int cq = OutCode(q);
+    if (cp & cq) return;                       // 两端在矩形同一侧之外
+
+    double t0 = 0.0;
+    double t1 = 1.0;
+    if (cp | cq) {
+        const double dx = static_cast<double>(q.x - p.x);
+        const double dy = static_cast<double>(q.y - p.y);
+        if (!ClipTest(-dx, static_cast<double>(p.x - min_x_), t0, t1) ||
+            !ClipTest(dx, static_cast<double>(max_x_ - p.x), t0, t1) ||
+            !ClipTest(-dy, static_cast<double>(p.y - min_y_), t0, t1) ||
+            !ClipTest(dy, static_cast<double>(max_y_ - p.y), t0, t1)) {
+            return;
+        }
+    }
+
+    if (polygon_.empty()) {
+        out.emplace_back(t0, t1);
+        return;
+    }
+
+    // 多边形：收集与各边的交点参数，按相邻交点之间的中点判断内外
+    const double px = static_cast<double>(p.x), py = static_cast<double>(p.y);
+    const double dx = static_cast<double>(q.x - p.x), dy = static_cast<double>(q.y - p.y);
+    std::vector<double> ts = {t0, t1};
+    const size_t n = polygon_.size();
+    for (size_t i = 0, j = n - 1; i < n; j = i++) {
+        const double ax = polygon_[j].first, ay = polygon_[j].second;
+        const double ex = polygon_[i].first - ax, ey = polygon_[i].second - ay;
+        const double denom = dx * ey - dy * ex;
+        if (denom == 0.0) continue;            // 平行
+        const double t = ((ax - px) * ey - (ay - py) * ex) / denom;
+        const double u = ((ax - px) * dy - (ay - py) * dx) / denom;
+        if (t > t0 && t < t1 && u >= 0.0 && u <= 1.0) {
+            ts.push_back(t);
+        }
+    }
+    std::sort(ts.begin(), ts.end());
+
+    for (size_t k = 0; k + 1 < ts.size(); ++k) {
+        if (ts[k + 1] <= ts[k]) continue;
+        const double mid = (ts[k] + ts[k + 1]) / 2;
+        if (!PolygonContains(px + mid * dx, py + mid * dy)) continue;
+        if (!out.empty() && out.back().second == ts[k]) {
+            out.back().second = ts[k + 1];     // 与上一段相连则合并
+        } else {
+            out.emplace_back(ts[k], ts[k + 1]);
+        }
+    }
+}
+
+ClipResult TileClipper::Classify(const std::vector<WorldPoint>& line) const {
+    if (line.empty()) return ClipResult::kOutside;
+
+    if (line.size() == 1) {
+        const WorldPoint& p = line.front();
+        const bool inside = RectContains(p) &&
+            (polygon_.empty() || PolygonContains(static_cast<double>(p.x), static_cast<double>(p.y)));
+        return inside ? ClipResult::kInside : ClipResult::kOutside;
+    }
+
+    // 矩形区域的快速路径：所有点都在矩形内即整体在内
+    if (polygon_.empty()) {
+        bool all_inside = true;
+        for (const auto& p : line) {
+            if (!RectContains(p)) {
+                all_inside = false;
+                break;
+            }
+        }
+        if (all_inside) return ClipResult::kInside;
+    }
+
+    bool any = false;
+    bool all = true;
+    std::vector<Interval> intervals;
+    for (size_t i = 0; i + 1 < line.size(); ++i) {
+        intervals.clear();
+        SegmentIntervals(line[i], line[i + 1], intervals);
+        // 只在角点或沿边界擦过的区间（t1 <= t0）不算相交，否则 Cut() 后没有剩下的片段
+        for (const auto& iv : intervals) {
+            if (iv.second > iv.first) any = true;
+        }
+        if (intervals.size() != 1 || intervals[0].first != 0.0 || intervals[0].second != 1.0) all = false;
+        if (any && !all) return ClipResult::kPartial;
+    }
+    if (!any) return ClipResult::kOutside;
+    return all ? ClipResult::kInside : ClipResult::kPartial;
+}
+
+std::vector<std::vector<WorldPoint>> TileClipper::Cut(const std::vector<WorldPoint>& line) const {
+    std::vector<std::vector<WorldPoint>> pieces;
+    std::vector<Interval> intervals;
+    bool open = false;   // 上一段是否在终点处仍在区域内
+
+    for (size_t i = 0; i + 1 < line.size(); ++i) {
+        intervals.clear();
+        SegmentIntervals(line[i], line[i + 1], intervals);
+        for (const auto& iv : intervals) {
+            if (!(open && iv.first == 0.0)) {
+                pieces.emplace_back();
+                pieces.back().push_back(Lerp(line[i], line[i + 1], iv.first));
+            }
+            pieces.back().push_back(Lerp(line[i], line[i + 1], iv.second));
+            open = (iv.second == 1.0);
+        }
+        if (intervals.empty() || intervals.back().second != 1.0) {
+            open = false;
+        }
+    }
+
+    // 只擦到边界的退化片段（单点或取整后重合）去掉
+    pieces.erase(std::remove_if(pieces.begin(), pieces.end(), [](const std::vector<WorldPoint>& piece) {
+        for (const auto& p : piece) {
+            if (p.x != piece.front().x || p.y != piece.front().y) return false;
+        }
+        return true;
+    }), pieces.end());
+    return pieces;
+}
+
+json TileClipper::ToGeometry(const std::vector<std::vector<WorldPoint>>& pieces, int precision) const {
+    const int bits = static_cast<int>(world_bits_);
+    const uint32_t world_bits = world_bits_;
+    const int64_t lng0 = precision >= 0 ? 180 * static_cast<int64_t>(Pow10(precision)) : 0;
+    const int64_t lat0 = precision >= 0 ? 90 * static_cast<int64_t>(Pow10(precision)) : 0;
+    auto toCoordinates = [=](const std::vector<WorldPoint>& piece) {
+        json coords = json::array();
+        for (const auto& p : piece) {
+            if (precision >= 0) {
+                // 与 CoordinateDecoder::DecodeFixed 相同的整数舍入
+                const int64_t lng = WorldToFixed(static_cast<uint64_t>(std::max<int64_t>(p.x, 0)), world_bits, precision) - lng0;
+                const int64_t lat = WorldToFixed(static_cast<uint64_t>(std::max<int64_t>(p.y, 0)), world_bits, precision) - lat0;
+                coords.push_back({ FixedToDouble(lng, precision), FixedToDouble(lat, precision) });
+                continue;
+            }
+            const double LNG = std::ldexp(static_cast<double>(p.x) * 360.0, -bits) - 180.0;
+            const double LAT = std::ldexp(static_cast<double>(p.y) * 360.0, -bits) - 90.0;
+            coords.push_back({ LNG, LAT });
+        }
+        return coords;
+    };
+
+    json geometry;
+    if (pieces.size() == 1) {
+        geometry["type"] = "LineString";
+        geometry["coordinates"] = toCoordinates(pieces.front());
+    } else {
+        geometry["type"] = "MultiLineString";
+        geometry["coordinates"] = json::array();
+        for (const auto& piece : pieces) {
+            geometry["coordinates"].push_back(toCoordinates(piece));
+        }
+    }
+    return geometry;
+}
+
+} // namespace utils
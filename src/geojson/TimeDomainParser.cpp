@@ -1,9 +1,13 @@
 #include "TimeDomainParser.hpp"
 #include <string>
 #include <vector>
+#include <list>
+#include <mutex>
 #include <unordered_map>
-#include <sstream>
+#include <functional>
+#include <algorithm>
 #include <cctype>
+#include <stdexcept>
 namespace TimeDomainParser {
 
 // ------------------- Tokenizer -------------------
@@ -13,6 +17,7 @@ struct Token {
     TokenType type;
     char op;
     std::string term;
+    std::string duration;   // (…){…} 中花括号内的部分
 };
 
 class Tokenizer {
@@ -21,10 +26,10 @@ public:
 
     Token next() {
         skipSpaces();
-        if (pos >= len) return {TokenType::End, 0, ""};
+        if (pos >= len) return {TokenType::End, 0, "", ""};
 
         char c = str[pos];
-        if (c == '+' || c == '*' || c == '-' || c == '!') { pos++; return {TokenType::Operator, c, ""}; }
+        if (c == '+' || c == '*' || c == '-' || c == '!') { pos++; return {TokenType::Operator, c, "", ""}; }
         if (c == '(') return parseTerm();
         if (std::isalnum((unsigned char)c)) return parsePlainTerm();
 
@@ -32,7 +37,6 @@ public:
         return next();
     }
 
-    Token peek() { int saved = pos; Token t = next(); pos = saved; return t; }
     bool hasMore() { skipSpaces(); return pos < len; }
 
 private:
@@ -42,16 +46,21 @@ private:
         while (pos < len && str[pos] != ')') inner.push_back(str[pos++]);
         if (pos < len && str[pos] == ')') pos++;
         skipSpaces();
-        if (pos < len && str[pos] == '{') { while (pos < len && str[pos] != '}') pos++; if (pos < len) pos++; }
+        std::string duration;
+        if (pos < len && str[pos] == '{') {
+            pos++;
+            while (pos < len && str[pos] != '}') duration.push_back(str[pos++]);
+            if (pos < len) pos++;
+        }
         trim(inner);
         std::string primary = extractPrimary(inner);
-        return {TokenType::Term, 0, primary};
+        return {TokenType::Term, 0, primary, duration};
     }
 
     Token parsePlainTerm() {
         std::string t;
         while (pos < len && (std::isalnum((unsigned char)str[pos]) || str[pos]=='_')) t.push_back(str[pos++]);
-        return {TokenType::Term, 0, t};
+        return {TokenType::Term, 0, t, ""};
     }
 
     void skipSpaces() { while (pos < len && std::isspace((unsigned char)str[pos])) pos++; }
@@ -64,10 +73,11 @@ private:
 };
 
 // ------------------- Token 翻译 -------------------
-static std::unordered_map<std::string, std::string> weekdayMap = {
-    {"d1","Mon"},{"d2","Tue"},{"d3","Wed"},{"d4","Thu"},{"d5","Fri"},{"d6","Sat"},{"d7","Sun"}
+// 与求值（compileSchedule）相同按 GDF 定义：tN 为星期（t1 为周日），dN 为每月第 N 天
+static const std::unordered_map<std::string, std::string> weekdayMap = {
+    {"t1","Sun"},{"t2","Mon"},{"t3","Tue"},{"t4","Wed"},{"t5","Thu"},{"t6","Fri"},{"t7","Sat"}
 };
-static std::unordered_map<std::string, std::string> monthMap = {
+static const std::unordered_map<std::string, std::string> monthMap = {
     {"M1","Jan"},{"M2","Feb"},{"M3","Mar"},{"M4","Apr"},{"M5","May"},{"M6","Jun"},
     {"M7","Jul"},{"M8","Aug"},{"M9","Sep"},{"M10","Oct"},{"M11","Nov"},{"M12","Dec"}
 };
@@ -77,46 +87,403 @@ static std::string translateToken(const std::string& tk) {
     auto itw = weekdayMap.find(tk); if(itw!=weekdayMap.end()) return itw->second;
     auto itm = monthMap.find(tk); if(itm!=monthMap.end()) return itm->second;
     if(tk[0]=='h') return tk.substr(1)+":00";
-    if(tk[0]=='t') return "day "+tk.substr(1);
+    if(tk[0]=='d') return "day "+tk.substr(1);
     if(tk[0]=='w') return "every "+tk.substr(1)+" weeks";
     if(tk[0]=='z') return tk=="z1"?"Sunrise to Sunset":"Sunset to Sunrise";
     if(tk[0]=='-') return "EXCEPT "+tk.substr(1);
     return tk;
 }
 
+// "M5d1h8" -> {M,5} {d,1} {h,8}；字母之外的字符被跳过
+static std::vector<TimeField> parseFields(const std::string& s) {
+    std::vector<TimeField> fields;
+    size_t i = 0;
+    while (i < s.size()) {
+        const char unit = s[i++];
+        if (!std::isalpha((unsigned char)unit)) continue;
+        int value = -1;
+        while (i < s.size() && std::isdigit((unsigned char)s[i])) {
+            value = (value < 0 ? 0 : value * 10) + (s[i++] - '0');
+        }
+        fields.push_back({unit, value});
+    }
+    return fields;
+}
+
+// ------------------- 编译为集合/区间 -------------------
+// 起始时间单位由大到小的序号：y, M, 日级 (w/d/t), h, m, s
+static int unitRank(char unit) {
+    switch(unit){
+        case 'y': return 0;
+        case 'M': return 1;
+        case 'w': case 'd': case 't': return 2;
+        case 'h': return 3;
+        case 'm': return 4;
+        case 's': return 5;
+        default:  return -1;
+    }
+}
+
+static uint64_t bitRange(int lo, int hi) {
+    uint64_t bits = 0;
+    for (int i = lo; i <= hi; ++i) bits |= uint64_t{1} << i;
+    return bits;
+}
+
+static Schedule compileSchedule(const std::vector<TimeField>& start, const std::vector<TimeField>& duration) {
+    Schedule sc;
+    if (start.empty()) return sc;
+    int smallest = -1;
+    for (const auto& f : start) {
+        const int rank = unitRank(f.unit);
+        if (rank < 0 || f.value < 0) return sc;
+        const int v = f.value;
+        switch(f.unit){
+            case 'y': sc.year = v; break;
+            case 'M': if (v < 1 || v > 12) return sc; sc.months |= 1u << (v - 1); break;
+            case 'w': if (v < 1 || v > 5) return sc; sc.weeks |= 1u << (v - 1); break;
+            case 'd': if (v < 1 || v > 31) return sc; sc.days |= 1u << (v - 1); break;
+            case 't': if (v < 1 || v > 7) return sc; sc.weekdays |= 1u << (v - 1); break;
+            case 'h': if (v > 23) return sc; sc.hours |= 1u << v; break;
+            case 'm': if (v > 59) return sc; sc.minutes |= uint64_t{1} << v; break;
+            case 's': if (v > 59) return sc; sc.seconds |= uint64_t{1} << v; break;
+        }
+        if (rank > smallest) smallest = rank;
+    }
+    // 未给出的字段：比最小给出单位大的取全部值，小的取最小值
+    if (!sc.months) sc.months = smallest > 1 ? 0xFFF : 0x1;
+    if (!sc.days && !sc.weekdays && !sc.weeks && smallest < 2) sc.days = 0x1;
+    if (!sc.days) sc.days = 0x7FFFFFFF;
+    if (!sc.weekdays) sc.weekdays = 0x7F;
+    if (!sc.weeks) sc.weeks = 0x1F;
+    if (!sc.hours) sc.hours = smallest > 3 ? 0xFFFFFF : 0x1;
+    if (!sc.minutes) sc.minutes = smallest > 4 ? bitRange(0, 59) : 0x1;
+    if (!sc.seconds) sc.seconds = 0x1;
+
+    for (const auto& f : duration) {
+        if (f.value < 0) return sc;
+        switch(f.unit){
+            case 'y': sc.duration_months += 12 * f.value; break;
+            case 'M': sc.duration_months += f.value; break;
+            case 'w': sc.duration_seconds += 604800LL * f.value; break;
+            case 'd': sc.duration_seconds += 86400LL * f.value; break;
+            case 'h': sc.duration_seconds += 3600LL * f.value; break;
+            case 'm': sc.duration_seconds += 60LL * f.value; break;
+            case 's': sc.duration_seconds += f.value; break;
+            default: return sc;
+        }
+    }
+    if (duration.empty()) {
+        static const int kUnitMonths[] = {12, 1, 0, 0, 0, 0};
+        static const int kUnitSeconds[] = {0, 0, 86400, 3600, 60, 1};
+        sc.duration_months = kUnitMonths[smallest];
+        sc.duration_seconds = kUnitSeconds[smallest];
+    }
+    sc.evaluable = true;
+    return sc;
+}
+
 // ------------------- 解析 -------------------
-std::string parseExpr(Tokenizer &tz);
+// 可读形式为空串的节点：表达式结束或空时间项，n 元运算的贪婪匹配以及顶层循环在此处停止
+static bool isEmpty(const Node& n) {
+    return n.kind == Node::Kind::Empty || (n.kind == Node::Kind::Term && n.term.empty());
+}
 
-static std::string joinWith(const std::vector<std::string>& parts, const std::string& sep) {
-    std::ostringstream oss; for(size_t i=0;i<parts.size();++i){ if(i)oss<<sep; oss<<parts[i]; } return oss.str();
+static Node parseExpr(Tokenizer &tz);
+
+static Node parseNary(Tokenizer &tz, Node::Kind kind) {
+    Node n; n.kind = kind;
+    n.children.push_back(parseExpr(tz)); n.children.push_back(parseExpr(tz));
+    while(tz.hasMore()){ Node p=parseExpr(tz); if(isEmpty(p)) break; n.children.push_back(std::move(p)); }
+    return n;
 }
 
-std::string parseTerm(Tokenizer &tz, const Token &t) { return translateToken(t.term); }
+static Node parseExpr(Tokenizer &tz) {
+    Token t = tz.next();
+    Node n;
+    if(t.type==TokenType::End) return n;
+    if(t.type==TokenType::Term){
+        n.kind = Node::Kind::Term;
+        n.start = parseFields(t.term);
+        n.duration = parseFields(t.duration);
+        n.schedule = compileSchedule(n.start, n.duration);
+        n.term = std::move(t.term);
+        return n;
+    }
+    switch(t.op){
+        case '!': n.kind = Node::Kind::Not; n.children.push_back(parseExpr(tz)); return n;
+        case '-': n.kind = Node::Kind::Range; n.children.push_back(parseExpr(tz)); n.children.push_back(parseExpr(tz)); return n;
+        case '*': return parseNary(tz, Node::Kind::And);
+        default:  return parseNary(tz, Node::Kind::Or);
+    }
+}
 
-std::string parseExpr(Tokenizer &tz) {
-    Token t = tz.next(); if(t.type==TokenType::End) return "";
-    if(t.type==TokenType::Term) return parseTerm(tz,t);
-    if(t.type==TokenType::Operator){
-        char op=t.op;
-        if(op=='!') return "NOT("+parseExpr(tz)+")";
-        else if(op=='-') return "From "+parseExpr(tz)+" To "+parseExpr(tz);
-        else if(op=='*'){ std::vector<std::string> parts; parts.push_back(parseExpr(tz)); parts.push_back(parseExpr(tz));
-            while(tz.hasMore()){ std::string p=parseExpr(tz); if(p.empty()) break; parts.push_back(p); } return "("+joinWith(parts," AND ")+")"; }
-        else if(op=='+'){ std::vector<std::string> parts; parts.push_back(parseExpr(tz)); parts.push_back(parseExpr(tz));
-            while(tz.hasMore()){ std::string p=parseExpr(tz); if(p.empty()) break; parts.push_back(p); } return "("+joinWith(parts," OR ")+")"; }
-        else return std::string("<op ")+op+">";
+static void appendReadable(const Node& n, std::string& out);
+
+static void appendJoined(const std::vector<Node>& parts, const char* sep, std::string& out) {
+    for(size_t i=0;i<parts.size();++i){ if(i) out+=sep; appendReadable(parts[i], out); }
+}
+
+static void appendReadable(const Node& n, std::string& out) {
+    switch(n.kind){
+        case Node::Kind::Empty: return;
+        case Node::Kind::Term:  out += translateToken(n.term); return;
+        case Node::Kind::Not:   out += "NOT("; appendReadable(n.children[0], out); out += ")"; return;
+        case Node::Kind::Range:
+            // 与求值相同按 GDF 的减运算：A 中去掉 B
+            appendReadable(n.children[0], out);
+            out += " excluding "; appendReadable(n.children[1], out); return;
+        case Node::Kind::And:   out += "("; appendJoined(n.children, " AND ", out); out += ")"; return;
+        case Node::Kind::Or:    out += "("; appendJoined(n.children, " OR ", out); out += ")"; return;
+    }
+}
+
+Expression Expression::Compile(const std::string& expr) {
+    Expression e;
+    Tokenizer tz(expr);
+    while(tz.hasMore()){ Node p=parseExpr(tz); if(isEmpty(p)) break; e.roots_.push_back(std::move(p)); }
+    appendJoined(e.roots_, "; ", e.readable_);
+    return e;
+}
+
+// ------------------- 求值 -------------------
+namespace {
+
+constexpr int kMaxLookbackDays = 8 * 366;   // 覆盖 2 月 29 日这类四年一次的起始时间
+
+// 1970-01-01 起的天数（公历）
+int64_t daysFromCivil(int y, int m, int d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const int yoe = static_cast<int>(y - era * 400);
+    const int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+void civilFromDays(int64_t z, int& y, int& m, int& d) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const int doe = static_cast<int>(z - era * 146097);
+    const int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = static_cast<int>(yoe + era * 400) + (m <= 2);
+}
+
+int daysInMonth(int y, int m) {
+    static const int kDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    const bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+    return m == 2 && leap ? 29 : kDays[m - 1];
+}
+
+// mask 中不大于 limit 的最高位，没有时返回 -1
+int highestAtMost(uint64_t mask, int limit) {
+    for (int i = limit; i >= 0; --i) {
+        if ((mask >> i) & 1) return i;
     }
-    return "<unknown>";
+    return -1;
+}
+
+// 一天内不晚于 limit（秒）的最后一个起始时刻，没有时返回 -1
+int latestTimeOfDay(const Schedule& sc, int limit) {
+    const int lh = limit / 3600, lm = limit / 60 % 60, ls = limit % 60;
+    for (int h = highestAtMost(sc.hours, lh); h >= 0; h = highestAtMost(sc.hours, h - 1)) {
+        for (int m = highestAtMost(sc.minutes, h == lh ? lm : 59); m >= 0; m = highestAtMost(sc.minutes, m - 1)) {
+            const int s = highestAtMost(sc.seconds, h == lh && m == lm ? ls : 59);
+            if (s >= 0) return h * 3600 + m * 60 + s;
+        }
+    }
+    return -1;
+}
+
+// 不晚于 t 的最后一个起始时刻所在的区间是否包含 t：起始时刻越晚，区间结束也越晚
+bool scheduleContains(const Schedule& sc, int64_t tDays, int tSeconds) {
+    for (int back = 0; back <= kMaxLookbackDays; ++back) {
+        const int64_t day = tDays - back;
+        int y, m, d;
+        civilFromDays(day, y, m, d);
+        if (sc.year >= 0 && y != sc.year) {
+            if (y < sc.year) return false;
+            continue;
+        }
+        const int weekday = static_cast<int>(((day + 4) % 7 + 7) % 7);   // 0 为周日
+        if (!((sc.months >> (m - 1)) & 1) || !((sc.days >> (d - 1)) & 1) ||
+            !((sc.weekdays >> weekday) & 1) || !((sc.weeks >> ((d - 1) / 7)) & 1)) {
+            continue;
+        }
+        const int tod = latestTimeOfDay(sc, back == 0 ? tSeconds : 86399);
+        if (tod < 0) continue;
+
+        int64_t endDay = day;
+        if (sc.duration_months) {
+            const int months = y * 12 + (m - 1) + sc.duration_months;
+            const int ey = months / 12, em = months % 12 + 1;
+            endDay = daysFromCivil(ey, em, std::min(d, daysInMonth(ey, em)));
+        }
+        const int64_t end = endDay * 86400 + tod + sc.duration_seconds;
+        return tDays * 86400 + tSeconds < end;
+    }
+    return false;
+}
+
+enum class Truth { False, True, Unknown };
+
+Truth evaluate(const Node& n, int64_t tDays, int tSeconds) {
+    switch(n.kind){
+        case Node::Kind::Empty: return Truth::Unknown;
+        case Node::Kind::Term:
+            if (!n.schedule.evaluable) return Truth::Unknown;
+            return scheduleContains(n.schedule, tDays, tSeconds) ? Truth::True : Truth::False;
+        case Node::Kind::Not: {
+            const Truth a = evaluate(n.children[0], tDays, tSeconds);
+            return a == Truth::Unknown ? a : (a == Truth::True ? Truth::False : Truth::True);
+        }
+        case Node::Kind::Range: {
+            // GDF 的减运算：A 中去掉 B
+            const Truth a = evaluate(n.children[0], tDays, tSeconds);
+            if (a == Truth::False) return a;
+            const Truth b = evaluate(n.children[1], tDays, tSeconds);
+            if (b == Truth::True) return Truth::False;
+            return a == Truth::True && b == Truth::False ? Truth::True : Truth::Unknown;
+        }
+        case Node::Kind::And:
+        case Node::Kind::Or: {
+            const Truth decisive = n.kind == Node::Kind::And ? Truth::False : Truth::True;
+            Truth result = n.kind == Node::Kind::And ? Truth::True : Truth::False;
+            for (const auto& c : n.children) {
+                const Truth v = evaluate(c, tDays, tSeconds);
+                if (v == decisive) return v;
+                if (v == Truth::Unknown) result = v;
+            }
+            return result;
+        }
+    }
+    return Truth::Unknown;
+}
+
+} // namespace
+
+bool Expression::AppliesAt(const LocalTime& t) const {
+    const int64_t tDays = daysFromCivil(t.year, t.month, t.day);
+    const int tSeconds = t.hour * 3600 + t.minute * 60 + t.second;
+    Truth result = roots_.empty() ? Truth::Unknown : Truth::False;
+    for (const auto& root : roots_) {
+        const Truth v = evaluate(root, tDays, tSeconds);
+        if (v == Truth::True) return true;
+        if (v == Truth::Unknown) result = v;
+    }
+    return result != Truth::False;
+}
+
+LocalTime ParseTimestamp(const std::string& iso) {
+    LocalTime t;
+    size_t pos = 0;
+    auto number = [&](size_t digits, int lo, int hi) {
+        int v = 0;
+        for (size_t i = 0; i < digits; ++i, ++pos) {
+            if (pos >= iso.size() || !std::isdigit((unsigned char)iso[pos])) {
+                throw std::invalid_argument("valid_at expects an ISO 8601 timestamp (YYYY-MM-DD[THH:MM[:SS]]): " + iso);
+            }
+            v = v * 10 + (iso[pos] - '0');
+        }
+        if (v < lo || v > hi) throw std::invalid_argument("valid_at timestamp out of range: " + iso);
+        return v;
+    };
+    auto expect = [&](char c) {
+        if (pos >= iso.size() || iso[pos] != c) {
+            throw std::invalid_argument("valid_at expects an ISO 8601 timestamp (YYYY-MM-DD[THH:MM[:SS]]): " + iso);
+        }
+        ++pos;
+    };
+
+    t.year = number(4, 0, 9999); expect('-');
+    t.month = number(2, 1, 12); expect('-');
+    t.day = number(2, 1, daysInMonth(t.year, t.month));
+    if (pos < iso.size() && (iso[pos] == 'T' || iso[pos] == ' ')) {
+        ++pos;
+        t.hour = number(2, 0, 23); expect(':');
+        t.minute = number(2, 0, 59);
+        if (pos < iso.size() && iso[pos] == ':') { ++pos; t.second = number(2, 0, 59); }
+        // 小数秒与时区后缀 (Z / +hh:mm) 不影响本地时间求值
+        if (pos < iso.size() && iso[pos] == '.') { ++pos; while (pos < iso.size() && std::isdigit((unsigned char)iso[pos])) ++pos; }
+        if (pos < iso.size() && (iso[pos] == 'Z' || iso[pos] == '+' || iso[pos] == '-')) pos = iso.size();
+    }
+    if (pos != iso.size()) {
+        throw std::invalid_argument("valid_at expects an ISO 8601 timestamp (YYYY-MM-DD[THH:MM[:SS]]): " + iso);
+    }
+    return t;
+}
+
+// ------------------- 缓存 -------------------
+namespace {
+
+constexpr size_t kCacheShards = 16;
+
+// 单个分片：最近使用的在链表头部
+class CacheShard {
+public:
+    std::shared_ptr<const Expression> Find(const std::string& expr) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(expr);
+        if (it == index_.end()) return nullptr;
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return it->second->second;
+    }
+
+    std::shared_ptr<const Expression> Insert(const std::string& expr, std::shared_ptr<const Expression> compiled) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(expr);
+        if (it != index_.end()) return it->second->second;   // 其他线程已写入
+        lru_.emplace_front(expr, std::move(compiled));
+        index_.emplace(expr, lru_.begin());
+        if (lru_.size() > kCacheCapacity / kCacheShards) {
+            index_.erase(lru_.back().first);
+            lru_.pop_back();
+        }
+        return lru_.front().second;
+    }
+
+private:
+    using Entry = std::pair<std::string, std::shared_ptr<const Expression>>;
+    std::mutex mutex_;
+    std::list<Entry> lru_;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+};
+
+CacheShard& ShardFor(const std::string& expr) {
+    static CacheShard shards[kCacheShards];
+    return shards[std::hash<std::string>()(expr) % kCacheShards];
+}
+
+} // namespace
+
+std::shared_ptr<const Expression> CompileCached(const std::string& expr) {
+    CacheShard& shard = ShardFor(expr);
+    if (auto hit = shard.Find(expr)) return hit;
+    // 在锁外解析，避免长表达式阻塞同一分片上的其他查询
+    return shard.Insert(expr, std::make_shared<const Expression>(Expression::Compile(expr)));
 }
 
 // ------------------- API -------------------
 std::string TimeDomainToReadable(const std::string &expr) {
-    Tokenizer tz(expr); std::vector<std::string> parts;
-    while(tz.hasMore()){ std::string p=parseExpr(tz); if(!p.empty()) parts.push_back(p); else break; }
-    if(parts.empty()) return "";
-    if(parts.size()==1) return parts[0];
-    return joinWith(parts,"; ");
+    return CompileCached(expr)->readable();
+}
+
+bool ValidityFilter::Applies(const std::string& expr) const {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = results_.find(expr);
+        if (it != results_.end()) return it->second;
+    }
+    const bool applies = CompileCached(expr)->AppliesAt(time_);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (results_.size() >= kCacheCapacity) results_.clear();
+    results_.emplace(expr, applies);
+    return applies;
 }
 
 
-} // namespace TimeDomainParser
\ No newline at end of file
+} // namespace TimeDomainParser